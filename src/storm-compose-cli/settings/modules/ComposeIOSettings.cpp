@@ -34,34 +34,81 @@ const std::string ComposeIOSettings::bottomUpIntervalName = "bottomUpInterval";
 const std::string ComposeIOSettings::iterationOrderName = "iterationOrder";
 const std::string ComposeIOSettings::localOviEpsilonName = "localOviEpsilon";
 const std::string ComposeIOSettings::useRecursiveParetoComputationName = "useRecursiveParetoComputation";
+const std::string ComposeIOSettings::cviThreadsName = "cviThreads";
+const std::string ComposeIOSettings::cacheContentionBenchmarkName = "cacheContentionBenchmark";
+const std::string ComposeIOSettings::exactParetoCacheName = "exactParetoCache";
+const std::string ComposeIOSettings::lipschitzCacheName = "lipschitzCache";
+const std::string ComposeIOSettings::paretoPrecomputationThresholdName = "paretoPrecomputationThreshold";
+const std::string ComposeIOSettings::buildThreadsName = "buildThreads";
+const std::string ComposeIOSettings::valueVectorBenchmarkName = "valueVectorBenchmark";
+const std::string ComposeIOSettings::leafCacheDirectoryName = "leafCacheDirectory";
+const std::string ComposeIOSettings::invalidateLeafCacheName = "invalidateLeafCache";
+const std::string ComposeIOSettings::exportMonolithicMdpName = "exportMonolithicMdp";
+const std::string ComposeIOSettings::explorationPrecisionName = "explorationPrecision";
+const std::string ComposeIOSettings::explorationStateLimitName = "explorationStateLimit";
+const std::string ComposeIOSettings::explorationSamplesName = "explorationSamples";
+const std::string ComposeIOSettings::subtreeSummarySweepsName = "subtreeSummarySweeps";
+const std::string ComposeIOSettings::disableParetoPruningName = "disableParetoPruning";
+const std::string ComposeIOSettings::paretoBudgetName = "paretoBudget";
+const std::string ComposeIOSettings::exportBinaryStringDiagramName = "exportBinaryStringDiagram";
+const std::string ComposeIOSettings::chromeTraceName = "chromeTrace";
 
 ComposeIOSettings::ComposeIOSettings() : ModuleSettings(moduleName) {
-    addStringOption(stringDiagramOption, "load the given string diagram", "filename", "The path of the file to load (json).");
+    addStringOption(stringDiagramOption, "load the given string diagram", "filename", "The path of the file to load (json or binary).");
     addStringOption(entranceName, "entrance to consider as the initial state of the string diagram", "entrance",
                     "<l|r><number> e.g. l5 is left entrance 5, default: l0");
     addStringOption(exitName, "exit to consider as the target state of the string diagram", "exit", "<l|r><number> e.g. r3 is right exit 3, default: r0");
     addStringOption(approachName, "approach to use for computing reachability in the string diagram", "approach",
-                    "(choose from {monolithic, naive2}, default: monolithic");
+                    "(choose from {monolithic, lazy, naive, cvi}, default: monolithic");
     addStringOption(exportStringDiagramName, "export the string diagram to a dot file", "filename", "The name of the file to write the dot file");
     addStringOption(benchmarkDataName, "write benchmark results", "filename", "The path to store the benchmark results");
     addStringOption(paretoPrecisionTypeName, "multi objective computation precision type", "type", "In: {absolute, relative}");
-    addStringOption(cacheMethodName, "Cache method to use", "method", "In: {no, exact, pareto} (default=pareto)");
-    addStringOption(iterationOrderName, "Iteration order to use", "order", "In: {forward, backward, heuristic} (default=backward)");
+    addStringOption(cacheMethodName, "Cache method to use", "method", "In: {no, exact, pareto, pareto-vertex} (default=pareto)");
+    addStringOption(leafCacheDirectoryName, "keep built leaves and their Pareto bounds in the given directory to reuse them in later runs", "directory",
+                    "The path of the cache directory");
+    addStringOption(exportMonolithicMdpName, "export the monolithic MDP built by the monolithic approach", "filename", "The path of the DRN file to write");
+    addStringOption(exportBinaryStringDiagramName, "convert the JSON string diagram to the binary format, which is loaded by --stringdiagram as well",
+                    "filename", "The path of the binary file to write");
+    addStringOption(chromeTraceName, "write the leaf solves and CVI phases as Chrome trace events (e.g. for chrome://tracing)", "filename",
+                    "The path of the trace file to write");
+    addStringOption(iterationOrderName, "Iteration order to use", "order",
+                    "In: {forward, backward, heuristic, parallel-jacobi, parallel-gauss-seidel, topological, prioritized} (default=backward)");
 
     addDoubleOption(paretoPrecisionName, "the precision with which to perform multiobjective optimisation, see also --paretoPrecisionType", "precision",
                     "the relative or absolution precision");
     addDoubleOption(oviEpsilonName, "epsilon with which to perform optimistic (compositional) value iteration", "epsilon", "");
     addDoubleOption(paretoCacheEpsilonName, "error tolerance for using the cache", "epsilon", "");
     addDoubleOption(localOviEpsilonName, "local OVI epsilon", "epsilon", "");
+    addDoubleOption(explorationPrecisionName, "gap between the bounds at which the lazy approach stops exploring", "precision", "default: 1e-3");
 
     addUnsignedOption(paretoStepsName, "maximum number of steps to perform in the multiobjective optimisation", "steps", "number of steps");
     addUnsignedOption(cviStepsName, "maximum number of steps to perform in CVI", "steps", "number of steps");
     addUnsignedOption(oviIntervalName, "perform OVI termination check every <steps> steps", "steps", "number of steps");
     addUnsignedOption(bottomUpIntervalName, "perform bottom-up termination check every <steps> steps", "steps", "number of steps");
+    addUnsignedOption(cviThreadsName, "number of threads used by the parallel iteration orders", "threads", "number of threads (0 = hardware concurrency)");
+    addUnsignedOption(cacheContentionBenchmarkName, "replay the Pareto cache operations of CVI with 1 up to <threads> threads after the check", "threads",
+                      "maximum number of threads");
+    addUnsignedOption(paretoPrecomputationThresholdName, "precompute the Pareto set of leaves with at most <states> states", "states",
+                      "number of states (0 = disabled)");
+    addUnsignedOption(valueVectorBenchmarkName, "only measure the overhead of a CVI sweep over a synthetic sequence of <leaves> leaves", "leaves",
+                      "number of leaves");
+    addUnsignedOption(explorationStateLimitName, "maximum number of states explored by the lazy approach", "states", "number of states (0 = unlimited)");
+    addUnsignedOption(explorationSamplesName, "number of paths sampled by the lazy approach between two bound computations", "samples",
+                      "number of paths (default: 100)");
+    addUnsignedOption(subtreeSummarySweepsName,
+                      "iterate subtrees whose leaves kept their Pareto bounds for <sweeps> CVI sweeps as a single leaf (bottom-up termination only)",
+                      "sweeps", "number of sweeps (0 = disabled)");
+    addUnsignedOption(paretoBudgetName, "keep at most <points> lower bound points and upper bound halfspaces per entrance in the Pareto cache", "points",
+                      "number of points (0 = unlimited)");
+    addUnsignedOption(buildThreadsName, "number of threads used to build the leaf MDPs", "threads", "number of threads (0 = hardware concurrency, default: 1)");
 
     addFlag(useOviName, "use OVI termination");
     addFlag(useBottomUpName, "use bottom-up termination");
     addFlag(useRecursiveParetoComputationName, "use recursive Pareto computation");
+    addFlag(exactParetoCacheName, "only use exact arithmetic in the Pareto cache (disables the floating point fast path)");
+    addFlag(invalidateLeafCacheName, "remove all entries of the leaf cache directory before checking");
+    addFlag(disableParetoPruningName, "keep dominated points and redundant halfspaces in the Pareto cache");
+    addFlag(lipschitzCacheName, "answer cache queries with bounds derived from the closest previously seen weight (exact and Pareto cache)");
 }
 
 bool ComposeIOSettings::check() const {
@@ -150,6 +197,78 @@ bool ComposeIOSettings::isUseRecursiveParetoComputationSet() const {
     return this->getOption(useRecursiveParetoComputationName).getHasOptionBeenSet();
 }
 
+bool ComposeIOSettings::isCviThreadsSet() const {
+    return this->getOption(cviThreadsName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isExactParetoCacheSet() const {
+    return this->getOption(exactParetoCacheName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isLipschitzCacheSet() const {
+    return this->getOption(lipschitzCacheName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isCacheContentionBenchmarkSet() const {
+    return this->getOption(cacheContentionBenchmarkName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isParetoPrecomputationThresholdSet() const {
+    return this->getOption(paretoPrecomputationThresholdName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isSubtreeSummarySweepsSet() const {
+    return this->getOption(subtreeSummarySweepsName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isDisableParetoPruningSet() const {
+    return this->getOption(disableParetoPruningName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isParetoBudgetSet() const {
+    return this->getOption(paretoBudgetName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isLeafCacheDirectorySet() const {
+    return this->getOption(leafCacheDirectoryName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isInvalidateLeafCacheSet() const {
+    return this->getOption(invalidateLeafCacheName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isExportMonolithicMdpSet() const {
+    return this->getOption(exportMonolithicMdpName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isExplorationPrecisionSet() const {
+    return this->getOption(explorationPrecisionName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isExportBinaryStringDiagramSet() const {
+    return this->getOption(exportBinaryStringDiagramName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isChromeTraceSet() const {
+    return this->getOption(chromeTraceName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isExplorationStateLimitSet() const {
+    return this->getOption(explorationStateLimitName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isExplorationSamplesSet() const {
+    return this->getOption(explorationSamplesName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isValueVectorBenchmarkSet() const {
+    return this->getOption(valueVectorBenchmarkName).getHasOptionBeenSet();
+}
+
+bool ComposeIOSettings::isBuildThreadsSet() const {
+    return this->getOption(buildThreadsName).getHasOptionBeenSet();
+}
+
 std::string ComposeIOSettings::getStringDiagramFilename() const {
     return this->getOption(stringDiagramOption).getArgumentByName("filename").getValueAsString();
 }
@@ -234,6 +353,8 @@ storm::modelchecker::CacheMethod ComposeIOSettings::getCacheMethod() const {
         return modelchecker::EXACT_CACHE;
     } else if (cacheMethodString == "pareto") {
         return modelchecker::PARETO_CACHE;
+    } else if (cacheMethodString == "pareto-vertex") {
+        return modelchecker::PARETO_VERTEX_CACHE;
     } else {
         STORM_LOG_THROW(false, storm::exceptions::InvalidArgumentException, "Unknown cache method: " << cacheMethodString);
     }
@@ -270,6 +391,98 @@ size_t ComposeIOSettings::getBottomUpInterval() const {
     }
 }
 
+size_t ComposeIOSettings::getCviThreads() const {
+    if (isCviThreadsSet()) {
+        return this->getOption(cviThreadsName).getArgumentByName("threads").getValueAsUnsignedInteger();
+    } else {
+        return 0;
+    }
+}
+
+size_t ComposeIOSettings::getCacheContentionBenchmarkThreads() const {
+    if (isCacheContentionBenchmarkSet()) {
+        return this->getOption(cacheContentionBenchmarkName).getArgumentByName("threads").getValueAsUnsignedInteger();
+    } else {
+        return 0;
+    }
+}
+
+size_t ComposeIOSettings::getParetoPrecomputationThreshold() const {
+    if (isParetoPrecomputationThresholdSet()) {
+        return this->getOption(paretoPrecomputationThresholdName).getArgumentByName("states").getValueAsUnsignedInteger();
+    } else {
+        return 0;
+    }
+}
+
+size_t ComposeIOSettings::getSubtreeSummarySweeps() const {
+    if (isSubtreeSummarySweepsSet()) {
+        return this->getOption(subtreeSummarySweepsName).getArgumentByName("sweeps").getValueAsUnsignedInteger();
+    } else {
+        return 0;
+    }
+}
+
+size_t ComposeIOSettings::getParetoBudget() const {
+    if (isParetoBudgetSet()) {
+        return this->getOption(paretoBudgetName).getArgumentByName("points").getValueAsUnsignedInteger();
+    } else {
+        return 0;
+    }
+}
+
+std::string ComposeIOSettings::getLeafCacheDirectory() const {
+    return this->getOption(leafCacheDirectoryName).getArgumentByName("directory").getValueAsString();
+}
+
+std::string ComposeIOSettings::getExportMonolithicMdpFilename() const {
+    return this->getOption(exportMonolithicMdpName).getArgumentByName("filename").getValueAsString();
+}
+
+double ComposeIOSettings::getExplorationPrecision() const {
+    if (isExplorationPrecisionSet()) {
+        return this->getOption(explorationPrecisionName).getArgumentByName("precision").getValueAsDouble();
+    } else {
+        return 1e-3;
+    }
+}
+
+std::string ComposeIOSettings::getExportBinaryStringDiagramFilename() const {
+    return this->getOption(exportBinaryStringDiagramName).getArgumentByName("filename").getValueAsString();
+}
+
+std::string ComposeIOSettings::getChromeTraceFilename() const {
+    return this->getOption(chromeTraceName).getArgumentByName("filename").getValueAsString();
+}
+
+size_t ComposeIOSettings::getExplorationStateLimit() const {
+    if (isExplorationStateLimitSet()) {
+        return this->getOption(explorationStateLimitName).getArgumentByName("states").getValueAsUnsignedInteger();
+    } else {
+        return 0;
+    }
+}
+
+size_t ComposeIOSettings::getExplorationSamples() const {
+    if (isExplorationSamplesSet()) {
+        return this->getOption(explorationSamplesName).getArgumentByName("samples").getValueAsUnsignedInteger();
+    } else {
+        return 100;
+    }
+}
+
+size_t ComposeIOSettings::getValueVectorBenchmarkLeaves() const {
+    return this->getOption(valueVectorBenchmarkName).getArgumentByName("leaves").getValueAsUnsignedInteger();
+}
+
+size_t ComposeIOSettings::getBuildThreads() const {
+    if (isBuildThreadsSet()) {
+        return this->getOption(buildThreadsName).getArgumentByName("threads").getValueAsUnsignedInteger();
+    } else {
+        return 1;
+    }
+}
+
 void ComposeIOSettings::addStringOption(std::string optionName, std::string description, std::string fieldName, std::string fieldDescription) {
     this->addOption(storm::settings::OptionBuilder(moduleName, optionName, false, description)
                         .addArgument(storm::settings::ArgumentBuilder::createStringArgument(fieldName, fieldDescription).build())
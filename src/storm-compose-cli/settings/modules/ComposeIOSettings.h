@@ -43,6 +43,24 @@ class ComposeIOSettings : public ModuleSettings {
     bool isIterationOrderSet() const;
     bool isLocalOviEpsilonSet() const;
     bool isUseRecursiveParetoComputationSet() const;
+    bool isCviThreadsSet() const;
+    bool isCacheContentionBenchmarkSet() const;
+    bool isExactParetoCacheSet() const;
+    bool isLipschitzCacheSet() const;
+    bool isParetoPrecomputationThresholdSet() const;
+    bool isBuildThreadsSet() const;
+    bool isValueVectorBenchmarkSet() const;
+    bool isLeafCacheDirectorySet() const;
+    bool isInvalidateLeafCacheSet() const;
+    bool isExportMonolithicMdpSet() const;
+    bool isExplorationPrecisionSet() const;
+    bool isExportBinaryStringDiagramSet() const;
+    bool isExplorationStateLimitSet() const;
+    bool isExplorationSamplesSet() const;
+    bool isSubtreeSummarySweepsSet() const;
+    bool isDisableParetoPruningSet() const;
+    bool isParetoBudgetSet() const;
+    bool isChromeTraceSet() const;
 
     std::string getStringDiagramFilename() const;
     std::string getEntrance() const;
@@ -61,6 +79,20 @@ class ComposeIOSettings : public ModuleSettings {
     double getParetoCacheEpsilon() const;
     size_t getOviInterval() const;
     size_t getBottomUpInterval() const;
+    size_t getCviThreads() const;
+    size_t getCacheContentionBenchmarkThreads() const;
+    size_t getParetoPrecomputationThreshold() const;
+    size_t getBuildThreads() const;
+    size_t getValueVectorBenchmarkLeaves() const;
+    std::string getLeafCacheDirectory() const;
+    std::string getExportMonolithicMdpFilename() const;
+    double getExplorationPrecision() const;
+    std::string getExportBinaryStringDiagramFilename() const;
+    size_t getExplorationStateLimit() const;
+    size_t getExplorationSamples() const;
+    size_t getSubtreeSummarySweeps() const;
+    size_t getParetoBudget() const;
+    std::string getChromeTraceFilename() const;
 
     // The name of the module.
     static const std::string moduleName;
@@ -84,6 +116,24 @@ class ComposeIOSettings : public ModuleSettings {
     static const std::string iterationOrderName;
     static const std::string localOviEpsilonName;
     static const std::string useRecursiveParetoComputationName;
+    static const std::string cviThreadsName;
+    static const std::string cacheContentionBenchmarkName;
+    static const std::string exactParetoCacheName;
+    static const std::string lipschitzCacheName;
+    static const std::string paretoPrecomputationThresholdName;
+    static const std::string buildThreadsName;
+    static const std::string valueVectorBenchmarkName;
+    static const std::string leafCacheDirectoryName;
+    static const std::string invalidateLeafCacheName;
+    static const std::string exportMonolithicMdpName;
+    static const std::string explorationPrecisionName;
+    static const std::string explorationStateLimitName;
+    static const std::string explorationSamplesName;
+    static const std::string subtreeSummarySweepsName;
+    static const std::string disableParetoPruningName;
+    static const std::string paretoBudgetName;
+    static const std::string exportBinaryStringDiagramName;
+    static const std::string chromeTraceName;
 
    private:
     void addStringOption(std::string optionName, std::string description, std::string fieldName, std::string fieldDescription);
@@ -22,13 +22,17 @@
 #include "storm-compose/models/visitor/BenchmarkStatsVisitor.h"
 #include "storm-compose/models/visitor/FlatMdpBuilderVisitor.h"
 #include "storm-compose/models/visitor/ParetoVisitor.h"
+#include "storm-compose/parser/BinaryStringDiagramParser.h"
 #include "storm-compose/parser/JsonStringDiagramParser.h"
 
 #include "storm-compose/benchmark/BenchmarkStats.h"
+#include "storm-compose/benchmark/ValueVectorBenchmark.h"
 #include "storm-compose/modelchecker/AbstractOpenMdpChecker.h"
 #include "storm-compose/modelchecker/CompositionalValueIteration.h"
+#include "storm-compose/modelchecker/LazyMonolithicOpenMdpChecker.h"
 #include "storm-compose/modelchecker/MonolithicOpenMdpChecker.h"
 #include "storm-compose/modelchecker/NaiveOpenMdpChecker.h"
+#include "storm-compose/storage/LeafDiskCache.h"
 
 #include "storm-parsers/parser/ExpressionParser.h"
 
@@ -40,6 +44,7 @@ namespace cli {
 
 enum ReachabilityCheckingApproach {
     MONOLITHIC,
+    LAZY_MONOLITHIC,
     NAIVE,
     COMPOSITIONAL_VI,
 };
@@ -52,6 +57,7 @@ struct ReachabilityCheckingOptions {
     std::pair<bool, size_t> entrance{false, 0}, exit{true, 0};
     ReachabilityCheckingApproach approach = MONOLITHIC;
     boost::optional<std::string> benchmarkStatsPath;
+    boost::optional<std::string> chromeTracePath;
 };
 
 boost::optional<std::pair<bool, size_t>> parseEntranceExit(std::string text) {
@@ -85,6 +91,8 @@ boost::optional<ReachabilityCheckingOptions<ValueType>> processOptions() {
         std::string approach = composeSettings.getApproach();
         if (approach == "monolithic")
             options.approach = MONOLITHIC;
+        else if (approach == "lazy")
+            options.approach = LAZY_MONOLITHIC;
         else if (approach == "naive")
             options.approach = NAIVE;
         else if (approach == "cvi")
@@ -99,8 +107,23 @@ boost::optional<ReachabilityCheckingOptions<ValueType>> processOptions() {
     STORM_PRINT_AND_LOG("Reading string diagram " << fileName << "\n");
 
     options.omdpManager = std::make_shared<storm::models::OpenMdpManager<ValueType>>();
-    auto parser = storm::parser::JsonStringDiagramParser<ValueType>::fromFilePath(fileName, options.omdpManager);
-    parser.parse();
+    options.omdpManager->setBuildThreadCount(composeSettings.getBuildThreads());
+    if (composeSettings.isLeafCacheDirectorySet()) {
+        auto diskCache = std::make_shared<storm::storage::LeafDiskCache<ValueType>>(composeSettings.getLeafCacheDirectory());
+        if (composeSettings.isInvalidateLeafCacheSet()) {
+            diskCache->invalidate();
+        }
+        options.omdpManager->setDiskCache(diskCache);
+    }
+    if (storm::parser::BinaryStringDiagram::isBinaryStringDiagram(fileName)) {
+        storm::parser::BinaryStringDiagramParser<ValueType>::fromFilePath(fileName, options.omdpManager).parse();
+    } else {
+        if (composeSettings.isExportBinaryStringDiagramSet()) {
+            storm::parser::BinaryStringDiagram::convertJson(fileName, composeSettings.getExportBinaryStringDiagramFilename());
+        }
+        auto parser = storm::parser::JsonStringDiagramParser<ValueType>::fromFilePath(fileName, options.omdpManager);
+        parser.parse();
+    }
 
     // TODO find better place for this
     // if (composeSettings.isExportStringDiagramSet()) {
@@ -114,6 +137,9 @@ boost::optional<ReachabilityCheckingOptions<ValueType>> processOptions() {
     if (composeSettings.isBenchmarkDataSet()) {
         options.benchmarkStatsPath = composeSettings.getBenchmarkDataFilename();
     }
+    if (composeSettings.isChromeTraceSet()) {
+        options.chromeTracePath = composeSettings.getChromeTraceFilename();
+    }
 
     return options;
 }
@@ -140,12 +166,27 @@ void performModelChecking(ReachabilityCheckingOptions<ValueType>& options) {
         settings.steps = boost::none;
     }
 
+    stats.recordTraceEvents = options.chromeTracePath.is_initialized();
+    stats.startTime = storm::compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
     stats.totalTime.start();
     std::unique_ptr<storm::modelchecker::AbstractOpenMdpChecker<ValueType>> checker;
     switch (options.approach) {
-        case MONOLITHIC:
-            checker = std::make_unique<storm::modelchecker::MonolithicOpenMdpChecker<ValueType>>(options.omdpManager, stats);
+        case MONOLITHIC: {
+            auto monolithicChecker = std::make_unique<storm::modelchecker::MonolithicOpenMdpChecker<ValueType>>(options.omdpManager, stats);
+            if (composeSettings.isExportMonolithicMdpSet()) {
+                monolithicChecker->setExportFilename(composeSettings.getExportMonolithicMdpFilename());
+            }
+            checker = std::move(monolithicChecker);
             break;
+        }
+        case LAZY_MONOLITHIC: {
+            typename modelchecker::LazyMonolithicOpenMdpChecker<ValueType>::Options lazyOptions;
+            lazyOptions.precision = storm::utility::convertNumber<ValueType>(composeSettings.getExplorationPrecision());
+            lazyOptions.stateLimit = composeSettings.getExplorationStateLimit();
+            lazyOptions.samplesPerRound = composeSettings.getExplorationSamples();
+            checker = std::make_unique<storm::modelchecker::LazyMonolithicOpenMdpChecker<ValueType>>(options.omdpManager, stats, lazyOptions);
+            break;
+        }
         case NAIVE:
             checker = std::make_unique<storm::modelchecker::NaiveOpenMdpChecker<ValueType>>(options.omdpManager, stats, settings);
             break;
@@ -163,6 +204,14 @@ void performModelChecking(ReachabilityCheckingOptions<ValueType>& options) {
             modelcheckerOptions.iterationOrder = composeSettings.getIterationOrder();
             modelcheckerOptions.localOviEpsilon = composeSettings.getLocalOviEpsilon();
             modelcheckerOptions.useRecursiveParetoComputation = composeSettings.isUseRecursiveParetoComputationSet();
+            modelcheckerOptions.threadCount = composeSettings.getCviThreads();
+            modelcheckerOptions.exactParetoCache = composeSettings.isExactParetoCacheSet();
+            modelcheckerOptions.useLipschitzBounds = composeSettings.isLipschitzCacheSet();
+            modelcheckerOptions.pruneParetoBounds = !composeSettings.isDisableParetoPruningSet();
+            modelcheckerOptions.paretoEntranceBudget = composeSettings.getParetoBudget();
+            modelcheckerOptions.cacheContentionThreads = composeSettings.getCacheContentionBenchmarkThreads();
+            modelcheckerOptions.paretoPrecomputationThreshold = composeSettings.getParetoPrecomputationThreshold();
+            modelcheckerOptions.subtreeSummarySweeps = composeSettings.getSubtreeSummarySweeps();
 
             checker = std::make_unique<storm::modelchecker::CompositionalValueIteration<ValueType>>(options.omdpManager, stats, modelcheckerOptions);
             break;
@@ -184,11 +233,23 @@ void performModelChecking(ReachabilityCheckingOptions<ValueType>& options) {
         out << statsAsJson.dump(4);
         out.close();
     }
+    if (options.chromeTracePath) {
+        stats.writeChromeTrace(*options.chromeTracePath);
+    }
 
     std::cout << "Checking for reachability from entrance " << task.getEntranceLabel() << " to exit " << task.getExitLabel() << std::endl;
     std::cout << "Result: " << result << std::endl;
 }
 
+void runValueVectorBenchmark(size_t leafCount) {
+    const size_t sweeps = 100;
+    storm::compose::benchmark::ValueVectorBenchmark<double> benchmark(leafCount);
+    auto result = benchmark.run(sweeps);
+    std::cout << "Value vector overhead per sweep over " << leafCount << " leaves (average of " << sweeps << " sweeps):" << std::endl;
+    std::cout << "  map lookups: " << result.mapLookupTime * 1e3 << "ms" << std::endl;
+    std::cout << "  index tables: " << result.flatTime * 1e3 << "ms" << std::endl;
+}
+
 }  // namespace cli
 }  // namespace compose
 }  // namespace storm
@@ -213,6 +274,12 @@ int main(const int argc, const char** argv) {
         storm::utility::Stopwatch totalTimer(true);
         storm::cli::setUrgentOptions();
 
+        auto const& composeSettings = storm::settings::getModule<storm::settings::modules::ComposeIOSettings>();
+        if (composeSettings.isValueVectorBenchmarkSet()) {
+            storm::compose::cli::runValueVectorBenchmark(composeSettings.getValueVectorBenchmarkLeaves());
+            return 0;
+        }
+
         // Invoke storm-compose with obtained settings
         auto const& generalSettings = storm::settings::getModule<storm::settings::modules::GeneralSettings>();
 
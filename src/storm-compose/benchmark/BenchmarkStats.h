@@ -1,5 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
 #include "storage/geometry/NativePolytope.h"
 #include "storm/adapters/JsonAdapter.h"
 #include "storm/utility/Stopwatch.h"
@@ -14,8 +22,14 @@ struct BenchmarkStats {
 
     storm::utility::Stopwatch totalTime, modelBuildingTime, reachabilityComputationTime, terminationTime, shortcutMdpConstructionTime;
     size_t stateCount = 0, stringDiagramDepth = 0, uniqueLeaves = 0, leafStates = 0;
+    size_t sharedLeaves = 0;  // References whose leaf was not built because an identical one already existed
+    size_t diskCacheLeafLoads = 0, diskCacheParetoLoads = 0;  // Leaves and Pareto bounds that were loaded from the disk cache
     size_t sequenceCount = 0, sumCount = 0, traceCount = 0;
+    size_t exploredStates = 0, explorationRounds = 0;  // Lazy monolithic checking
     size_t lowerParetoPoints = 0, upperParetoPoints = 0;
+    size_t shortcutMdpUpdates = 0;  // Leaves whose shortcut MDPs were regenerated by the bottom-up termination check
+    size_t oviCertifiedLeaves = 0, oviSolvedLeaves = 0;  // Leaf checks of the OVI termination answered by the cache upper bound, or by solving the leaf
+    size_t summarizedSubtrees = 0, summarizedLeaves = 0;  // Subtrees that CVI iterates as a single leaf, and the leaf occurrences they contain
     ValueType lowerBound = storm::utility::zero<ValueType>(), upperBound = storm::utility::one<ValueType>();
     ValueType cacheHitRate = 0;
     storm::RationalNumber leafSchedulerCount = storm::utility::zero<storm::RationalNumber>();
@@ -23,8 +37,147 @@ struct BenchmarkStats {
     size_t weightedReachabilityQueries = 0, cacheHits = 0;
     storm::utility::Stopwatch cacheRetrievalTime, cacheInsertionTime;
 
+    // Time spent in floating point and exact arithmetic by the Pareto cache, and how many upper bounds were computed with each
+    // (or derived from a nearby weight)
+    storm::utility::Stopwatch paretoFloatTime, paretoExactTime;
+    size_t paretoFloatUpperBounds = 0, paretoExactUpperBounds = 0, paretoLipschitzUpperBounds = 0;
+
+    // Pareto cache points and halfspaces that were removed without changing a bound, or evicted to stay within the budget
+    size_t paretoPrunedPoints = 0, paretoRedundantHalfspaces = 0, paretoEvictedPoints = 0, paretoEvictedHalfspaces = 0;
+
+    // Time spent precomputing the Pareto sets of small leaves and answering weighted reachability queries from them
+    storm::utility::Stopwatch paretoPrecomputationTime, paretoPrecomputedQueryTime;
+    size_t paretoPrecomputedLeaves = 0;
+
+    // Number of updates of each leaf by the lower bound iteration, keyed by the leaf name like the profiles, so the counts of all value iterators
+    // of a run add up
+    std::map<std::string, size_t> leafUpdates;
+
+    // Wall-clock time (in seconds) of replaying the recorded cache operations, indexed by thread count - 1
+    std::vector<double> cacheContentionTimes;
+
+    typedef std::chrono::steady_clock Clock;
+
+    // Work spent on a single leaf (or subtree summary) by the value iteration and the OVI termination check
+    struct LeafProfile {
+        bool initialized = false;  // Set once name, states and choices are known
+        std::string name;
+        size_t states = 0, choices = 0;
+        size_t solves = 0, cacheHits = 0, cacheMisses = 0;
+        size_t paretoPoints = 0;  // Lower bound points of the Pareto cache at the end of the run
+        storm::utility::Stopwatch solveTime;
+
+        void merge(LeafProfile const& other) {
+            if (!initialized) {
+                initialized = other.initialized;
+                name = other.name;
+                states = other.states;
+                choices = other.choices;
+            }
+            solves += other.solves;
+            cacheHits += other.cacheHits;
+            cacheMisses += other.cacheMisses;
+            solveTime.add(other.solveTime);
+        }
+    };
+    // Keyed by the leaf name, which unlike the address stays unique for the whole run
+    std::map<std::string, LeafProfile> leafProfiles;
+
+    // Bounds on the result after each CVI step, the upper bound is only known in steps that checked termination
+    struct StepRecord {
+        size_t step;
+        double time;  // Seconds since startTime
+        ValueType lowerBound;
+        boost::optional<ValueType> upperBound;
+    };
+    std::vector<StepRecord> steps;
+
+    // Leaf solves and CVI phases as complete events of the Chrome trace event format, only recorded if recordTraceEvents is set
+    struct TraceEvent {
+        std::string name;
+        Clock::time_point start, end;
+        size_t thread;
+    };
+    bool recordTraceEvents = false;
+    size_t threadId = 0;  // Thread of the events recorded by this instance
+    Clock::time_point startTime = Clock::now();
+    std::vector<TraceEvent> traceEvents;
+
     constexpr static double NANOSECONDS_TO_SECONDS = 1e-9;
 
+    // Returns the profile of the leaf, a named ConcreteMdp
+    template<typename LeafType>
+    LeafProfile& getLeafProfile(LeafType const& leaf) {
+        std::string name = leaf.getName();
+        LeafProfile& profile = leafProfiles[name];
+        if (!profile.initialized) {
+            profile.initialized = true;
+            profile.name = std::move(name);
+            profile.states = leaf.getMdp()->getNumberOfStates();
+            profile.choices = leaf.getMdp()->getNumberOfChoices();
+        }
+        return profile;
+    }
+
+    // Records a solve of the leaf that started at the given time point
+    void recordSolve(LeafProfile& profile, Clock::time_point start) {
+        Clock::time_point end = Clock::now();
+        ++profile.solves;
+        profile.solveTime.addToTime(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+        if (recordTraceEvents) {
+            traceEvents.push_back({profile.name, start, end, threadId});
+        }
+    }
+
+    void recordPhase(std::string const& name, Clock::time_point start) {
+        if (recordTraceEvents) {
+            traceEvents.push_back({name, start, Clock::now(), threadId});
+        }
+    }
+
+    void recordStep(size_t step, ValueType const& lowerBound, boost::optional<ValueType> const& upperBound = boost::none) {
+        steps.push_back({step, std::chrono::duration<double>(Clock::now() - startTime).count(), lowerBound, upperBound});
+    }
+
+    // Writes the trace events in the Chrome trace event format, timestamps are microseconds since startTime
+    void writeChromeTrace(std::string const& path) const {
+        storm::json<ValueType> events = storm::json<ValueType>::array();
+        for (auto const& event : traceEvents) {
+            storm::json<ValueType> entry;
+            entry["name"] = event.name;
+            entry["ph"] = "X";
+            entry["ts"] = std::chrono::duration<double, std::micro>(event.start - startTime).count();
+            entry["dur"] = std::chrono::duration<double, std::micro>(event.end - event.start).count();
+            entry["pid"] = 0;
+            entry["tid"] = event.thread;
+            events.push_back(entry);
+        }
+
+        storm::json<ValueType> result;
+        result["traceEvents"] = events;
+        result["displayTimeUnit"] = "ms";
+        std::ofstream out(path);
+        out << result.dump();
+        out.close();
+    }
+
+    // Adds the query counters and timers of another instance (e.g. one collected by a worker thread) to these stats.
+    void mergeQueryStats(BenchmarkStats<ValueType> const& other) {
+        weightedReachabilityQueries += other.weightedReachabilityQueries;
+        cacheHits += other.cacheHits;
+        reachabilityComputationTime.add(other.reachabilityComputationTime);
+        cacheRetrievalTime.add(other.cacheRetrievalTime);
+        cacheInsertionTime.add(other.cacheInsertionTime);
+
+        for (auto const& profile : other.leafProfiles) {
+            leafProfiles[profile.first].merge(profile.second);
+        }
+        for (auto const& updates : other.leafUpdates) {
+            leafUpdates[updates.first] += updates.second;
+        }
+        traceEvents.insert(traceEvents.end(), other.traceEvents.begin(), other.traceEvents.end());
+    }
+
     storm::json<ValueType> toJson() {
         storm::json<ValueType> result;
 
@@ -38,11 +191,17 @@ struct BenchmarkStats {
         result["stringDiagramDepth"] = stringDiagramDepth;
         result["uniqueLeaves"] = uniqueLeaves;
         result["leafStates"] = leafStates;
+        result["sharedLeaves"] = sharedLeaves;
+        result["diskCacheLeafLoads"] = diskCacheLeafLoads;
+        result["diskCacheParetoLoads"] = diskCacheParetoLoads;
 
         result["sequenceCount"] = sequenceCount;
         result["sumCount"] = sumCount;
         result["traceCount"] = traceCount;
 
+        result["exploredStates"] = exploredStates;
+        result["explorationRounds"] = explorationRounds;
+
         result["lowerBound"] = lowerBound;
         result["upperBound"] = upperBound;
         ValueType gap = upperBound - lowerBound;
@@ -50,6 +209,11 @@ struct BenchmarkStats {
 
         result["lowerParetoPoints"] = lowerParetoPoints;
         result["upperParetoPoints"] = upperParetoPoints;
+        result["shortcutMdpUpdates"] = shortcutMdpUpdates;
+        result["oviCertifiedLeaves"] = oviCertifiedLeaves;
+        result["oviSolvedLeaves"] = oviSolvedLeaves;
+        result["summarizedSubtrees"] = summarizedSubtrees;
+        result["summarizedLeaves"] = summarizedLeaves;
 
         storm::RationalNumber schedulerLimit = storm::utility::pow(storm::RationalNumber(2), 64);
         if (leafSchedulerCount > schedulerLimit) {
@@ -64,6 +228,87 @@ struct BenchmarkStats {
         result["cacheInsertionTime"] = cacheInsertionTime.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS;
         result["cacheHitRatio"] = (double)cacheHits / (double)weightedReachabilityQueries;
 
+        result["paretoFloatTime"] = paretoFloatTime.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS;
+        result["paretoExactTime"] = paretoExactTime.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS;
+        result["paretoFloatUpperBounds"] = paretoFloatUpperBounds;
+        result["paretoExactUpperBounds"] = paretoExactUpperBounds;
+        result["paretoLipschitzUpperBounds"] = paretoLipschitzUpperBounds;
+        result["paretoPrunedPoints"] = paretoPrunedPoints;
+        result["paretoRedundantHalfspaces"] = paretoRedundantHalfspaces;
+        result["paretoEvictedPoints"] = paretoEvictedPoints;
+        result["paretoEvictedHalfspaces"] = paretoEvictedHalfspaces;
+        auto paretoArithmeticTime = paretoFloatTime.getTimeInNanoseconds() + paretoExactTime.getTimeInNanoseconds();
+        if (paretoArithmeticTime > 0) {
+            result["paretoExactTimeRatio"] = (double)paretoExactTime.getTimeInNanoseconds() / (double)paretoArithmeticTime;
+        }
+
+        result["paretoPrecomputedLeaves"] = paretoPrecomputedLeaves;
+        result["paretoPrecomputationTime"] = paretoPrecomputationTime.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS;
+        result["paretoPrecomputedQueryTime"] = paretoPrecomputedQueryTime.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS;
+
+        if (!leafUpdates.empty()) {
+            size_t maxLeafUpdates = 0;
+            for (auto const& updates : leafUpdates) {
+                result["leafUpdates"][updates.first] = updates.second;
+                maxLeafUpdates = std::max(maxLeafUpdates, updates.second);
+            }
+            result["maxLeafUpdates"] = maxLeafUpdates;
+        }
+
+        if (!leafProfiles.empty()) {
+            // Most expensive leaves first
+            std::vector<LeafProfile const*> profiles;
+            for (auto const& profile : leafProfiles) {
+                profiles.push_back(&profile.second);
+            }
+            std::stable_sort(profiles.begin(), profiles.end(), [](LeafProfile const* a, LeafProfile const* b) {
+                return a->solveTime.getTimeInNanoseconds() > b->solveTime.getTimeInNanoseconds();
+            });
+
+            storm::json<ValueType> profilesJson;
+            for (auto profile : profiles) {
+                storm::json<ValueType> entry;
+                entry["name"] = profile->name;
+                entry["states"] = profile->states;
+                entry["choices"] = profile->choices;
+                entry["solves"] = profile->solves;
+                entry["solveTime"] = profile->solveTime.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS;
+                entry["cacheHits"] = profile->cacheHits;
+                entry["cacheMisses"] = profile->cacheMisses;
+                entry["paretoPoints"] = profile->paretoPoints;
+                profilesJson.push_back(entry);
+            }
+            result["leafProfiles"] = profilesJson;
+        }
+
+        if (!steps.empty()) {
+            storm::json<ValueType> stepsJson;
+            for (auto const& step : steps) {
+                storm::json<ValueType> entry;
+                entry["step"] = step.step;
+                entry["time"] = step.time;
+                entry["lowerBound"] = step.lowerBound;
+                if (step.upperBound) {
+                    entry["upperBound"] = *step.upperBound;
+                    ValueType stepGap = *step.upperBound - step.lowerBound;
+                    entry["gap"] = stepGap;
+                }
+                stepsJson.push_back(entry);
+            }
+            result["steps"] = stepsJson;
+        }
+
+        if (!cacheContentionTimes.empty()) {
+            storm::json<ValueType> contention;
+            for (size_t i = 0; i < cacheContentionTimes.size(); ++i) {
+                storm::json<ValueType> entry;
+                entry["threads"] = i + 1;
+                entry["time"] = cacheContentionTimes[i];
+                contention.push_back(entry);
+            }
+            result["cacheContention"] = contention;
+        }
+
         // result["optimizeTime"] = storage::geometry::NativePolytope<ValueType>::optimizeTimer.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS;
 
         return result;
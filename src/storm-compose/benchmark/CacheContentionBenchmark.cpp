@@ -0,0 +1,65 @@
+#include "CacheContentionBenchmark.h"
+
+#include "storm-compose/benchmark/BenchmarkStats.h"
+#include "storm-compose/utility/ThreadPool.h"
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/utility/Stopwatch.h"
+#include "storm/utility/macros.h"
+
+namespace storm {
+namespace compose {
+namespace benchmark {
+
+template<class ValueType>
+CacheContentionBenchmark<ValueType>::CacheContentionBenchmark(std::shared_ptr<CacheQueryTrace<ValueType>> trace,
+                                                              std::vector<models::ConcreteMdp<ValueType>*> leaves, ValueType errorTolerance,
+                                                              typename storm::storage::ParetoCache<ValueType>::Options cacheOptions)
+    : trace(std::move(trace)), leaves(std::move(leaves)), errorTolerance(errorTolerance), cacheOptions(cacheOptions) {}
+
+template<class ValueType>
+std::vector<typename CacheContentionBenchmark<ValueType>::Result> CacheContentionBenchmark<ValueType>::run(size_t maxThreadCount) {
+    std::vector<Result> results;
+    for (size_t threadCount = 1; threadCount <= maxThreadCount; ++threadCount) {
+        results.push_back(replay(threadCount));
+        STORM_LOG_INFO("Replayed " << trace->size() << " cache operations with " << threadCount << " thread(s) in " << results.back().time << "s");
+    }
+
+    return results;
+}
+
+template<class ValueType>
+typename CacheContentionBenchmark<ValueType>::Result CacheContentionBenchmark<ValueType>::replay(size_t threadCount) const {
+    storm::storage::ParetoCache<ValueType> cache(cacheOptions);
+    cache.setErrorTolerance(errorTolerance);
+    std::vector<models::ConcreteMdp<ValueType>*> leavesCopy(leaves);
+    cache.initializeParetoCurves(leavesCopy);
+
+    auto const& queries = trace->getQueries();
+    compose::utility::ThreadPool threadPool(threadCount);
+
+    storm::utility::Stopwatch timer(true);
+    threadPool.parallelFor(queries.size(), [&](size_t index, size_t) {
+        auto const& query = queries[index];
+        switch (query.type) {
+            case CacheQueryTrace<ValueType>::LOWER_BOUND:
+                cache.getLowerBound(query.leaf, query.outputWeight);
+                break;
+            case CacheQueryTrace<ValueType>::UPPER_BOUND:
+                cache.getUpperBound(query.leaf, query.outputWeight);
+                break;
+            case CacheQueryTrace<ValueType>::INSERTION:
+                cache.addToCache(query.leaf, query.outputWeight, query.inputWeight, query.scheduler);
+                break;
+        }
+    });
+    timer.stop();
+
+    return Result{threadCount, timer.getTimeInNanoseconds() * BenchmarkStats<ValueType>::NANOSECONDS_TO_SECONDS};
+}
+
+template class CacheContentionBenchmark<double>;
+template class CacheContentionBenchmark<storm::RationalNumber>;
+
+}  // namespace benchmark
+}  // namespace compose
+}  // namespace storm
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "storm-compose/benchmark/CacheQueryTrace.h"
+#include "storm-compose/models/ConcreteMdp.h"
+#include "storm-compose/storage/ParetoCache.h"
+
+namespace storm {
+namespace compose {
+namespace benchmark {
+
+// Replays a recorded trace of Pareto cache operations against fresh caches with an increasing number of threads to measure lock contention.
+template<class ValueType>
+class CacheContentionBenchmark {
+   public:
+    struct Result {
+        size_t threadCount;
+        double time;  // wall-clock time in seconds
+    };
+
+    CacheContentionBenchmark(std::shared_ptr<CacheQueryTrace<ValueType>> trace, std::vector<models::ConcreteMdp<ValueType>*> leaves, ValueType errorTolerance,
+                             typename storm::storage::ParetoCache<ValueType>::Options cacheOptions);
+
+    /// Replays the trace once for every thread count in [1, maxThreadCount].
+    std::vector<Result> run(size_t maxThreadCount);
+
+    /// Replays the trace with the given number of threads. The operations are handed out in trace order, so each thread sees the
+    /// insertions roughly at the same point as the original (sequential) computation did.
+    Result replay(size_t threadCount) const;
+
+   private:
+    std::shared_ptr<CacheQueryTrace<ValueType>> trace;
+    std::vector<models::ConcreteMdp<ValueType>*> leaves;
+    ValueType errorTolerance;
+    typename storm::storage::ParetoCache<ValueType>::Options cacheOptions;
+};
+
+}  // namespace benchmark
+}  // namespace compose
+}  // namespace storm
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <boost/optional.hpp>
+#include <mutex>
+#include <vector>
+
+#include "storm-compose/models/ConcreteMdp.h"
+#include "storm/storage/Scheduler.h"
+
+namespace storm {
+namespace compose {
+namespace benchmark {
+
+// Sequence of cache operations in the order in which they were issued, recorded so they can be replayed against a fresh cache.
+template<class ValueType>
+class CacheQueryTrace {
+   public:
+    enum QueryType { LOWER_BOUND, UPPER_BOUND, INSERTION };
+
+    struct Query {
+        QueryType type;
+        models::ConcreteMdp<ValueType>* leaf;
+        std::vector<ValueType> outputWeight;
+        std::vector<ValueType> inputWeight;
+        boost::optional<storm::storage::Scheduler<ValueType>> scheduler;
+    };
+
+    void recordLowerBoundQuery(models::ConcreteMdp<ValueType>* leaf, std::vector<ValueType> const& outputWeight) {
+        record(Query{LOWER_BOUND, leaf, outputWeight, {}, boost::none});
+    }
+
+    void recordUpperBoundQuery(models::ConcreteMdp<ValueType>* leaf, std::vector<ValueType> const& outputWeight) {
+        record(Query{UPPER_BOUND, leaf, outputWeight, {}, boost::none});
+    }
+
+    void recordInsertion(models::ConcreteMdp<ValueType>* leaf, std::vector<ValueType> const& outputWeight, std::vector<ValueType> const& inputWeight,
+                         boost::optional<storm::storage::Scheduler<ValueType>> const& scheduler) {
+        record(Query{INSERTION, leaf, outputWeight, inputWeight, scheduler});
+    }
+
+    // Not synchronized with concurrent recording, only call this once the traced computation is finished
+    std::vector<Query> const& getQueries() const {
+        return queries;
+    }
+
+    size_t size() const {
+        return queries.size();
+    }
+
+   private:
+    void record(Query&& query) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queries.push_back(std::move(query));
+    }
+
+    std::mutex mutex;
+    std::vector<Query> queries;
+};
+
+}  // namespace benchmark
+}  // namespace compose
+}  // namespace storm
@@ -0,0 +1,90 @@
+#include "ValueVectorBenchmark.h"
+
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/utility/Stopwatch.h"
+#include "storm/utility/constants.h"
+
+namespace storm {
+namespace compose {
+namespace benchmark {
+
+namespace {
+const size_t WIDTH = 2;
+}
+
+template<class ValueType>
+ValueVectorBenchmark<ValueType>::ValueVectorBenchmark(size_t leafCount) {
+    // Exit j of leaf i is connected to entrance j of leaf i + 1, both share the value index WIDTH * (i + 1) + j
+    std::vector<models::ConcreteMdp<ValueType>*> leaves;
+    std::set<Key> outerPositions;
+    for (size_t leafId = 0; leafId < leafCount; ++leafId) {
+        leafStorage.push_back(std::make_shared<models::ConcreteMdp<ValueType>>(std::weak_ptr<models::OpenMdpManager<ValueType>>(), nullptr,
+                                                                               std::vector<size_t>{0, 1}, std::vector<size_t>{}, std::vector<size_t>{},
+                                                                               std::vector<size_t>{2, 3}));
+        leaves.push_back(leafStorage.back().get());
+
+        for (size_t j = 0; j < WIDTH; ++j) {
+            positions[{leafId, {storm::storage::L_ENTRANCE, j}}] = WIDTH * leafId + j;
+            positions[{leafId, {storm::storage::R_EXIT, j}}] = WIDTH * (leafId + 1) + j;
+            if (leafId == 0) {
+                outerPositions.insert({leafId, {storm::storage::L_ENTRANCE, j}});
+            }
+            if (leafId + 1 == leafCount) {
+                outerPositions.insert({leafId, {storm::storage::R_EXIT, j}});
+            }
+        }
+    }
+
+    storm::storage::ValueVectorMapping<ValueType> mapping(leaves, positions, outerPositions, WIDTH * (leafCount + 1) - 1);
+    valueVector = storm::storage::ValueVector<ValueType>(mapping, std::vector<ValueType>(WIDTH, storm::utility::one<ValueType>()));
+    valueVector.initializeValues();
+}
+
+template<class ValueType>
+typename ValueVectorBenchmark<ValueType>::Result ValueVectorBenchmark<ValueType>::run(size_t sweeps) {
+    auto& values = valueVector.getValues();
+    size_t leafCount = leafStorage.size();
+    ValueType half = storm::utility::convertNumber<ValueType>(0.5);
+
+    // The previous layout: a map lookup per position and fresh vectors for every leaf
+    storm::utility::Stopwatch mapTimer(true);
+    for (size_t sweep = 0; sweep < sweeps; ++sweep) {
+        for (size_t leafId = leafCount; leafId-- > 0;) {
+            std::vector<ValueType> weights;
+            for (size_t j = 0; j < WIDTH; ++j) {
+                weights.push_back(values[positions.at({leafId, {storm::storage::R_EXIT, j}})]);
+            }
+            std::vector<ValueType> inputWeights;
+            for (size_t j = 0; j < WIDTH; ++j) {
+                inputWeights.push_back(half * (weights[0] + weights[1]));
+            }
+            for (size_t j = 0; j < WIDTH; ++j) {
+                values[positions.at({leafId, {storm::storage::L_ENTRANCE, j}})] = inputWeights[j];
+            }
+        }
+    }
+    mapTimer.stop();
+
+    storm::utility::Stopwatch flatTimer(true);
+    std::vector<ValueType> weights, inputWeights(WIDTH);
+    for (size_t sweep = 0; sweep < sweeps; ++sweep) {
+        for (size_t leafId = leafCount; leafId-- > 0;) {
+            valueVector.getOutputWeights(leafId, weights);
+            for (size_t j = 0; j < WIDTH; ++j) {
+                inputWeights[j] = half * (weights[0] + weights[1]);
+            }
+            valueVector.setInputWeights(leafId, inputWeights);
+        }
+    }
+    flatTimer.stop();
+
+    constexpr double NANOSECONDS_TO_SECONDS = 1e-9;
+    return {mapTimer.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS / sweeps, flatTimer.getTimeInNanoseconds() * NANOSECONDS_TO_SECONDS / sweeps};
+}
+
+template class ValueVectorBenchmark<double>;
+template class ValueVectorBenchmark<storm::RationalNumber>;
+
+}  // namespace benchmark
+}  // namespace compose
+}  // namespace storm
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "storm-compose/models/ConcreteMdp.h"
+#include "storm-compose/storage/ValueVector.h"
+
+namespace storm {
+namespace compose {
+namespace benchmark {
+
+// Measures the overhead of one CVI sweep that is not spent in the leaves: reading the exit weights and writing the entrance values of every
+// leaf. The diagram is a synthetic sequence of leaves with two entrances and two exits each, the leaves themselves are never solved.
+template<class ValueType>
+class ValueVectorBenchmark {
+   public:
+    struct Result {
+        double mapLookupTime;  // seconds per sweep, with a map lookup per position and fresh vectors per leaf
+        double flatTime;       // seconds per sweep, with the index tables of the mapping and reused buffers
+    };
+
+    ValueVectorBenchmark(size_t leafCount);
+
+    Result run(size_t sweeps);
+
+   private:
+    typedef std::pair<size_t, storm::storage::Position> Key;
+
+    std::vector<std::shared_ptr<models::ConcreteMdp<ValueType>>> leafStorage;
+    std::map<Key, size_t> positions;
+    storm::storage::ValueVector<ValueType> valueVector;
+};
+
+}  // namespace benchmark
+}  // namespace compose
+}  // namespace storm
@@ -0,0 +1,98 @@
+#include "DiagramStateGenerator.h"
+
+#include <algorithm>
+
+#include "storm-compose/models/OpenMdpManager.h"
+#include "storm-compose/models/visitor/FlatMdpLayoutVisitor.h"
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/macros.h"
+
+namespace storm {
+namespace compose {
+namespace generator {
+
+template<typename ValueType>
+DiagramStateGenerator<ValueType>::DiagramStateGenerator(std::shared_ptr<models::OpenMdpManager<ValueType>> manager) {
+    models::visitor::FlatMdpLayoutVisitor<ValueType> visitor(manager);
+    manager->getRoot()->accept(visitor);
+
+    for (auto const& leaf : visitor.getLeaves()) {
+        leafMdps.push_back(leaf.mdp);
+        leafOffsets.push_back(leaf.offset);
+    }
+    leafOffsets.push_back(visitor.getStateCount());
+
+    // Later redirects belong to outer compositions and take precedence
+    for (auto const& redirect : visitor.getRedirects()) {
+        redirects[redirect.first] = redirect.second;
+    }
+
+    auto const& layout = visitor.getLayout();
+    auto addLabels = [this](std::string const& prefix, std::vector<size_t> const& states) {
+        for (size_t i = 0; i < states.size(); ++i) {
+            labeledStates[prefix + std::to_string(i)] = states[i];
+        }
+    };
+    addLabels("len", layout.lEntrance);
+    addLabels("ren", layout.rEntrance);
+    addLabels("lex", layout.lExit);
+    addLabels("rex", layout.rExit);
+}
+
+template<typename ValueType>
+typename DiagramStateGenerator<ValueType>::StateType DiagramStateGenerator<ValueType>::getStateCount() const {
+    return leafOffsets.back();
+}
+
+template<typename ValueType>
+size_t DiagramStateGenerator<ValueType>::getLeafCount() const {
+    return leafMdps.size();
+}
+
+template<typename ValueType>
+typename DiagramStateGenerator<ValueType>::StateType DiagramStateGenerator<ValueType>::getLabeledState(std::string const& label) const {
+    auto it = labeledStates.find(label);
+    STORM_LOG_THROW(it != labeledStates.end(), storm::exceptions::InvalidArgumentException, "The string diagram has no entrance or exit " << label);
+    return it->second;
+}
+
+template<typename ValueType>
+std::pair<size_t, typename DiagramStateGenerator<ValueType>::StateType> DiagramStateGenerator<ValueType>::getLeafState(StateType state) const {
+    STORM_LOG_ASSERT(state < getStateCount(), "State " << state << " out of range");
+    size_t leaf = std::upper_bound(leafOffsets.begin(), leafOffsets.end(), state) - leafOffsets.begin() - 1;
+    return {leaf, state - leafOffsets[leaf]};
+}
+
+template<typename ValueType>
+size_t DiagramStateGenerator<ValueType>::getChoiceCount(StateType state) const {
+    if (redirects.count(state) > 0) {
+        return 1;
+    }
+    auto leafState = getLeafState(state);
+    return leafMdps[leafState.first]->getTransitionMatrix().getRowGroupSize(leafState.second);
+}
+
+template<typename ValueType>
+void DiagramStateGenerator<ValueType>::expand(StateType state, size_t choice, Distribution& successors) const {
+    successors.clear();
+    auto redirect = redirects.find(state);
+    if (redirect != redirects.end()) {
+        successors.emplace_back(redirect->second, storm::utility::one<ValueType>());
+        return;
+    }
+
+    auto leafState = getLeafState(state);
+    StateType offset = leafOffsets[leafState.first];
+    for (auto const& entry : leafMdps[leafState.first]->getTransitionMatrix().getRow(leafState.second, choice)) {
+        successors.emplace_back(offset + entry.getColumn(), entry.getValue());
+    }
+}
+
+template class DiagramStateGenerator<double>;
+template class DiagramStateGenerator<storm::RationalNumber>;
+
+}  // namespace generator
+}  // namespace compose
+}  // namespace storm
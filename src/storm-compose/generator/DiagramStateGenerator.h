@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "storm/models/sparse/Mdp.h"
+
+namespace storm {
+namespace models {
+template<typename ValueType>
+class OpenMdpManager;
+}
+
+namespace compose {
+namespace generator {
+
+// Exposes the state space of the monolithic MDP of a string diagram without building it.
+//
+// A composed state is the state offset of its leaf occurrence plus the local state in the leaf, the same numbering as used by
+// FlatMdpBuilderVisitor. Only the leaf MDPs (shared between identical references) and the exit redirections of the compositions are kept in
+// memory, the choices of a state are generated on demand.
+template<typename ValueType>
+class DiagramStateGenerator {
+   public:
+    typedef uint64_t StateType;
+    typedef std::vector<std::pair<StateType, ValueType>> Distribution;
+
+    /// Expects the concrete MDPs of the manager to be constructed
+    DiagramStateGenerator(std::shared_ptr<models::OpenMdpManager<ValueType>> manager);
+
+    StateType getStateCount() const;
+    size_t getLeafCount() const;
+
+    /// State of the outer entrance or exit with the given label, e.g. len0 or rex2
+    StateType getLabeledState(std::string const& label) const;
+
+    /// Index of the leaf occurrence and local state of a composed state
+    std::pair<size_t, StateType> getLeafState(StateType state) const;
+
+    size_t getChoiceCount(StateType state) const;
+    /// Replaces the content of successors by the distribution of the given choice
+    void expand(StateType state, size_t choice, Distribution& successors) const;
+
+   private:
+    std::vector<std::shared_ptr<storm::models::sparse::Mdp<ValueType>>> leafMdps;
+    std::vector<StateType> leafOffsets;  // One more entry than there are leaves, the last one is the state count
+    std::unordered_map<StateType, StateType> redirects;
+    std::unordered_map<std::string, StateType> labeledStates;
+};
+
+}  // namespace generator
+}  // namespace compose
+}  // namespace storm
@@ -1,6 +1,12 @@
 #include "CompositionalValueIteration.h"
+
+#include <algorithm>
+#include <set>
+
+#include "storm-compose/benchmark/CacheContentionBenchmark.h"
 #include "storm-compose/modelchecker/ApproximateReachabilityResult.h"
 #include "storm-compose/modelchecker/HeuristicValueIterator.h"
+#include "storm-compose/modelchecker/WeightedReachabilityEngine.h"
 #include "storm-compose/modelchecker/OviStepUpdater.h"
 #include "storm-compose/modelchecker/ProperOviTermination.h"
 #include "storm-compose/models/visitor/BottomUpTermination.h"
@@ -13,8 +19,12 @@
 #include "storm-compose/models/visitor/SymbioticTermination.h"
 #include "storm-compose/storage/EntranceExit.h"
 #include "storm-compose/storage/ExactCache.h"
+#include "storm-compose/storage/LeafDiskCache.h"
 #include "storm-compose/storage/NoCache.h"
 #include "storm-compose/storage/ParetoCache.h"
+#include "storm/environment/modelchecker/ModelCheckerEnvironment.h"
+#include "storm/environment/modelchecker/MultiObjectiveModelCheckerEnvironment.h"
+#include "storm/environment/solver/SolverEnvironment.h"
 #include "storm/exceptions/InvalidOperationException.h"
 #include "storm/exceptions/NotSupportedException.h"
 #include "storm/utility/SignalHandler.h"
@@ -23,6 +33,41 @@
 namespace storm {
 namespace modelchecker {
 
+namespace {
+template<typename ValueType>
+using LeafOrigin = typename models::visitor::MappingVisitor<ValueType>::LeafOrigin;
+
+// Leaf occurrence of the diagram and its position that a position of a leaf of the mapping belongs to
+template<typename ValueType>
+std::pair<size_t, storage::Position> toDiagramPosition(LeafOrigin<ValueType> const& origin, storage::Position position) {
+    if (!origin.second) {
+        return {origin.first, position};
+    }
+    auto const& summaryOrigin = origin.second->origins.at(position);
+    return {origin.first + summaryOrigin.first, summaryOrigin.second};
+}
+
+// Value vector index of a position of a leaf occurrence of the diagram, none if the position is inside a summarized subtree
+template<typename ValueType>
+boost::optional<size_t> lookupDiagramPosition(storage::ValueVectorMapping<ValueType> const& mapping, std::vector<LeafOrigin<ValueType>> const& leafOrigins,
+                                              std::pair<size_t, storage::Position> const& diagramPosition) {
+    // Leaf origins are ordered by their first leaf occurrence
+    auto next = std::upper_bound(leafOrigins.begin(), leafOrigins.end(), diagramPosition.first,
+                                 [](size_t occurrence, LeafOrigin<ValueType> const& origin) { return occurrence < origin.first; });
+    size_t leafId = next - leafOrigins.begin() - 1;
+    auto const& origin = leafOrigins[leafId];
+    if (!origin.second) {
+        return mapping.lookup({leafId, diagramPosition.second});
+    }
+    for (auto const& entry : origin.second->origins) {
+        if (entry.second.first == diagramPosition.first - origin.first && entry.second.second == diagramPosition.second) {
+            return mapping.lookup({leafId, entry.first});
+        }
+    }
+    return boost::none;
+}
+}  // namespace
+
 template<typename ValueType>
 CompositionalValueIteration<ValueType>::CompositionalValueIteration(std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager,
                                                                     storm::compose::benchmark::BenchmarkStats<ValueType>& stats, Options options)
@@ -33,22 +78,24 @@ CompositionalValueIteration<ValueType>::CompositionalValueIteration(std::shared_
 
 template<typename ValueType>
 ApproximateReachabilityResult<ValueType> CompositionalValueIteration<ValueType>::check(OpenMdpReachabilityTask task) {
-    initialize(task);
-
     STORM_LOG_THROW(!options.useOvi || !options.useBottomUp, storm::exceptions::NotSupportedException, "Using OVI and bottom-up together is not supported");
     STORM_LOG_THROW(options.useOvi || options.useBottomUp, storm::exceptions::NotSupportedException, "Need either OVI or bottom-up termination");
+    // The summaries only give lower bounds, OVI would also use them for the upper bound
+    STORM_LOG_WARN_COND(!(options.useOvi && options.subtreeSummarySweeps > 0), "Subtree summaries are only used with bottom-up termination");
 
-    if (options.useOvi) {
-        return checkOvi(task);
-    } else {
-        return checkBottomUp(task);
+    initialize(task);
+    seedParetoCache();
+
+    auto result = options.useOvi ? checkOvi(task) : checkBottomUp(task);
+    if (cacheQueryTrace) {
+        runCacheContentionBenchmark();
     }
+
+    return result;
 }
 
 template<typename ValueType>
 ApproximateReachabilityResult<ValueType> CompositionalValueIteration<ValueType>::checkOvi(OpenMdpReachabilityTask task) {
-    initialize(task);
-
     boost::optional<ValueType> lowerValue, upperValue;
 
     // auto exactCache = std::make_shared<storage::ExactCache<ValueType>>();
@@ -59,13 +106,17 @@ ApproximateReachabilityResult<ValueType> CompositionalValueIteration<ValueType>:
     hviOptions.iterationOrder = HeuristicValueIterator<ValueType>::orderFromString(options.iterationOrder);
     hviOptions.localOviEpsilon = options.localOviEpsilon;
     hviOptions.cacheErrorTolerance = options.cacheErrorTolerance;
+    hviOptions.threadCount = options.threadCount;
 
     typename HeuristicValueIterator<ValueType>::Options oviOptions;
     oviOptions.exactOvi = options.localOviEpsilon == 0;
     HeuristicValueIterator<ValueType> lowerBoundIterator(hviOptions, this->manager, lowerBound, cache, this->stats);
 
     do {
+        auto stepStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
         lowerBoundIterator.performIteration();
+        this->stats.recordPhase("value iteration", stepStart);
+        this->stats.recordStep(currentStep, lowerBound.getValues()[0]);
         std::cout << "iteration " << currentStep << "/" << options.maxSteps << " current value: " << lowerBound.getValues()[0] << std::endl;
 
         if (shouldCheckOVITermination()) {
@@ -74,29 +125,26 @@ ApproximateReachabilityResult<ValueType> CompositionalValueIteration<ValueType>:
             upperBound = lowerBound;
             upperBound.addConstant(options.epsilon);
             size_t iter = 0;
+            // Certifies leaves with the upper bounds of the cache and only solves the others, a failed guess is repaired leaf by leaf
+            OviStepUpdater<ValueType> upperBoundIterator(oviOptions, this->manager, upperBound, cache, this->stats);
             while (upperBound.comparable(lowerBound)) {
                 std::cout << "OVI iteration " << iter << " current value: " << lowerBound.getValues()[0] << std::endl;
-                // TODO change caching behaviour:
-                // OviStepUpdater<ValueType> oviLowerBoundIterator(oviOptions, this->manager, lowerBound, noCache, this->stats);
-                // auto& oviCache = oviOptions.exactOvi ? noCache : cache;
-                auto& oviCache = noCache;
+                auto checkStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
                 this->stats.terminationTime.start();
-                OviStepUpdater<ValueType> upperBoundIterator(oviOptions, this->manager, upperBound, oviCache, this->stats);
-
-                upperBoundIterator.performIteration();
+                bool inductiveUpperBound = upperBoundIterator.performLocalIteration();
                 this->stats.terminationTime.stop();
-                lowerBoundIterator.performIteration();
-                auto newUpperBound = upperBoundIterator.getNewValueVector();
-
-                bool inductiveUpperBound = newUpperBound.dominatedBy(upperBound);
+                this->stats.recordPhase("OVI termination check", checkStart);
                 if (inductiveUpperBound) {
                     // Done
                     lowerValue = lowerBound.getValues()[0];  // TODO FIXME
                     upperValue = upperBound.getValues()[0];  // TODO FIXME
+                    this->stats.recordStep(currentStep, *lowerValue, upperValue);
                     goto cviLoopBreak;
                 }
 
-                upperBound = newUpperBound;
+                auto iterationStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
+                lowerBoundIterator.performIteration();
+                this->stats.recordPhase("value iteration", iterationStart);
                 ++iter;
             }
         }
@@ -112,10 +160,9 @@ cviLoopBreak:
     std::cout << "WARN for now assuming we are only interested in the first left entrance" << std::endl;
     std::cout << "WARN assuming first entrance is the one of interest" << std::endl;
 
-    storage::ParetoCache<ValueType>* paretoCache = dynamic_cast<storage::ParetoCache<ValueType>*>(&*cache);
-    if (paretoCache) {
-        this->stats.lowerParetoPoints = paretoCache->getLowerParetoPointCount();
-    }
+    collectParetoCacheStats();
+    collectPrecomputationStats();
+    storeParetoSetsToDisk();
 
     if (lowerValue && upperValue) {
         return ApproximateReachabilityResult<ValueType>(*lowerValue, *upperValue);
@@ -128,8 +175,6 @@ cviLoopBreak:
 
 template<typename ValueType>
 ApproximateReachabilityResult<ValueType> CompositionalValueIteration<ValueType>::checkBottomUp(OpenMdpReachabilityTask task) {
-    initialize(task);
-
     boost::optional<ValueType> lowerValue, upperValue;
 
     auto noCache = std::make_shared<storage::NoCache<ValueType>>();
@@ -140,11 +185,25 @@ ApproximateReachabilityResult<ValueType> CompositionalValueIteration<ValueType>:
     hviOptions.localOviEpsilon = options.localOviEpsilon;
     hviOptions.stepsPerIteration = 100;
     hviOptions.cacheErrorTolerance = options.cacheErrorTolerance;
+    hviOptions.threadCount = options.threadCount;
 
-    HeuristicValueIterator<ValueType> hvi(hviOptions, this->manager, lowerBound, cache, this->stats);
+    auto hvi = std::make_unique<HeuristicValueIterator<ValueType>>(hviOptions, this->manager, lowerBound, cache, this->stats);
+    // Kept between checks, so only the shortcut MDPs of leaves with new Pareto points are regenerated
+    std::unique_ptr<models::visitor::BottomUpTermination<ValueType>> bottomUpVisitor;
     do {
-        hvi.performIteration();
+        auto stepStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
+        hvi->performIteration();
+        this->stats.recordPhase("value iteration", stepStart);
         std::cout << "iteration " << currentStep << "/" << options.maxSteps << " current value: " << lowerBound.getValues()[0] << std::endl;
+        boost::optional<ValueType> stepUpperBound;
+
+        // The termination check below still uses the leaves of the summarized subtrees
+        auto summaryStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
+        if (options.subtreeSummarySweeps > 0 && summarizeStableSubtrees()) {
+            this->stats.recordPhase("subtree summary", summaryStart);
+            std::cout << "Summarized " << summaries.size() << " subtree(s) with " << this->stats.summarizedLeaves << " leaves" << std::endl;
+            hvi = std::make_unique<HeuristicValueIterator<ValueType>>(hviOptions, this->manager, lowerBound, cache, this->stats);
+        }
 
         if (shouldCheckBottomUpTermination()) {
             std::cout << "Checking Bottom-Up" << std::endl;
@@ -163,35 +222,45 @@ ApproximateReachabilityResult<ValueType> CompositionalValueIteration<ValueType>:
                 ValueType paretoUpperBound = paretoCurve.second.getLowerBound(task.getEntranceId(), task.isLeftEntrance(), task.getExitId(), task.isLeftExit());
 
                 gap = paretoUpperBound - paretoLowerBound;
+                stepUpperBound = paretoUpperBound;
 
                 if (gap < options.epsilon) {
                     lowerValue = paretoLowerBound;
                     upperValue = paretoUpperBound;
+                    this->stats.recordStep(currentStep, *lowerValue, upperValue);
 
                     break;
                 }
             } else {
+                auto checkStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
                 this->stats.terminationTime.start();
-                models::visitor::BottomUpTermination<ValueType> bottomUpVisitor(this->manager, this->stats, env, paretoCache);
-                root->accept(bottomUpVisitor);
-                auto result = bottomUpVisitor.getReachabilityResult(task, *root);
+                if (!bottomUpVisitor) {
+                    bottomUpVisitor = std::make_unique<models::visitor::BottomUpTermination<ValueType>>(this->manager, this->stats, env, paretoCache);
+                }
+                root->accept(*bottomUpVisitor);
+                auto result = bottomUpVisitor->getReachabilityResult(task, *root);
                 gap = result.getError();
                 this->stats.terminationTime.stop();
+                this->stats.recordPhase("bottom-up termination check", checkStart);
+                stepUpperBound = result.getUpperBound();
 
                 if (gap < options.epsilon) {
                     lowerValue = result.getLowerBound();
                     upperValue = result.getUpperBound();
+                    this->stats.recordStep(currentStep, *lowerValue, upperValue);
 
                     break;
                 }
             }
         }
+        this->stats.recordStep(currentStep, lowerBound.getValues()[0], stepUpperBound);
 
         ++currentStep;
     } while (!shouldTerminate());
 
-    storm::storage::ParetoCache<ValueType>& paretoCache = static_cast<storm::storage::ParetoCache<ValueType>&>(*cache);
-    this->stats.lowerParetoPoints = paretoCache.getLowerParetoPointCount();
+    collectParetoCacheStats();
+    collectPrecomputationStats();
+    storeParetoSetsToDisk();
 
     if (lowerValue && upperValue) {
         return ApproximateReachabilityResult<ValueType>(*lowerValue, *upperValue);
@@ -204,8 +273,6 @@ ApproximateReachabilityResult<ValueType> CompositionalValueIteration<ValueType>:
 
 template<typename ValueType>
 void CompositionalValueIteration<ValueType>::initialize(OpenMdpReachabilityTask const& task) {
-    initializeCache();
-
     this->stats.modelBuildingTime.start();
     this->manager->constructConcreteMdps();
     this->stats.modelBuildingTime.stop();
@@ -216,6 +283,10 @@ void CompositionalValueIteration<ValueType>::initialize(OpenMdpReachabilityTask
     root->accept(mappingVisitor);
     mappingVisitor.performPostProcessing();
     auto mapping = mappingVisitor.getMapping();
+    diagramLeaves = mapping.getLeaves();
+    leafOrigins = mappingVisitor.getLeafOrigins();
+    summaries.clear();
+    leafStability.clear();
 
     size_t lOuterExitCount = 0;
     size_t rOuterExitCount = 0;
@@ -229,29 +300,267 @@ void CompositionalValueIteration<ValueType>::initialize(OpenMdpReachabilityTask
     models::visitor::EntranceExitMappingVisitor<ValueType> entranceExitMappingVisitor;
     root->accept(entranceExitMappingVisitor);
 
-    auto finalWeight = task.toExitWeights<ValueType>(lOuterExitCount, rOuterExitCount);
+    finalWeight = task.toExitWeights<ValueType>(lOuterExitCount, rOuterExitCount);
 
     lowerBound = storage::ValueVector<ValueType>(mapping, finalWeight);
     lowerBound.initializeValues();
     upperBound = lowerBound;
+
+    // The Pareto curves are created for the leaves of the mapping, so the cache is built after it
+    initializeCache();
+}
+
+template<typename ValueType>
+void CompositionalValueIteration<ValueType>::seedParetoCache() {
+    if (options.paretoPrecomputationThreshold > 0) {
+        precomputeParetoSets();
+    }
+    loadParetoSetsFromDisk();
+}
+
+template<typename ValueType>
+void CompositionalValueIteration<ValueType>::loadParetoSetsFromDisk() {
+    auto diskCache = this->manager->getDiskCache();
+    storage::ParetoCache<ValueType>* paretoCache = dynamic_cast<storage::ParetoCache<ValueType>*>(&*cache);
+    if (!diskCache || !paretoCache) {
+        return;
+    }
+
+    std::set<models::ConcreteMdp<ValueType>*> uniqueLeaves(diagramLeaves.begin(), diagramLeaves.end());
+    this->stats.diskCacheParetoLoads = 0;
+    for (auto leaf : uniqueLeaves) {
+        auto paretoSet = diskCache->loadParetoSet(*leaf);
+        if (paretoSet) {
+            paretoCache->addPrecomputedParetoSet(leaf, *paretoSet);
+            ++this->stats.diskCacheParetoLoads;
+        }
+    }
+}
+
+template<typename ValueType>
+void CompositionalValueIteration<ValueType>::storeParetoSetsToDisk() {
+    auto diskCache = this->manager->getDiskCache();
+    storage::ParetoCache<ValueType>* paretoCache = dynamic_cast<storage::ParetoCache<ValueType>*>(&*cache);
+    if (!diskCache || !paretoCache) {
+        return;
+    }
+
+    // The cache also contains the bounds that were loaded, so the stored bounds accumulate over runs
+    std::set<models::ConcreteMdp<ValueType>*> uniqueLeaves(diagramLeaves.begin(), diagramLeaves.end());
+    for (auto leaf : uniqueLeaves) {
+        if (paretoCache->containsLeaf(leaf)) {
+            diskCache->storeParetoSet(*leaf, paretoCache->exportParetoSet(leaf));
+        }
+    }
+}
+
+template<typename ValueType>
+void CompositionalValueIteration<ValueType>::precomputeParetoSets() {
+    storm::Environment paretoEnv = env;
+    paretoEnv.modelchecker().multi().setMethod(storm::modelchecker::multiobjective::MultiObjectiveMethod::Pcaa);
+    paretoEnv.modelchecker().multi().setPrecision(storm::utility::convertNumber<storm::RationalNumber>(options.localOviEpsilon));
+    paretoEnv.modelchecker().multi().setPrecisionType(storm::MultiObjectiveModelCheckerEnvironment::PrecisionType::Absolute);
+    // The over-approximation answers the upper bound queries of OVI, so the weighted sums of PCAA have to be sound
+    paretoEnv.solver().setForceSoundness(true);
+
+    storage::ParetoCache<ValueType>* paretoCache = dynamic_cast<storage::ParetoCache<ValueType>*>(&*cache);
+    std::set<models::ConcreteMdp<ValueType>*> uniqueLeaves(diagramLeaves.begin(), diagramLeaves.end());
+    this->stats.paretoPrecomputedLeaves = 0;
+    for (auto leaf : uniqueLeaves) {
+        if (leaf->getMdp()->getNumberOfStates() > options.paretoPrecomputationThreshold) {
+            continue;
+        }
+
+        auto engine = leaf->getReachabilityEngine();
+        auto paretoSet = engine->getPrecomputedParetoSet();
+        if (!paretoSet) {
+            this->stats.paretoPrecomputationTime.start();
+            paretoSet = storage::PrecomputedParetoSet<ValueType>::compute(*leaf, paretoEnv);
+            this->stats.paretoPrecomputationTime.stop();
+            engine->setPrecomputedParetoSet(paretoSet);
+        }
+
+        // Queries of the Pareto cache need a scheduler and are not answered by the engine, seed the cache instead
+        if (paretoCache) {
+            paretoCache->addPrecomputedParetoSet(leaf, *paretoSet);
+        }
+        ++this->stats.paretoPrecomputedLeaves;
+    }
 }
 
 template<typename ValueType>
 void CompositionalValueIteration<ValueType>::initializeCache() {
     // Bottom-up apprach requires Pareto cache
-    STORM_LOG_THROW(!(options.useBottomUp && options.cacheMethod != PARETO_CACHE), storm::exceptions::NotSupportedException,
+    bool useParetoCache = options.cacheMethod == PARETO_CACHE || options.cacheMethod == PARETO_VERTEX_CACHE;
+    STORM_LOG_THROW(!(options.useBottomUp && !useParetoCache), storm::exceptions::NotSupportedException,
                     "Bottom-up termination requires Pareto cache");
 
     if (options.cacheMethod == NO_CACHE) {
         cache = std::make_shared<storm::storage::NoCache<ValueType>>();
     } else if (options.cacheMethod == EXACT_CACHE) {
-        cache = std::make_shared<storm::storage::ExactCache<ValueType>>(options.localOviEpsilon);
-    } else if (options.cacheMethod == PARETO_CACHE) {
-        auto paretoCache = std::make_shared<storm::storage::ParetoCache<ValueType>>();
+        cache = std::make_shared<storm::storage::ExactCache<ValueType>>(options.localOviEpsilon, options.useLipschitzBounds);
+    } else if (useParetoCache) {
+        auto paretoCache = std::make_shared<storm::storage::ParetoCache<ValueType>>(getParetoCacheOptions());
         paretoCache->setErrorTolerance(options.cacheErrorTolerance);
-        paretoCache->initializeParetoCurves(lowerBound.getMapping().getLeaves());
+        paretoCache->initializeParetoCurves(diagramLeaves);
+        if (options.cacheContentionThreads > 0) {
+            cacheQueryTrace = std::make_shared<compose::benchmark::CacheQueryTrace<ValueType>>();
+            paretoCache->setQueryTrace(cacheQueryTrace);
+        }
         cache = std::move(paretoCache);
     }
+    STORM_LOG_WARN_COND(options.cacheContentionThreads == 0 || useParetoCache,
+                        "Cache contention benchmark is only supported for the Pareto cache");
+}
+
+template<typename ValueType>
+typename storm::storage::ParetoCache<ValueType>::Options CompositionalValueIteration<ValueType>::getParetoCacheOptions() const {
+    typename storm::storage::ParetoCache<ValueType>::Options cacheOptions;
+    cacheOptions.floatingPointFastPath = !options.exactParetoCache;
+    cacheOptions.vertexUpperBounds = options.cacheMethod == PARETO_VERTEX_CACHE;
+    cacheOptions.lipschitzBounds = options.useLipschitzBounds;
+    cacheOptions.pruneBounds = options.pruneParetoBounds;
+    cacheOptions.entranceBudget = options.paretoEntranceBudget;
+    // The leaves are solved by OVI with this precision, both in the value iteration and in the OVI termination check
+    cacheOptions.solverPrecision = storm::utility::convertNumber<double>(options.localOviEpsilon);
+    return cacheOptions;
+}
+
+template<typename ValueType>
+void CompositionalValueIteration<ValueType>::collectParetoCacheStats() {
+    storage::ParetoCache<ValueType>* paretoCache = dynamic_cast<storage::ParetoCache<ValueType>*>(&*cache);
+    if (paretoCache) {
+        this->stats.lowerParetoPoints = paretoCache->getLowerParetoPointCount();
+        this->stats.upperParetoPoints = paretoCache->getUpperParetoPointCount();
+
+        auto pruningStats = paretoCache->getPruningStatistics();
+        this->stats.paretoPrunedPoints = pruningStats.prunedPoints;
+        this->stats.paretoRedundantHalfspaces = pruningStats.redundantHalfspaces;
+        this->stats.paretoEvictedPoints = pruningStats.evictedPoints;
+        this->stats.paretoEvictedHalfspaces = pruningStats.evictedHalfspaces;
+
+        auto arithmeticStats = paretoCache->getArithmeticStatistics();
+        this->stats.paretoFloatTime = arithmeticStats.floatTime;
+        this->stats.paretoExactTime = arithmeticStats.exactTime;
+        this->stats.paretoFloatUpperBounds = arithmeticStats.floatUpperBounds;
+        this->stats.paretoExactUpperBounds = arithmeticStats.exactUpperBounds;
+        this->stats.paretoLipschitzUpperBounds = arithmeticStats.lipschitzUpperBounds;
+
+        // Profiles are keyed by the names of the leaves of the diagram and of the subtree summaries
+        auto setParetoPoints = [&](models::ConcreteMdp<ValueType>* leaf) {
+            auto profile = this->stats.leafProfiles.find(leaf->getName());
+            if (profile != this->stats.leafProfiles.end()) {
+                profile->second.paretoPoints = paretoCache->getLowerParetoPointCount(leaf);
+            }
+        };
+        for (auto leaf : diagramLeaves) {
+            setParetoPoints(leaf);
+        }
+        for (auto const& summary : summaries) {
+            setParetoPoints(summary.second->mdp.get());
+        }
+    }
+}
+
+template<typename ValueType>
+void CompositionalValueIteration<ValueType>::collectPrecomputationStats() {
+    if (options.paretoPrecomputationThreshold == 0) {
+        return;
+    }
+
+    this->stats.paretoPrecomputedQueryTime = storm::utility::Stopwatch();
+    std::set<models::ConcreteMdp<ValueType>*> uniqueLeaves(diagramLeaves.begin(), diagramLeaves.end());
+    for (auto leaf : uniqueLeaves) {
+        this->stats.paretoPrecomputedQueryTime.add(leaf->getReachabilityEngine()->getPrecomputedQueryTime());
+    }
+}
+
+template<typename ValueType>
+bool CompositionalValueIteration<ValueType>::summarizeStableSubtrees() {
+    storm::storage::ParetoCache<ValueType>& paretoCache = static_cast<storm::storage::ParetoCache<ValueType>&>(*cache);
+
+    // Leaves in summarized subtrees are no longer iterated, so they stay stable
+    auto& mapping = lowerBound.getMapping();
+    std::set<models::ConcreteMdp<ValueType>*> uniqueLeaves(mapping.getLeaves().begin(), mapping.getLeaves().end());
+    for (auto leaf : uniqueLeaves) {
+        uint64_t version = paretoCache.getVersion(leaf);
+        auto& stability = leafStability[leaf];
+        if (stability.first == version) {
+            ++stability.second;
+        } else {
+            stability = {version, 0};
+        }
+    }
+
+    auto isStable = [this](models::ConcreteMdp<ValueType>* leaf) {
+        auto stability = leafStability.find(leaf);
+        return stability != leafStability.end() && stability->second.first != 0 && stability->second.second >= options.subtreeSummarySweeps;
+    };
+    models::visitor::SubtreeSummaryVisitor<ValueType> summaryVisitor(this->manager, paretoCache, isStable, summaries);
+    this->manager->getRoot()->accept(summaryVisitor);
+    auto const& newSummaries = summaryVisitor.getSummaries();
+
+    bool changed = newSummaries.size() != summaries.size();
+    for (auto const& summary : newSummaries) {
+        changed |= summaries.count(summary.first) == 0;
+    }
+    if (!changed) {
+        return false;
+    }
+
+    models::visitor::MappingVisitor<ValueType> mappingVisitor(newSummaries);
+    this->manager->getRoot()->accept(mappingVisitor);
+    mappingVisitor.performPostProcessing();
+    auto newLeafOrigins = mappingVisitor.getLeafOrigins();
+    storage::ValueVector<ValueType> newLowerBound(mappingVisitor.getMapping(), finalWeight);
+    newLowerBound.initializeValues();
+
+    // Values of positions that are still present are kept, the other ones start from zero
+    auto& newMapping = newLowerBound.getMapping();
+    for (size_t leafId = 0; leafId < newMapping.getLeafCount(); ++leafId) {
+        for (auto const& entry : newMapping.getModelMapping(leafId)) {
+            auto diagramPosition = toDiagramPosition<ValueType>(newLeafOrigins[leafId], entry.first);
+            auto oldIndex = lookupDiagramPosition<ValueType>(mapping, leafOrigins, diagramPosition);
+            if (oldIndex) {
+                newLowerBound.getValues()[entry.second] = lowerBound.getValues()[*oldIndex];
+            }
+        }
+    }
+
+    std::vector<models::ConcreteMdp<ValueType>*> newLeaves;
+    this->stats.summarizedLeaves = 0;
+    for (auto const& summary : newSummaries) {
+        if (!paretoCache.containsLeaf(summary.second->mdp.get())) {
+            newLeaves.push_back(summary.second->mdp.get());
+        }
+        this->stats.summarizedLeaves += summary.second->leafCount;
+    }
+    paretoCache.initializeParetoCurves(newLeaves);
+    this->stats.summarizedSubtrees = newSummaries.size();
+
+    lowerBound = std::move(newLowerBound);
+    leafOrigins = std::move(newLeafOrigins);
+    summaries = newSummaries;
+    return true;
+}
+
+template<typename ValueType>
+void CompositionalValueIteration<ValueType>::runCacheContentionBenchmark() {
+    std::cout << "Replaying " << cacheQueryTrace->size() << " cache operations with up to " << options.cacheContentionThreads << " threads" << std::endl;
+
+    // The replay is not part of the actual computation
+    this->stats.totalTime.stop();
+    std::vector<models::ConcreteMdp<ValueType>*> leaves(diagramLeaves);
+    for (auto const& summary : summaries) {
+        leaves.push_back(summary.second->mdp.get());
+    }
+    compose::benchmark::CacheContentionBenchmark<ValueType> benchmark(cacheQueryTrace, leaves, options.cacheErrorTolerance, getParetoCacheOptions());
+    this->stats.cacheContentionTimes.clear();
+    for (auto const& result : benchmark.run(options.cacheContentionThreads)) {
+        std::cout << "  " << result.threadCount << " thread(s): " << result.time << "s" << std::endl;
+        this->stats.cacheContentionTimes.push_back(result.time);
+    }
+    this->stats.totalTime.start();
 }
 
 template<typename ValueType>
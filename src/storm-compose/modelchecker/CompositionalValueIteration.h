@@ -1,10 +1,15 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "AbstractOpenMdpChecker.h"
 #include "storm-compose/benchmark/BenchmarkStats.h"
+#include "storm-compose/benchmark/CacheQueryTrace.h"
 #include "storm-compose/models/visitor/CVIVisitor.h"
 #include "storm-compose/models/visitor/EntranceExitMappingVisitor.h"
 #include "storm-compose/models/visitor/EntranceExitVisitor.h"
+#include "storm-compose/models/visitor/MappingVisitor.h"
+#include "storm-compose/models/visitor/SubtreeSummaryVisitor.h"
 #include "storm-compose/storage/AbstractCache.h"
 #include "storm-compose/storage/ParetoCache.h"
 #include "storm-compose/storage/ValueVector.h"
@@ -28,6 +33,7 @@ enum CacheMethod {
     NO_CACHE,
     EXACT_CACHE,
     PARETO_CACHE,
+    PARETO_VERTEX_CACHE,  // Pareto cache with upper bounds in vertex representation
 };
 
 template<typename ValueType>
@@ -48,6 +54,15 @@ class CompositionalValueIteration : public AbstractOpenMdpChecker<ValueType> {
         std::string iterationOrder = "backward";
         ValueType localOviEpsilon = 1e-4;
         bool useRecursiveParetoComputation = false;
+        size_t threadCount = 0;
+        bool exactParetoCache = false;  // Disables the floating point fast path of the Pareto cache
+        bool useLipschitzBounds = false;  // Derive cache bounds from the closest previously seen weight
+        bool pruneParetoBounds = true;  // Remove Pareto cache points and halfspaces that do not change a bound
+        size_t paretoEntranceBudget = 0;  // Maximum number of Pareto cache points and halfspaces per entrance (0 = unlimited)
+        size_t cacheContentionThreads = 0;  // If > 0, the Pareto cache operations are recorded and replayed with 1..n threads after the check
+        size_t paretoPrecomputationThreshold = 0;  // Leaves with at most this many states get their Pareto set precomputed (0 = disabled)
+        // Subtrees whose leaves kept their Pareto bounds for this many sweeps are iterated as a single leaf (0 = disabled, bottom-up only)
+        size_t subtreeSummarySweeps = 0;
     };
 
     CompositionalValueIteration(std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager, storm::compose::benchmark::BenchmarkStats<ValueType>& stats,
@@ -58,10 +73,20 @@ class CompositionalValueIteration : public AbstractOpenMdpChecker<ValueType> {
    private:
     void initialize(OpenMdpReachabilityTask const& task);
     void initializeCache();
+    // Adds the precomputed and the stored Pareto sets to the cache
+    void seedParetoCache();
+    void precomputeParetoSets();
+    void loadParetoSetsFromDisk();
+    void storeParetoSetsToDisk();
     bool shouldTerminate();
     bool shouldCheckOVITermination();
     bool shouldCheckBottomUpTermination();
     bool isUpperbound(std::vector<ValueType> valueVector);
+    void runCacheContentionBenchmark();
+    void collectParetoCacheStats();
+    void collectPrecomputationStats();
+    bool summarizeStableSubtrees();
+    typename storm::storage::ParetoCache<ValueType>::Options getParetoCacheOptions() const;
 
     ApproximateReachabilityResult<ValueType> checkOvi(OpenMdpReachabilityTask task);
     ApproximateReachabilityResult<ValueType> checkBottomUp(OpenMdpReachabilityTask task);
@@ -69,7 +94,16 @@ class CompositionalValueIteration : public AbstractOpenMdpChecker<ValueType> {
     size_t currentStep = 0;
     Options options;
     storage::ValueVector<ValueType> lowerBound, upperBound;
+    std::vector<ValueType> finalWeight;
+    // Leaves of the diagram, including the ones in summarized subtrees
+    std::vector<models::ConcreteMdp<ValueType>*> diagramLeaves;
+
+    typename models::visitor::SubtreeSummaryVisitor<ValueType>::SummaryMap summaries;
+    std::vector<typename models::visitor::MappingVisitor<ValueType>::LeafOrigin> leafOrigins;
+    // Cache version of the bounds of each leaf and the number of sweeps since it changed
+    std::unordered_map<models::ConcreteMdp<ValueType>*, std::pair<uint64_t, size_t>> leafStability;
     std::shared_ptr<storm::storage::AbstractCache<ValueType>> cache;
+    std::shared_ptr<compose::benchmark::CacheQueryTrace<ValueType>> cacheQueryTrace;
     // std::shared_ptr<storm::storage::ParetoCache<ValueType>> cache;
     storm::Environment env;
 };
@@ -1,4 +1,6 @@
 #include "HeuristicValueIterator.h"
+#include <algorithm>
+#include <numeric>
 #include "exceptions/NotSupportedException.h"
 #include "exceptions/OutOfRangeException.h"
 #include "solver/SolverSelectionOptions.h"
@@ -14,6 +16,11 @@
 namespace storm {
 namespace modelchecker {
 
+namespace {
+// Lower bound of the estimated ratio between the entrance and exit weight changes of a leaf in the prioritized order
+const double MIN_SENSITIVITY = 1e-3;
+}  // namespace
+
 template<typename ValueType>
 HeuristicValueIterator<ValueType>::HeuristicValueIterator(Options options, std::shared_ptr<models::OpenMdpManager<ValueType>> manager,
                                                           storage::ValueVector<ValueType>& valueVector,
@@ -26,6 +33,32 @@ HeuristicValueIterator<ValueType>::HeuristicValueIterator(Options options, std::
 
     if (options.iterationOrder == Options::HEURISTIC) {
         initializeLeafScores();
+    } else if (options.iterationOrder == Options::PRIORITIZED) {
+        initializeLeafPriorities();
+    }
+
+    if (isParallelOrder(options.iterationOrder)) {
+        threadPool = std::make_unique<compose::utility::ThreadPool>(options.threadCount);
+        allLeaves.resize(mapping.getLeafCount());
+        std::iota(allLeaves.begin(), allLeaves.end(), 0);
+    }
+
+    if (options.iterationOrder == Options::TOPOLOGICAL) {
+        leafComponents = mapping.computeLeafComponents();
+        initializeDependentComponents();
+    } else if (options.iterationOrder == Options::FORWARD || options.iterationOrder == Options::BACKWARD) {
+        auto components = mapping.computeLeafComponents();
+        size_t cyclicCount = std::count_if(components.begin(), components.end(), [](auto const& component) { return component.cyclic; });
+        if (cyclicCount > 0) {
+            STORM_LOG_INFO("Iterating " << cyclicCount << " cyclic leaf component(s) to a local fixpoint");
+            leafComponents = std::move(components);
+        }
+    }
+
+    if (options.iterationOrder == Options::PARALLEL_JACOBI) {
+        previousValueVector = valueVector;
+    } else if (options.iterationOrder == Options::PARALLEL_GAUSS_SEIDEL) {
+        initializeLeafColoring();
     }
 }
 
@@ -33,7 +66,34 @@ template<typename ValueType>
 void HeuristicValueIterator<ValueType>::performIteration() {
     const auto& leaves = mapping.getLeaves();
 
-    if (options.iterationOrder == Options::FORWARD) {
+    if (options.iterationOrder == Options::TOPOLOGICAL) {
+        // Start over with all components once no component is pending, the cache may give better results for the same weights by now
+        if (std::none_of(pendingComponents.begin(), pendingComponents.end(), [](bool pending) { return pending; })) {
+            pendingComponents.assign(leafComponents.size(), true);
+        }
+
+        // Components that depend on a component come after it, so changes are propagated within the same sweep
+        for (size_t i = 0; i < leafComponents.size(); ++i) {
+            if (!pendingComponents[i]) {
+                continue;
+            }
+            bool converged;
+            bool changed = updateComponent(leafComponents[i], true, converged);
+            pendingComponents[i] = !converged;
+            if (changed) {
+                for (size_t dependent : dependentComponents[i]) {
+                    pendingComponents[dependent] = true;
+                }
+            }
+        }
+    } else if (!leafComponents.empty()) {
+        // Leaves on a trace cycle are iterated until their weights are stable, and only then the leaves that read them are updated
+        bool backward = options.iterationOrder == Options::BACKWARD;
+        bool converged;
+        for (size_t i = 0; i < leafComponents.size(); ++i) {
+            updateComponent(leafComponents[backward ? i : leafComponents.size() - 1 - i], backward, converged);
+        }
+    } else if (options.iterationOrder == Options::FORWARD) {
         for (size_t leaf = 0; leaf < leaves.size(); ++leaf) {
             updateModel(leaf);
         }
@@ -46,6 +106,53 @@ void HeuristicValueIterator<ValueType>::performIteration() {
             size_t leaf = getNextLeaf();
             updateModel(leaf);
         }
+    } else if (options.iterationOrder == Options::PRIORITIZED) {
+        // Gauss-Southwell: as many updates as a sweep, always on the leaf whose entrance weights are expected to change the most
+        for (size_t step = 0; step < leaves.size(); ++step) {
+            size_t leaf = leafPriorities->top();
+            if (leafPriorities->getPriority(leaf) <= storm::utility::zero<ValueType>()) {
+                // As in the topological order, start over with all leaves once no change is pending, the cache may give better results for the
+                // same weights by now
+                restartLeafPriorities();
+                leaf = leafPriorities->top();
+            }
+            updatePrioritizedModel(leaf);
+        }
+    } else if (options.iterationOrder == Options::PARALLEL_JACOBI) {
+        // Every leaf reads the weights of the previous sweep, so all leaves can be updated at the same time.
+        previousValueVector.getValues() = valueVector.getValues();
+        updateModelsInParallel(allLeaves, previousValueVector);
+    } else if (options.iterationOrder == Options::PARALLEL_GAUSS_SEIDEL) {
+        // Leaves of the same color do not read each others weights, so they can be updated at the same time.
+        for (const auto& leafIds : leafColoring) {
+            updateModelsInParallel(leafIds, valueVector);
+        }
+    }
+}
+
+template<typename ValueType>
+void HeuristicValueIterator<ValueType>::updateModelsInParallel(std::vector<size_t> const& leafIds, storage::ValueVector<ValueType>& source) {
+    // Each worker collects its own statistics, which are merged afterwards.
+    std::vector<compose::benchmark::BenchmarkStats<ValueType>> workerStats(threadPool->getThreadCount());
+    for (size_t workerId = 0; workerId < workerStats.size(); ++workerId) {
+        workerStats[workerId].recordTraceEvents = stats.recordTraceEvents;
+        workerStats[workerId].threadId = workerId + 1;
+    }
+    workerWeights.resize(threadPool->getThreadCount());
+
+    threadPool->parallelFor(leafIds.size(), [&](size_t index, size_t workerId) {
+        size_t leafId = leafIds[index];
+        WeightType& weights = workerWeights[workerId];
+        source.getOutputWeights(leafId, weights);
+        WeightType inputWeights = performStep(leafId, weights, workerStats[workerId]);
+        ++workerStats[workerId].leafUpdates[mapping.getLeaves()[leafId]->getName()];
+
+        // Leaves write to disjoint entrance positions, so no synchronization is needed here.
+        storeInputWeights(leafId, inputWeights);
+    });
+
+    for (const auto& s : workerStats) {
+        stats.mergeQueryStats(s);
     }
 }
 
@@ -57,14 +164,28 @@ typename HeuristicValueIterator<ValueType>::Options::IterationOrder HeuristicVal
         return Options::IterationOrder::BACKWARD;
     else if (string == "heuristic")
         return Options::IterationOrder::HEURISTIC;
+    else if (string == "parallel-jacobi")
+        return Options::IterationOrder::PARALLEL_JACOBI;
+    else if (string == "parallel-gauss-seidel")
+        return Options::IterationOrder::PARALLEL_GAUSS_SEIDEL;
+    else if (string == "topological")
+        return Options::IterationOrder::TOPOLOGICAL;
+    else if (string == "prioritized")
+        return Options::IterationOrder::PRIORITIZED;
     else
         STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Unknown iteration order " << string);
 }
 
+template<typename ValueType>
+bool HeuristicValueIterator<ValueType>::isParallelOrder(typename Options::IterationOrder order) {
+    return order == Options::PARALLEL_JACOBI || order == Options::PARALLEL_GAUSS_SEIDEL;
+}
+
 template<typename ValueType>
 void HeuristicValueIterator<ValueType>::updateModel(size_t leafId) {
-    WeightType weights = valueVector.getOutputWeights(leafId);
-    WeightType inputWeights = performStep(leafId, weights);
+    valueVector.getOutputWeights(leafId, outputWeights);
+    WeightType inputWeights = performStep(leafId, outputWeights, stats);
+    ++stats.leafUpdates[mapping.getLeaves()[leafId]->getName()];
 
     if (options.iterationOrder == Options::HEURISTIC) {
         updateLeafScores(inputWeights, leafId);
@@ -73,26 +194,130 @@ void HeuristicValueIterator<ValueType>::updateModel(size_t leafId) {
 }
 
 template<typename ValueType>
-void HeuristicValueIterator<ValueType>::storeInputWeights(size_t leafId, WeightType const& inputWeights) {
-    models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
-    size_t weightIndex = 0;
-    for (size_t i = 0; i < model->getLEntrance().size(); ++i) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::L_ENTRANCE, i};
-        valueVector.setWeight(leafId, pos, inputWeights[weightIndex]);
+bool HeuristicValueIterator<ValueType>::updateComponent(LeafComponent const& component, bool backward, bool& converged) {
+    // Acyclic components are updated once, cyclic ones are swept until the entrance weights of their leaves are stable
+    auto const& leafIds = component.leaves;
+    size_t sweeps = component.cyclic ? options.maxComponentSweeps : 1;
+    bool changed = false;
+    converged = !component.cyclic;
+    for (size_t sweep = 0; sweep < sweeps; ++sweep) {
+        ValueType maxChange = storm::utility::zero<ValueType>();
+        for (size_t i = 0; i < leafIds.size(); ++i) {
+            size_t leafId = leafIds[backward ? leafIds.size() - 1 - i : i];
+            valueVector.getInputWeights(leafId, previousInputWeights);
+            updateModel(leafId);
+            valueVector.getInputWeights(leafId, currentInputWeights);
+            maxChange = std::max(maxChange, storm::utility::vector::maximumElementDiff<ValueType>(previousInputWeights, currentInputWeights));
+        }
+        changed |= maxChange > storm::utility::zero<ValueType>();
+        if (component.cyclic && maxChange < options.localOviEpsilon) {
+            converged = true;
+            break;
+        }
+    }
+    return changed;
+}
+
+template<typename ValueType>
+void HeuristicValueIterator<ValueType>::initializeDependentComponents() {
+    std::vector<size_t> componentIds(mapping.getLeafCount());
+    for (size_t component = 0; component < leafComponents.size(); ++component) {
+        for (size_t leafId : leafComponents[component].leaves) {
+            componentIds[leafId] = component;
+        }
+    }
+
+    // A component depends on the components that write the weights of its exits
+    std::vector<std::set<size_t>> dependents(leafComponents.size());
+    for (size_t leafId = 0; leafId < mapping.getLeafCount(); ++leafId) {
+        models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
+        auto processEntrances = [&](size_t entranceCount, storage::EntranceExit entranceExit) {
+            for (size_t i = 0; i < entranceCount; ++i) {
+                auto connectedLeaf = mapping.getConnectedLeafId(leafId, {entranceExit, i});
+                if (connectedLeaf && componentIds[*connectedLeaf] != componentIds[leafId]) {
+                    dependents[componentIds[leafId]].insert(componentIds[*connectedLeaf]);
+                }
+            }
+        };
+        processEntrances(model->getLEntranceCount(), storage::L_ENTRANCE);
+        processEntrances(model->getREntranceCount(), storage::R_ENTRANCE);
+    }
+
+    dependentComponents.clear();
+    for (auto const& componentDependents : dependents) {
+        dependentComponents.emplace_back(componentDependents.begin(), componentDependents.end());
+    }
+    pendingComponents.assign(leafComponents.size(), true);
+
+    size_t cyclicCount = std::count_if(leafComponents.begin(), leafComponents.end(), [](auto const& component) { return component.cyclic; });
+    STORM_LOG_INFO("Partitioned " << mapping.getLeafCount() << " leaves into " << leafComponents.size() << " components, " << cyclicCount << " of them cyclic");
+}
 
-        ++weightIndex;
+template<typename ValueType>
+void HeuristicValueIterator<ValueType>::initializeLeafPriorities() {
+    // All weights start at zero except the ones of the outer exits
+    size_t leafCount = mapping.getLeafCount();
+    leafPriorities = std::make_unique<compose::utility::IndexedPriorityQueue<ValueType>>(leafCount, storm::utility::zero<ValueType>());
+    pendingExitChanges.assign(leafCount, storm::utility::zero<ValueType>());
+    leafSensitivities.assign(leafCount, storm::utility::one<ValueType>());
+    for (size_t leafId = 0; leafId < leafCount; ++leafId) {
+        valueVector.getOutputWeights(leafId, outputWeights);
+        for (auto const& weight : outputWeights) {
+            pendingExitChanges[leafId] = storm::utility::max<ValueType>(pendingExitChanges[leafId], weight);
+        }
+        leafPriorities->setPriority(leafId, pendingExitChanges[leafId]);
     }
+}
 
-    for (size_t i = 0; i < model->getREntrance().size(); ++i) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::R_ENTRANCE, i};
-        valueVector.setWeight(leafId, pos, inputWeights[weightIndex]);
+template<typename ValueType>
+void HeuristicValueIterator<ValueType>::restartLeafPriorities() {
+    // No exit weight change is pending, so the sensitivities are not updated by these updates. They only order the leaves.
+    for (size_t leafId = 0; leafId < mapping.getLeafCount(); ++leafId) {
+        leafPriorities->setPriority(leafId, leafSensitivities[leafId]);
+    }
+}
 
-        ++weightIndex;
+template<typename ValueType>
+void HeuristicValueIterator<ValueType>::updatePrioritizedModel(size_t leafId) {
+    valueVector.getInputWeights(leafId, previousInputWeights);
+    updateModel(leafId);
+    valueVector.getInputWeights(leafId, currentInputWeights);
+
+    // The sensitivity is kept above zero, so a leaf whose exit weights change is updated eventually
+    ValueType const minSensitivity = storm::utility::convertNumber<ValueType>(MIN_SENSITIVITY);
+    if (pendingExitChanges[leafId] > storm::utility::zero<ValueType>()) {
+        ValueType inputChange = storm::utility::vector::maximumElementDiff<ValueType>(previousInputWeights, currentInputWeights);
+        ValueType sensitivity = storm::utility::min<ValueType>(inputChange / pendingExitChanges[leafId], storm::utility::one<ValueType>());
+        leafSensitivities[leafId] = storm::utility::max<ValueType>(minSensitivity, sensitivity);
     }
+    pendingExitChanges[leafId] = storm::utility::zero<ValueType>();
+    leafPriorities->setPriority(leafId, storm::utility::zero<ValueType>());
+
+    // Leaves that read the entrance weights as exit weights are expected to change proportionally
+    models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
+    size_t weightIndex = 0;
+    auto processEntrances = [&](size_t entranceCount, storage::EntranceExit entranceExit) {
+        for (size_t i = 0; i < entranceCount; ++i, ++weightIndex) {
+            ValueType change = storm::utility::abs<ValueType>(currentInputWeights[weightIndex] - previousInputWeights[weightIndex]);
+            auto connectedLeaf = mapping.getConnectedLeafId(leafId, {entranceExit, i});
+            if (connectedLeaf && change > storm::utility::zero<ValueType>()) {
+                pendingExitChanges[*connectedLeaf] += change;
+                leafPriorities->setPriority(*connectedLeaf, pendingExitChanges[*connectedLeaf] * leafSensitivities[*connectedLeaf]);
+            }
+        }
+    };
+    processEntrances(model->getLEntranceCount(), storage::L_ENTRANCE);
+    processEntrances(model->getREntranceCount(), storage::R_ENTRANCE);
 }
 
 template<typename ValueType>
-typename HeuristicValueIterator<ValueType>::WeightType HeuristicValueIterator<ValueType>::performStep(size_t leafId, WeightType const& weights) {
+void HeuristicValueIterator<ValueType>::storeInputWeights(size_t leafId, WeightType const& inputWeights) {
+    valueVector.setInputWeights(leafId, inputWeights);
+}
+
+template<typename ValueType>
+typename HeuristicValueIterator<ValueType>::WeightType HeuristicValueIterator<ValueType>::performStep(size_t leafId, WeightType const& weights,
+                                                                                                     compose::benchmark::BenchmarkStats<ValueType>& stepStats) {
     models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
 
     // std::cout << std::endl;
@@ -105,10 +330,11 @@ typename HeuristicValueIterator<ValueType>::WeightType HeuristicValueIterator<Va
     if (allZero) {
         inputWeights = std::vector<ValueType>(model->getEntranceCount(), 0);
     } else {
+        auto& leafProfile = stepStats.getLeafProfile(*model);
         boost::optional<std::vector<ValueType>> lbResult, ubResult;
 
-        lbResult = queryCacheLowerBound(model, weights);
-        ubResult = queryCacheUpperBound(model, weights);
+        lbResult = queryCacheLowerBound(model, weights, stepStats);
+        ubResult = queryCacheUpperBound(model, weights, stepStats);
 
         // std::cout << "LB from cache: " << storm::utility::vector::toString(*lbResult) << std::endl;
         // if (ubResult) {
@@ -120,10 +346,11 @@ typename HeuristicValueIterator<ValueType>::WeightType HeuristicValueIterator<Va
             ValueType gap = storm::utility::vector::maximumElementDiff<ValueType>(*lbResult, *ubResult);
             // std::cout << "gap: " << gap << std::endl;
 
-            ++stats.weightedReachabilityQueries;
+            ++stepStats.weightedReachabilityQueries;
             if (gap < options.cacheErrorTolerance) {
                 cacheUsed = true;
-                stats.cacheHits++;
+                stepStats.cacheHits++;
+                ++leafProfile.cacheHits;
                 inputWeights = *lbResult;
             }
         }
@@ -157,16 +384,19 @@ typename HeuristicValueIterator<ValueType>::WeightType HeuristicValueIterator<Va
         //}
 
         if (!cacheUsed) {
-            stats.reachabilityComputationTime.start();
+            ++leafProfile.cacheMisses;
+            auto solveStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
+            stepStats.reachabilityComputationTime.start();
             auto newResult = models::visitor::CVIVisitor<ValueType>::weightedReachability(weights, *model, cache->needScheduler(), env);
-            stats.reachabilityComputationTime.stop();
+            stepStats.reachabilityComputationTime.stop();
+            stepStats.recordSolve(leafProfile, solveStart);
             auto weight = newResult.first;
             auto scheduler = newResult.second;
 
             // std::cout << "inserting value " << storm::utility::vector::toString<ValueType>(weight) << std::endl;
 
             inputWeights = weight;
-            addToCache(model, weights, inputWeights, scheduler);
+            addToCache(model, weights, inputWeights, stepStats, scheduler);
         }
     }
 
@@ -262,32 +492,103 @@ void HeuristicValueIterator<ValueType>::updateLeafScores(WeightType const& input
     }
 }
 
+template<typename ValueType>
+std::vector<std::set<size_t>> HeuristicValueIterator<ValueType>::computeLeafDependencies() {
+    // Two leaves depend on each other if one of them writes an entrance weight that the other one reads as exit weight.
+    size_t leafCount = mapping.getLeafCount();
+    std::vector<std::set<size_t>> dependencies(leafCount);
+
+    for (size_t leafId = 0; leafId < leafCount; ++leafId) {
+        models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
+
+        auto processEntrances = [&](size_t entranceCount, storage::EntranceExit entranceExit) {
+            for (size_t i = 0; i < entranceCount; ++i) {
+                auto connectedLeaf = mapping.getConnectedLeafId(leafId, {entranceExit, i});
+                if (connectedLeaf && *connectedLeaf != leafId) {
+                    dependencies[leafId].insert(*connectedLeaf);
+                    dependencies[*connectedLeaf].insert(leafId);
+                }
+            }
+        };
+        processEntrances(model->getLEntranceCount(), storage::L_ENTRANCE);
+        processEntrances(model->getREntranceCount(), storage::R_ENTRANCE);
+    }
+
+    return dependencies;
+}
+
+template<typename ValueType>
+void HeuristicValueIterator<ValueType>::initializeLeafColoring() {
+    // Greedy coloring of the dependency graph. Leaves are colored back to front so that the
+    // colors are processed roughly in the order of a backward sweep.
+    auto dependencies = computeLeafDependencies();
+    size_t leafCount = mapping.getLeafCount();
+    std::vector<size_t> colors(leafCount);
+
+    leafColoring.clear();
+    for (size_t leafId = leafCount; leafId-- > 0;) {
+        std::set<size_t> neighbourColors;
+        for (size_t neighbour : dependencies[leafId]) {
+            if (neighbour > leafId) {
+                neighbourColors.insert(colors[neighbour]);
+            }
+        }
+
+        size_t color = 0;
+        while (neighbourColors.count(color) > 0) {
+            ++color;
+        }
+
+        colors[leafId] = color;
+        if (color >= leafColoring.size()) {
+            leafColoring.resize(color + 1);
+        }
+        leafColoring[color].push_back(leafId);
+    }
+
+    STORM_LOG_INFO("Partitioned " << leafCount << " leaves into " << leafColoring.size() << " independent sets");
+}
+
+template<typename ValueType>
+std::unique_lock<std::mutex> HeuristicValueIterator<ValueType>::lockCacheIfNeeded() {
+    // Thread-safe caches synchronize internally, so concurrent workers only serialize on caches that are not
+    std::unique_lock<std::mutex> lock(cacheMutex, std::defer_lock);
+    if (!cache->isThreadSafe()) {
+        lock.lock();
+    }
+    return lock;
+}
+
 template<typename ValueType>
 boost::optional<typename HeuristicValueIterator<ValueType>::WeightType> HeuristicValueIterator<ValueType>::queryCacheLowerBound(
-    models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight) {
-    stats.cacheRetrievalTime.start();
+    models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight, compose::benchmark::BenchmarkStats<ValueType>& stepStats) {
+    auto lock = lockCacheIfNeeded();
+    stepStats.cacheRetrievalTime.start();
     auto result = cache->getLowerBound(ptr, outputWeight);
-    stats.cacheRetrievalTime.stop();
+    stepStats.cacheRetrievalTime.stop();
 
     return result;
 }
 
 template<typename ValueType>
 boost::optional<typename HeuristicValueIterator<ValueType>::WeightType> HeuristicValueIterator<ValueType>::queryCacheUpperBound(
-    models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight) {
-    stats.cacheRetrievalTime.start();
+    models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight, compose::benchmark::BenchmarkStats<ValueType>& stepStats) {
+    auto lock = lockCacheIfNeeded();
+    stepStats.cacheRetrievalTime.start();
     auto result = cache->getUpperBound(ptr, outputWeight);
-    stats.cacheRetrievalTime.stop();
+    stepStats.cacheRetrievalTime.stop();
 
     return result;
 }
 
 template<typename ValueType>
 void HeuristicValueIterator<ValueType>::addToCache(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight, WeightType inputWeight,
+                                                   compose::benchmark::BenchmarkStats<ValueType>& stepStats,
                                                    boost::optional<storm::storage::Scheduler<ValueType>> sched) {
-    stats.cacheInsertionTime.start();
+    auto lock = lockCacheIfNeeded();
+    stepStats.cacheInsertionTime.start();
     cache->addToCache(ptr, outputWeight, inputWeight, sched);
-    stats.cacheInsertionTime.stop();
+    stepStats.cacheInsertionTime.stop();
 }
 
 template class HeuristicValueIterator<double>;
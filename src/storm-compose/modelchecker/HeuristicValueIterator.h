@@ -1,12 +1,17 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <set>
 
 #include "storm-compose/benchmark/BenchmarkStats.h"
 #include "storm-compose/modelchecker/CompositionalValueIteration.h"
 #include "storm-compose/models/ConcreteMdp.h"
 #include "storm-compose/storage/AbstractCache.h"
 #include "storm-compose/storage/ValueVectorMapping.h"
+#include "storm-compose/utility/IndexedPriorityQueue.h"
+#include "storm-compose/utility/ThreadPool.h"
 #include "storm/environment/Environment.h"
 
 namespace storm {
@@ -15,14 +20,17 @@ namespace modelchecker {
 template<typename ValueType>
 class HeuristicValueIterator {
     typedef std::vector<ValueType> WeightType;
+    typedef typename storage::ValueVectorMapping<ValueType>::LeafComponent LeafComponent;
 
    public:
     struct Options {
         size_t stepsPerIteration = 100;
-        enum IterationOrder { FORWARD, BACKWARD, HEURISTIC } iterationOrder = BACKWARD;
+        enum IterationOrder { FORWARD, BACKWARD, HEURISTIC, PARALLEL_JACOBI, PARALLEL_GAUSS_SEIDEL, TOPOLOGICAL, PRIORITIZED } iterationOrder = BACKWARD;
         ValueType localOviEpsilon = 1e-4;
         bool exactOvi = true;
         ValueType cacheErrorTolerance = 1e-3;
+        size_t threadCount = 0;  // Only used by the parallel iteration orders, 0 means hardware concurrency
+        size_t maxComponentSweeps = 100;  // Sweeps over the leaves of a cyclic component before the iteration moves on
     };
 
     HeuristicValueIterator(Options options, std::shared_ptr<models::OpenMdpManager<ValueType>> manager, storage::ValueVector<ValueType>& valueVector,
@@ -30,15 +38,27 @@ class HeuristicValueIterator {
 
     void performIteration();
     static typename Options::IterationOrder orderFromString(std::string const& string);
+    static bool isParallelOrder(typename Options::IterationOrder order);
 
    private:
-    boost::optional<WeightType> queryCacheLowerBound(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight);
-    boost::optional<WeightType> queryCacheUpperBound(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight);
+    boost::optional<WeightType> queryCacheLowerBound(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight,
+                                                     compose::benchmark::BenchmarkStats<ValueType>& stepStats);
+    boost::optional<WeightType> queryCacheUpperBound(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight,
+                                                     compose::benchmark::BenchmarkStats<ValueType>& stepStats);
+    std::unique_lock<std::mutex> lockCacheIfNeeded();
     void updateModel(size_t leafId);
-    void addToCache(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight, WeightType inputWeight,
+    bool updateComponent(LeafComponent const& component, bool backward, bool& converged);
+    void initializeDependentComponents();
+    void initializeLeafPriorities();
+    void restartLeafPriorities();
+    void updatePrioritizedModel(size_t leafId);
+    void updateModelsInParallel(std::vector<size_t> const& leafIds, storage::ValueVector<ValueType>& source);
+    void addToCache(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight, WeightType inputWeight, compose::benchmark::BenchmarkStats<ValueType>& stepStats,
                     boost::optional<storm::storage::Scheduler<ValueType>> sched = boost::none);
     void storeInputWeights(size_t leafId, WeightType const& inputWeights);
-    WeightType performStep(size_t leafId, WeightType const& weights);
+    WeightType performStep(size_t leafId, WeightType const& weights, compose::benchmark::BenchmarkStats<ValueType>& stepStats);
+    std::vector<std::set<size_t>> computeLeafDependencies();
+    void initializeLeafColoring();
     size_t getNextLeaf();
     void initializeLeafScores();
     void updateLeafScore(size_t leafId, ValueType newScore);
@@ -55,6 +75,30 @@ class HeuristicValueIterator {
 
     std::unordered_map<size_t, ValueType> leafScore;
     std::multimap<ValueType, size_t> reverseLeafScore;
+
+    // Reused for the output weights of a leaf, one buffer per worker for the parallel orders
+    WeightType outputWeights;
+    std::vector<WeightType> workerWeights;
+
+    // Leaf components in topological order, used by the topological order and by the forward and backward orders if the diagram has traces
+    std::vector<LeafComponent> leafComponents;
+    WeightType previousInputWeights, currentInputWeights;
+
+    // State of the topological order, a component is pending if a component it depends on changed since its last update
+    std::vector<std::vector<size_t>> dependentComponents;
+    std::vector<bool> pendingComponents;
+
+    // State of the prioritized order: the exit weight change since the last update of each leaf, and the observed ratio between the change
+    // of its entrance weights and the change of its exit weights
+    std::unique_ptr<compose::utility::IndexedPriorityQueue<ValueType>> leafPriorities;
+    std::vector<ValueType> pendingExitChanges, leafSensitivities;
+
+    // State of the parallel iteration orders
+    std::unique_ptr<compose::utility::ThreadPool> threadPool;
+    std::vector<size_t> allLeaves;
+    std::vector<std::vector<size_t>> leafColoring;
+    storage::ValueVector<ValueType> previousValueVector;
+    std::mutex cacheMutex;
 };
 
 }  // namespace modelchecker
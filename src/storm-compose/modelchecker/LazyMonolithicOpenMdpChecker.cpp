@@ -0,0 +1,227 @@
+#include "LazyMonolithicOpenMdpChecker.h"
+
+#include <algorithm>
+
+#include "storm-parsers/parser/FormulaParser.h"
+#include "storm/environment/solver/MinMaxSolverEnvironment.h"
+#include "storm/modelchecker/prctl/SparseMdpPrctlModelChecker.h"
+#include "storm/modelchecker/results/ExplicitQuantitativeCheckResult.h"
+#include "storm/solver/SolverSelectionOptions.h"
+#include "storm/utility/constants.h"
+
+namespace storm {
+namespace modelchecker {
+
+template<typename ValueType>
+LazyMonolithicOpenMdpChecker<ValueType>::LazyMonolithicOpenMdpChecker(std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager,
+                                                                      storm::compose::benchmark::BenchmarkStats<ValueType>& stats, Options options)
+    : AbstractOpenMdpChecker<ValueType>(manager, stats), options(options) {}
+
+template<typename ValueType>
+ApproximateReachabilityResult<ValueType> LazyMonolithicOpenMdpChecker<ValueType>::check(OpenMdpReachabilityTask task) {
+    this->stats.modelBuildingTime.start();
+    this->manager->constructConcreteMdps();
+    generator = std::make_unique<storm::compose::generator::DiagramStateGenerator<ValueType>>(this->manager);
+    this->stats.modelBuildingTime.stop();
+    this->stats.stateCount = generator->getStateCount();
+
+    StateType initialState = generator->getLabeledState(task.getEntranceLabel());
+    StateType targetState = generator->getLabeledState(task.getExitLabel());
+    if (initialState == targetState) {
+        return ApproximateReachabilityResult<ValueType>(storm::utility::one<ValueType>());
+    }
+    initialIndex = getIndex(initialState);
+    targetIndex = getIndex(targetState);
+
+    while (true) {
+        bool expandedAny = false;
+        for (size_t sample = 0; sample < options.samplesPerRound; ++sample) {
+            expandedAny |= samplePath();
+        }
+        // All sampled paths end in converged states, so the remaining gap stems from states the heuristic does not reach
+        if (!expandedAny) {
+            expandFrontier();
+        }
+
+        computeBounds();
+        ++this->stats.explorationRounds;
+
+        ValueType gap = upper[initialIndex] - lower[initialIndex];
+        bool limitReached = options.stateLimit > 0 && indexToState.size() >= options.stateLimit;
+        STORM_LOG_INFO("Exploration round " << this->stats.explorationRounds << ": " << indexToState.size() << " states, [" << lower[initialIndex] << ", "
+                                            << upper[initialIndex] << "]");
+        if (gap <= options.precision || frontierSize == 0 || limitReached) {
+            break;
+        }
+    }
+
+    this->stats.exploredStates = indexToState.size();
+    return ApproximateReachabilityResult<ValueType>(lower[initialIndex], upper[initialIndex]);
+}
+
+template<typename ValueType>
+uint64_t LazyMonolithicOpenMdpChecker<ValueType>::getIndex(StateType state) {
+    auto it = stateToIndex.find(state);
+    if (it != stateToIndex.end()) {
+        return it->second;
+    }
+
+    uint64_t index = indexToState.size();
+    stateToIndex[state] = index;
+    indexToState.push_back(state);
+    firstRow.push_back(NOT_EXPANDED);
+    choiceCounts.push_back(0);
+    lower.push_back(storm::utility::zero<ValueType>());
+    upper.push_back(storm::utility::one<ValueType>());
+    return index;
+}
+
+template<typename ValueType>
+bool LazyMonolithicOpenMdpChecker<ValueType>::isExpanded(uint64_t index) const {
+    return firstRow[index] != NOT_EXPANDED;
+}
+
+template<typename ValueType>
+void LazyMonolithicOpenMdpChecker<ValueType>::expand(uint64_t index) {
+    typename storm::compose::generator::DiagramStateGenerator<ValueType>::Distribution successors;
+    StateType state = indexToState[index];
+    size_t choiceCount = generator->getChoiceCount(state);
+
+    firstRow[index] = rowStart.size() - 1;
+    choiceCounts[index] = choiceCount;
+    for (size_t choice = 0; choice < choiceCount; ++choice) {
+        generator->expand(state, choice, successors);
+        size_t rowBegin = entries.size();
+        for (auto const& successor : successors) {
+            entries.emplace_back(getIndex(successor.first), successor.second);
+        }
+        // The matrix builder expects the columns of a row in ascending order
+        std::sort(entries.begin() + rowBegin, entries.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+        rowStart.push_back(entries.size());
+    }
+}
+
+template<typename ValueType>
+bool LazyMonolithicOpenMdpChecker<ValueType>::samplePath() {
+    uint64_t current = initialIndex;
+    for (size_t length = 0; length <= indexToState.size(); ++length) {
+        if (current == targetIndex) {
+            return false;
+        }
+        if (!isExpanded(current)) {
+            expand(current);
+            return true;
+        }
+
+        // Choose the choice with the highest upper bound
+        uint64_t bestRow = firstRow[current];
+        ValueType bestValue = -storm::utility::one<ValueType>();
+        for (uint64_t row = firstRow[current]; row < firstRow[current] + choiceCounts[current]; ++row) {
+            ValueType value = storm::utility::zero<ValueType>();
+            for (uint64_t entry = rowStart[row]; entry < rowStart[row + 1]; ++entry) {
+                value += entries[entry].second * upper[entries[entry].first];
+            }
+            if (value > bestValue) {
+                bestValue = value;
+                bestRow = row;
+            }
+        }
+
+        // Sample a successor, weighted by probability and bound gap
+        double totalWeight = 0;
+        std::vector<double> weights;
+        for (uint64_t entry = rowStart[bestRow]; entry < rowStart[bestRow + 1]; ++entry) {
+            uint64_t successor = entries[entry].first;
+            double weight = storm::utility::convertNumber<double>(entries[entry].second * (upper[successor] - lower[successor]));
+            weights.push_back(weight);
+            totalWeight += weight;
+        }
+        if (totalWeight <= 0) {
+            return false;
+        }
+        std::uniform_real_distribution<double> distribution(0, totalWeight);
+        double sampled = distribution(randomGenerator);
+        uint64_t entry = rowStart[bestRow];
+        for (size_t i = 0; i + 1 < weights.size() && sampled >= weights[i]; ++i, ++entry) {
+            sampled -= weights[i];
+        }
+        current = entries[entry].first;
+    }
+    return false;
+}
+
+template<typename ValueType>
+void LazyMonolithicOpenMdpChecker<ValueType>::expandFrontier() {
+    size_t knownStates = indexToState.size();
+    for (uint64_t index = 0; index < knownStates; ++index) {
+        if (index != targetIndex && !isExpanded(index)) {
+            expand(index);
+        }
+    }
+}
+
+template<typename ValueType>
+void LazyMonolithicOpenMdpChecker<ValueType>::computeBounds() {
+    size_t stateCount = indexToState.size();
+    storm::storage::SparseMatrixBuilder<ValueType> builder(0, stateCount, 0, true, true, stateCount);
+    storm::models::sparse::StateLabeling labeling(stateCount);
+    labeling.addLabel("init");
+    labeling.addLabelToState("init", initialIndex);
+    labeling.addLabel("target");
+    labeling.addLabelToState("target", targetIndex);
+    labeling.addLabel("frontier");
+
+    // Unexplored states and the target are absorbing, their value is given by the labels
+    frontierSize = 0;
+    uint64_t currentRow = 0;
+    for (uint64_t index = 0; index < stateCount; ++index) {
+        builder.newRowGroup(currentRow);
+        if (index == targetIndex || !isExpanded(index)) {
+            if (index != targetIndex) {
+                labeling.addLabelToState("frontier", index);
+                ++frontierSize;
+            }
+            builder.addNextValue(currentRow++, index, storm::utility::one<ValueType>());
+            continue;
+        }
+        for (uint64_t row = firstRow[index]; row < firstRow[index] + choiceCounts[index]; ++row) {
+            for (uint64_t entry = rowStart[row]; entry < rowStart[row + 1]; ++entry) {
+                builder.addNextValue(currentRow, entries[entry].first, entries[entry].second);
+            }
+            ++currentRow;
+        }
+    }
+    storm::models::sparse::Mdp<ValueType> fragment(builder.build(), labeling);
+
+    this->stats.reachabilityComputationTime.start();
+    storm::Environment env;
+    env.solver().minMax().setMethod(storm::solver::MinMaxMethod::OptimisticValueIteration);
+    env.solver().minMax().setPrecision(storm::utility::convertNumber<storm::RationalNumber>(options.precision / 10));
+    // The bounds below are padded by the precision, which is only sound for an absolute criterion
+    env.solver().minMax().setRelativeTerminationCriterion(false);
+
+    storm::modelchecker::SparseMdpPrctlModelChecker<storm::models::sparse::Mdp<ValueType>> checker(fragment);
+    storm::parser::FormulaParser formulaParser;
+    auto computeValues = [&](std::string const& formulaString) {
+        auto formula = formulaParser.parseSingleFormulaFromString(formulaString);
+        CheckTask<storm::logic::Formula, ValueType> checkTask(*formula, false);
+        auto result = checker.check(env, checkTask);
+        return std::move(result->template asExplicitQuantitativeCheckResult<ValueType>().getValueVector());
+    };
+    lower = computeValues("Pmax=? [F \"target\"]");
+    upper = computeValues("Pmax=? [F (\"target\" | \"frontier\")]");
+    this->stats.reachabilityComputationTime.stop();
+
+    // The solver is only precise up to its precision, in either direction
+    ValueType solverPrecision = options.precision / 10;
+    for (uint64_t index = 0; index < stateCount; ++index) {
+        lower[index] = storm::utility::max<ValueType>(lower[index] - solverPrecision, storm::utility::zero<ValueType>());
+        upper[index] = storm::utility::min<ValueType>(upper[index] + solverPrecision, storm::utility::one<ValueType>());
+    }
+}
+
+template class LazyMonolithicOpenMdpChecker<storm::RationalNumber>;
+template class LazyMonolithicOpenMdpChecker<double>;
+
+}  // namespace modelchecker
+}  // namespace storm
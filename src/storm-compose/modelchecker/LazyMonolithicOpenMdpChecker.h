@@ -0,0 +1,63 @@
+#pragma once
+
+#include <limits>
+#include <random>
+#include <unordered_map>
+
+#include "AbstractOpenMdpChecker.h"
+#include "storm-compose/generator/DiagramStateGenerator.h"
+
+namespace storm {
+namespace modelchecker {
+
+// Monolithic checker that never builds the monolithic MDP.
+//
+// States of the string diagram are generated on demand (see DiagramStateGenerator). Paths are sampled from the entrance, following the
+// choices with the highest upper bound and the successors with the largest bound gap, and the first unexplored state of each path is
+// expanded. After each round of samples, bounds are computed on the explored fragment: the lower bound treats unexplored states as losing,
+// the upper bound as winning. Exploration stops once the bounds of the entrance are precise enough, everything reachable is explored, or the
+// state limit is reached.
+template<typename ValueType>
+class LazyMonolithicOpenMdpChecker : public AbstractOpenMdpChecker<ValueType> {
+   public:
+    struct Options {
+        ValueType precision = 1e-3;
+        size_t stateLimit = 0;  // Maximal number of explored states (0 = unlimited)
+        size_t samplesPerRound = 100;
+    };
+
+    LazyMonolithicOpenMdpChecker(std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager,
+                                 storm::compose::benchmark::BenchmarkStats<ValueType>& stats, Options options);
+    ApproximateReachabilityResult<ValueType> check(OpenMdpReachabilityTask task) override;
+
+   private:
+    typedef typename storm::compose::generator::DiagramStateGenerator<ValueType>::StateType StateType;
+    constexpr static uint64_t NOT_EXPANDED = std::numeric_limits<uint64_t>::max();
+
+    uint64_t getIndex(StateType state);
+    void expand(uint64_t index);
+    bool isExpanded(uint64_t index) const;
+    /// Returns whether a new state was expanded
+    bool samplePath();
+    void expandFrontier();
+    void computeBounds();
+
+    Options options;
+    std::unique_ptr<storm::compose::generator::DiagramStateGenerator<ValueType>> generator;
+    std::mt19937 randomGenerator;
+
+    // Explored fragment, states are indexed in the order they were discovered
+    std::unordered_map<StateType, uint64_t> stateToIndex;
+    std::vector<StateType> indexToState;
+    std::vector<uint64_t> firstRow;  // NOT_EXPANDED for states whose choices are not known yet
+    std::vector<uint64_t> choiceCounts;
+    std::vector<uint64_t> rowStart{0};  // Entries of row r are entries[rowStart[r]..rowStart[r + 1])
+    std::vector<std::pair<uint64_t, ValueType>> entries;
+    size_t frontierSize = 0;
+
+    uint64_t initialIndex = 0, targetIndex = 0;
+    std::vector<ValueType> lower, upper;
+};
+
+}  // namespace modelchecker
+}  // namespace storm
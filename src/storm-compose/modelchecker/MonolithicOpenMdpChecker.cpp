@@ -44,8 +44,8 @@ ApproximateReachabilityResult<ValueType> MonolithicOpenMdpChecker<ValueType>::ch
     auto mdp = concreteMdp.getMdp();
     STORM_LOG_ASSERT(mdp->getTransitionMatrix().isProbabilistic(), "MDP supplied is not probabilistic:\n" << mdp->getTransitionMatrix());
 
-    if (true) {
-        std::ofstream f("out.drn");
+    if (exportFilename) {
+        std::ofstream f(*exportFilename);
         storm::exporter::explicitExportSparseModel<ValueType>(f, mdp, {});
         f.close();
     }
@@ -85,6 +85,11 @@ ApproximateReachabilityResult<ValueType> MonolithicOpenMdpChecker<ValueType>::ch
     return ApproximateReachabilityResult<ValueType>(lowerBound, upperBound);
 }
 
+template<typename ValueType>
+void MonolithicOpenMdpChecker<ValueType>::setExportFilename(std::string const& filename) {
+    exportFilename = filename;
+}
+
 template class MonolithicOpenMdpChecker<storm::RationalNumber>;
 template class MonolithicOpenMdpChecker<double>;
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "AbstractOpenMdpChecker.h"
 
 namespace storm {
@@ -12,6 +14,12 @@ class MonolithicOpenMdpChecker : public AbstractOpenMdpChecker<ValueType> {
     ApproximateReachabilityResult<ValueType> check(OpenMdpReachabilityTask task) override;
 
     ApproximateReachabilityResult<ValueType> checkConcreteMdp(storm::models::ConcreteMdp<ValueType> const& concreteMdp, OpenMdpReachabilityTask task);
+
+    /// Exports the monolithic MDP in the explicit DRN format before checking it
+    void setExportFilename(std::string const& filename);
+
+   private:
+    boost::optional<std::string> exportFilename;
 };
 
 }  // namespace modelchecker
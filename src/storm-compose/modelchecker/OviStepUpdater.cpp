@@ -52,8 +52,9 @@ template<typename ValueType>
 bool OviStepUpdater<ValueType>::performIteration() {
     const auto& leaves = mapping.getLeaves();
 
+    WeightType weights;
     for (size_t leaf = 0; leaf < leaves.size(); ++leaf) {
-        WeightType weights = originalValueVector.getOutputWeights(leaf);
+        originalValueVector.getOutputWeights(leaf, weights);
         WeightType inputWeights = performStep(leaf, weights);
         storeInputWeights(leaf, inputWeights);
     }
@@ -62,29 +63,110 @@ bool OviStepUpdater<ValueType>::performIteration() {
 }
 
 template<typename ValueType>
-void OviStepUpdater<ValueType>::updateModel(size_t leafId) {
-    WeightType weights = originalValueVector.getOutputWeights(leafId);
-    WeightType inputWeights = performStep(leafId, weights);
-    storeInputWeights(leafId, inputWeights);
+bool OviStepUpdater<ValueType>::performLocalIteration() {
+    if (!localIterationInitialized) {
+        exitingLeaves.assign(originalValueVector.getValues().size(), {});
+        for (size_t leaf = 0; leaf < mapping.getLeafCount(); ++leaf) {
+            for (size_t index : mapping.getExitIndices(leaf)) {
+                exitingLeaves[index].push_back(leaf);
+            }
+            pendingLeaves.insert(leaf);
+        }
+        localIterationInitialized = true;
+    }
+
+    std::set<size_t> leaves;
+    std::swap(leaves, pendingLeaves);
+    for (size_t leaf : leaves) {
+        verifyLeaf(leaf);
+    }
+
+    return pendingLeaves.empty();
 }
 
 template<typename ValueType>
-void OviStepUpdater<ValueType>::storeInputWeights(size_t leafId, WeightType const& inputWeights) {
+void OviStepUpdater<ValueType>::verifyLeaf(size_t leafId) {
+    // Checked with the current values, even if a leaf processed earlier in this call requested another check
+    pendingLeaves.erase(leafId);
+
     models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
-    size_t weightIndex = 0;
-    for (size_t i = 0; i < model->getLEntrance().size(); ++i) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::L_ENTRANCE, i};
-        newValueVector.setWeight(leafId, pos, inputWeights[weightIndex]);
+    WeightType weights, guess;
+    originalValueVector.getOutputWeights(leafId, weights);
+    originalValueVector.getInputWeights(leafId, guess);
+
+    bool allZero = std::all_of(weights.begin(), weights.end(), [](ValueType v) { return v == storm::utility::zero<ValueType>(); });
+    if (allZero) {
+        return;
+    }
 
-        ++weightIndex;
+    // The upper bounds of the cache are sound (their halfspaces are padded by the precision of the solver, see ParetoCache::Options), if they
+    // do not exceed the guess the leaf does not need to be solved
+    auto dominatedByGuess = [&guess](WeightType const& values) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] > guess[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto& leafProfile = stats.getLeafProfile(*model);
+    stats.cacheRetrievalTime.start();
+    auto cachedUpperBound = cache->getUpperBound(model, weights);
+    stats.cacheRetrievalTime.stop();
+    if (cachedUpperBound && dominatedByGuess(*cachedUpperBound)) {
+        ++stats.oviCertifiedLeaves;
+        ++leafProfile.cacheHits;
+        return;
     }
 
-    for (size_t i = 0; i < model->getREntrance().size(); ++i) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::R_ENTRANCE, i};
-        newValueVector.setWeight(leafId, pos, inputWeights[weightIndex]);
+    WeightType step;
+    auto precomputedUpperBound = model->getReachabilityEngine()->getPrecomputedUpperBound(weights);
+    if (precomputedUpperBound) {
+        ++leafProfile.cacheHits;
+        step = std::move(*precomputedUpperBound);
+    } else {
+        STORM_LOG_ASSERT(model->getMdp()->getTransitionMatrix().isProbabilistic(), "Not probabilistic");
+        ++stats.weightedReachabilityQueries;
+        ++stats.oviSolvedLeaves;
+        ++leafProfile.cacheMisses;
+        auto solveStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
+        stats.reachabilityComputationTime.start();
+        auto result = models::visitor::CVIVisitor<ValueType>::weightedReachability(weights, *model, cache->needScheduler(), env);
+        stats.reachabilityComputationTime.stop();
+        stats.recordSolve(leafProfile, solveStart);
+        addToCache(model, weights, result.first, result.second);
+
+        step = result.first;
+        if (!options.exactOvi) {
+            for (auto& v : step) {
+                v = storm::utility::min<ValueType>(v + options.localOviEpsilon, storm::utility::one<ValueType>());
+            }
+        }
+    }
+    if (dominatedByGuess(step)) {
+        return;
+    }
 
-        ++weightIndex;
+    // Decreasing values keeps the other leaves inductive, only the leaves exiting into an increased value have to be checked again
+    auto entranceIndices = mapping.getEntranceIndices(leafId);
+    for (size_t i = 0; i < step.size(); ++i) {
+        if (step[i] > guess[i]) {
+            pendingLeaves.insert(exitingLeaves[entranceIndices[i]].begin(), exitingLeaves[entranceIndices[i]].end());
+        }
     }
+    originalValueVector.setInputWeights(leafId, step);
+}
+
+template<typename ValueType>
+void OviStepUpdater<ValueType>::updateModel(size_t leafId) {
+    WeightType weights = originalValueVector.getOutputWeights(leafId);
+    WeightType inputWeights = performStep(leafId, weights);
+    storeInputWeights(leafId, inputWeights);
+}
+
+template<typename ValueType>
+void OviStepUpdater<ValueType>::storeInputWeights(size_t leafId, WeightType const& inputWeights) {
+    newValueVector.setInputWeights(leafId, inputWeights);
 }
 
 template<typename ValueType>
@@ -95,19 +177,27 @@ typename OviStepUpdater<ValueType>::WeightType OviStepUpdater<ValueType>::perfor
     if (allZero) {
         inputWeights = std::vector<ValueType>(model->getEntranceCount(), 0);
     } else {
-        boost::optional<std::vector<ValueType>> result;
-        result = queryCache(model, weights);
+        auto& leafProfile = stats.getLeafProfile(*model);
+        // The precomputed Pareto set gives a sound upper bound, a query of the engine would only give the maximum over its achievable points
+        boost::optional<std::vector<ValueType>> result = model->getReachabilityEngine()->getPrecomputedUpperBound(weights);
+        if (!result) {
+            result = queryCache(model, weights);
+        }
 
         ++stats.weightedReachabilityQueries;
         if (result) {
             inputWeights = *result;
             ++stats.cacheHits;
+            ++leafProfile.cacheHits;
         } else {
             STORM_LOG_ASSERT(model->getMdp()->getTransitionMatrix().isProbabilistic(), "Not probabilistic");
 
+            ++leafProfile.cacheMisses;
+            auto solveStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
             stats.reachabilityComputationTime.start();
             auto newResult = models::visitor::CVIVisitor<ValueType>::weightedReachability(weights, *model, cache->needScheduler(), env);
             stats.reachabilityComputationTime.stop();
+            stats.recordSolve(leafProfile, solveStart);
             std::vector<ValueType> weight(newResult.first);
             // std::vector<ValueType> weight(newResult.first);
             //   std::cout << "UB WEIGHT:" << std::endl;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <queue>
+#include <set>
 
 #include "storm-compose/benchmark/BenchmarkStats.h"
 #include "storm-compose/modelchecker/CompositionalValueIteration.h"
@@ -25,6 +26,11 @@ class OviStepUpdater {
     bool performIteration();
     storage::ValueVector<ValueType> getNewValueVector();
 
+    /// Checks leaf by leaf whether the value vector is inductive (one step does not increase a value) and updates it in place. A leaf is not
+    /// solved if the upper bound of the cache already certifies it. A leaf that is not inductive gets its entrance values replaced by the step,
+    /// only the leaves that exit into an increased value are checked again by the next call. Returns true once all leaves are inductive.
+    bool performLocalIteration();
+
    private:
     boost::optional<WeightType> queryCache(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight);
     void updateModel(size_t leafId);
@@ -32,6 +38,7 @@ class OviStepUpdater {
                     boost::optional<storm::storage::Scheduler<ValueType>> sched = boost::none);
     void storeInputWeights(size_t leafId, WeightType const& inputWeights);
     WeightType performStep(size_t leafId, WeightType const& weights);
+    void verifyLeaf(size_t leafId);
 
     typename HeuristicValueIterator<ValueType>::Options options;
     storm::Environment env;
@@ -41,6 +48,11 @@ class OviStepUpdater {
     storage::ValueVectorMapping<ValueType> mapping;
     std::shared_ptr<storm::storage::AbstractCache<ValueType>> cache;
     compose::benchmark::BenchmarkStats<ValueType>& stats;
+
+    // State of the local iteration: leaves that still have to be checked, and for each value index the leaves that exit into it
+    std::set<size_t> pendingLeaves;
+    std::vector<std::vector<size_t>> exitingLeaves;
+    bool localIterationInitialized = false;
 };
 
 }  // namespace modelchecker
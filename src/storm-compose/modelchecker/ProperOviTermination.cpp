@@ -53,11 +53,12 @@ template<typename ValueType>
 bool ProperOviTermination<ValueType>::performIteration() {
     const auto& leaves = mapping.getLeaves();
 
+    WeightType weights, originalInputWeights;
     for (size_t leaf = 0; leaf < leaves.size(); ++leaf) {
-        WeightType weights = originalValueVector.getOutputWeights(leaf);
+        originalValueVector.getOutputWeights(leaf, weights);
         WeightType inputWeights = performStep(leaf, weights);
 
-        auto originalInputWeights = originalValueVector.getInputWeights(leaf);
+        originalValueVector.getInputWeights(leaf, originalInputWeights);
 
         for (size_t i = 0; i < inputWeights.size(); ++i) {
             // if (inputWeights[i] > originalInputWeights[i] + 1e-6) {
@@ -81,21 +82,7 @@ void ProperOviTermination<ValueType>::updateModel(size_t leafId) {
 
 template<typename ValueType>
 void ProperOviTermination<ValueType>::storeInputWeights(size_t leafId, WeightType const& inputWeights) {
-    models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
-    size_t weightIndex = 0;
-    for (size_t i = 0; i < model->getLEntrance().size(); ++i) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::L_ENTRANCE, i};
-        valueVector.setWeight(leafId, pos, inputWeights[weightIndex]);
-
-        ++weightIndex;
-    }
-
-    for (size_t i = 0; i < model->getREntrance().size(); ++i) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::R_ENTRANCE, i};
-        valueVector.setWeight(leafId, pos, inputWeights[weightIndex]);
-
-        ++weightIndex;
-    }
+    valueVector.setInputWeights(leafId, inputWeights);
 }
 
 template<typename ValueType>
@@ -0,0 +1,247 @@
+#include "WeightedReachabilityEngine.h"
+
+#include <algorithm>
+#include <map>
+
+#include "storm-compose/models/ConcreteMdp.h"
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/environment/solver/MinMaxSolverEnvironment.h"
+#include "storm/environment/solver/SolverEnvironment.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/UncheckedRequirementException.h"
+#include "storm/solver/SolverSelectionOptions.h"
+#include "storm/transformer/EndComponentEliminator.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/graph.h"
+#include "storm/utility/macros.h"
+#include "storm/utility/vector.h"
+
+namespace storm {
+namespace modelchecker {
+
+template<typename ValueType>
+WeightedReachabilityEngine<ValueType>::WeightedReachabilityEngine(models::ConcreteMdp<ValueType> const& concreteMdp)
+    : mdp(concreteMdp.getMdp()), hasEndComponents(false), trackSchedulerForWarmStart(false) {
+    auto const& transitionMatrix = mdp->getTransitionMatrix();
+    size_t stateCount = transitionMatrix.getRowGroupCount();
+
+    entrances = concreteMdp.getLEntrance();
+    entrances.insert(entrances.end(), concreteMdp.getREntrance().begin(), concreteMdp.getREntrance().end());
+
+    storm::storage::BitVector exitStates(stateCount);
+    std::vector<uint64_t> exitIndex(stateCount);
+    size_t exitCount = 0;
+    auto processExits = [&](auto const& exits) {
+        for (size_t state : exits) {
+            exitStates.set(state);
+            exitIndex[state] = exitCount;
+            ++exitCount;
+        }
+    };
+    processExits(concreteMdp.getLExit());
+    processExits(concreteMdp.getRExit());
+
+    // States that cannot reach an exit have value zero for all weights
+    maybeStates = storm::utility::graph::performProbGreater0E(mdp->getBackwardTransitions(), ~exitStates, exitStates) & ~exitStates;
+
+    // End components of the maybe states only contain choices without exit transitions, so they can be eliminated independently of the weights
+    storm::storage::BitVector allRows(transitionMatrix.getRowCount(), true);
+    auto ecElimination = storm::transformer::EndComponentEliminator<ValueType>::transform(transitionMatrix, maybeStates, allRows,
+                                                                                         storm::storage::BitVector(stateCount, false));
+    reducedMatrix = std::move(ecElimination.matrix);
+    stateToReducedState = std::move(ecElimination.oldToNewStateMapping);
+    reducedToOriginalRow = std::move(ecElimination.newToOldRowMapping);
+
+    storm::storage::BitVector keptRows(transitionMatrix.getRowCount(), false);
+    for (auto row : reducedToOriginalRow) {
+        keptRows.set(row);
+    }
+    endComponentStayRows = storm::storage::BitVector(transitionMatrix.getRowCount(), false);
+    for (auto state : maybeStates) {
+        for (uint64_t row = transitionMatrix.getRowGroupIndices()[state]; row < transitionMatrix.getRowGroupIndices()[state + 1]; ++row) {
+            if (!keptRows.get(row)) {
+                endComponentStayRows.set(row);
+                hasEndComponents = true;
+            }
+        }
+    }
+
+    storm::storage::SparseMatrixBuilder<ValueType> builder(reducedToOriginalRow.size(), exitCount);
+    for (uint64_t reducedRow = 0; reducedRow < reducedToOriginalRow.size(); ++reducedRow) {
+        std::map<uint64_t, ValueType> entries;
+        for (auto const& entry : transitionMatrix.getRow(reducedToOriginalRow[reducedRow])) {
+            if (exitStates.get(entry.getColumn())) {
+                entries[exitIndex[entry.getColumn()]] += entry.getValue();
+            }
+        }
+        for (auto const& entry : entries) {
+            builder.addNextValue(reducedRow, entry.first, entry.second);
+        }
+    }
+    exitProbabilities = builder.build();
+}
+
+template<typename ValueType>
+void WeightedReachabilityEngine<ValueType>::createSolver(storm::Environment const& env) {
+    storm::solver::GeneralMinMaxLinearEquationSolverFactory<ValueType> factory;
+    auto requirements = factory.getRequirements(env, true, true, storm::solver::OptimizationDirection::Maximize);
+    // The bounds are set for each query
+    requirements.clearBounds();
+    STORM_LOG_THROW(!requirements.hasEnabledCriticalRequirement(), storm::exceptions::UncheckedRequirementException,
+                    "Solver requirements " + requirements.getEnabledRequirementsAsString() + " not checked.");
+
+    solver = factory.create(env, reducedMatrix);
+    solver->setOptimizationDirection(storm::solver::OptimizationDirection::Maximize);
+    solver->setRequirementsChecked();
+    solver->setHasUniqueSolution();
+    solver->setHasNoEndComponents();
+    solver->setCachingEnabled(true);
+
+    // Only the scheduler of the previous query is reused. Value iteration started from the previous solution may start above the new fixpoint
+    // and converge to it from above, which would turn the returned lower bounds into over-approximations.
+    auto method = env.solver().minMax().getMethod();
+    trackSchedulerForWarmStart = method == storm::solver::MinMaxMethod::PolicyIteration || method == storm::solver::MinMaxMethod::ViToPi;
+}
+
+template<typename ValueType>
+std::pair<std::vector<ValueType>, boost::optional<storm::storage::Scheduler<ValueType>>> WeightedReachabilityEngine<ValueType>::solve(
+    storm::Environment const& env, WeightType const& weights, bool returnScheduler) {
+    STORM_LOG_THROW(weights.size() == exitProbabilities.getColumnCount(), storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (precomputedParetoSet && !returnScheduler) {
+        precomputedQueryTime.start();
+        auto entranceValues = precomputedParetoSet->maximize(weights);
+        precomputedQueryTime.stop();
+        return {entranceValues, boost::none};
+    }
+
+    std::vector<ValueType> values;
+    std::vector<uint_fast64_t> choices;
+    if (reducedMatrix.getRowGroupCount() > 0) {
+        if (!solver) {
+            createSolver(env);
+        }
+
+        std::vector<ValueType> b(reducedMatrix.getRowCount());
+        exitProbabilities.multiplyWithVector(weights, b);
+
+        // Weights are non-negative, so the values lie between zero and the largest weight
+        ValueType maxWeight = storm::utility::zero<ValueType>();
+        for (auto const& weight : weights) {
+            maxWeight = storm::utility::max<ValueType>(maxWeight, weight);
+        }
+        solver->setBounds(storm::utility::zero<ValueType>(), maxWeight);
+
+        values.assign(reducedMatrix.getRowGroupCount(), storm::utility::zero<ValueType>());
+        if (previousChoices) {
+            solver->setInitialScheduler(std::vector<uint_fast64_t>(*previousChoices));
+        }
+        bool trackScheduler = returnScheduler || trackSchedulerForWarmStart;
+        solver->setTrackScheduler(trackScheduler);
+
+        solver->solveEquations(env, values, b);
+
+        if (trackScheduler) {
+            choices = solver->getSchedulerChoices();
+            if (trackSchedulerForWarmStart) {
+                previousChoices = choices;
+            }
+        }
+    }
+
+    std::vector<ValueType> entranceValues(entrances.size(), storm::utility::zero<ValueType>());
+    for (size_t i = 0; i < entrances.size(); ++i) {
+        if (maybeStates.get(entrances[i])) {
+            entranceValues[i] = values[stateToReducedState[entrances[i]]];
+        }
+    }
+
+    boost::optional<storm::storage::Scheduler<ValueType>> scheduler;
+    if (returnScheduler) {
+        scheduler = extractScheduler(choices);
+    }
+    return {entranceValues, scheduler};
+}
+
+template<typename ValueType>
+boost::optional<std::vector<ValueType>> WeightedReachabilityEngine<ValueType>::getPrecomputedUpperBound(WeightType const& weights) {
+    STORM_LOG_THROW(weights.size() == exitProbabilities.getColumnCount(), storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!precomputedParetoSet) {
+        return boost::none;
+    }
+
+    precomputedQueryTime.start();
+    if (precomputedOverApproximations.empty()) {
+        for (size_t entrance = 0; entrance < precomputedParetoSet->getEntranceCount(); ++entrance) {
+            precomputedOverApproximations.push_back(precomputedParetoSet->createOverApproximation(entrance, weights.size()));
+        }
+    }
+    std::vector<ValueType> entranceValues;
+    entranceValues.reserve(precomputedOverApproximations.size());
+    for (auto const& overApproximation : precomputedOverApproximations) {
+        auto optimum = overApproximation->optimize(weights);
+        STORM_LOG_ASSERT(optimum.second, "Over-approximation is unbounded");
+        entranceValues.push_back(storm::utility::vector::dotProduct(weights, optimum.first));
+    }
+    precomputedQueryTime.stop();
+    return entranceValues;
+}
+
+template<typename ValueType>
+void WeightedReachabilityEngine<ValueType>::setPrecomputedParetoSet(std::shared_ptr<storm::storage::PrecomputedParetoSet<ValueType> const> paretoSet) {
+    std::lock_guard<std::mutex> lock(mutex);
+    precomputedParetoSet = std::move(paretoSet);
+    precomputedOverApproximations.clear();
+}
+
+template<typename ValueType>
+std::shared_ptr<storm::storage::PrecomputedParetoSet<ValueType> const> WeightedReachabilityEngine<ValueType>::getPrecomputedParetoSet() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return precomputedParetoSet;
+}
+
+template<typename ValueType>
+storm::utility::Stopwatch WeightedReachabilityEngine<ValueType>::getPrecomputedQueryTime() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return precomputedQueryTime;
+}
+
+template<typename ValueType>
+storm::storage::Scheduler<ValueType> WeightedReachabilityEngine<ValueType>::extractScheduler(std::vector<uint_fast64_t> const& reducedChoices) const {
+    auto const& transitionMatrix = mdp->getTransitionMatrix();
+    auto const& rowGroupIndices = transitionMatrix.getRowGroupIndices();
+    size_t stateCount = transitionMatrix.getRowGroupCount();
+
+    storm::storage::Scheduler<ValueType> scheduler(stateCount);
+    storm::storage::BitVector statesWithoutChoice = maybeStates;
+    for (size_t state = 0; state < stateCount; ++state) {
+        if (!maybeStates.get(state)) {
+            scheduler.setChoice(0, state);
+        }
+    }
+
+    // Each reduced state chooses a row of one of its original states, for an eliminated end component this is the state the component is left from
+    for (uint64_t reducedState = 0; reducedState < reducedChoices.size(); ++reducedState) {
+        uint64_t row = reducedToOriginalRow[reducedMatrix.getRowGroupIndices()[reducedState] + reducedChoices[reducedState]];
+        uint64_t state = std::upper_bound(rowGroupIndices.begin(), rowGroupIndices.end(), row) - rowGroupIndices.begin() - 1;
+        scheduler.setChoice(row - rowGroupIndices[state], state);
+        statesWithoutChoice.set(state, false);
+    }
+
+    // The remaining end component states move towards the state that leaves the component
+    if (hasEndComponents && !statesWithoutChoice.empty()) {
+        storm::utility::graph::computeSchedulerProb1E(maybeStates, transitionMatrix, mdp->getBackwardTransitions(), statesWithoutChoice,
+                                                      maybeStates & ~statesWithoutChoice, scheduler, endComponentStayRows);
+    }
+    return scheduler;
+}
+
+template class WeightedReachabilityEngine<double>;
+template class WeightedReachabilityEngine<storm::RationalNumber>;
+
+}  // namespace modelchecker
+}  // namespace storm
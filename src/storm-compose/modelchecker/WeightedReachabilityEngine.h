@@ -0,0 +1,88 @@
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "storm-compose/storage/PrecomputedParetoSet.h"
+#include "storm/environment/Environment.h"
+#include "storm/models/sparse/Mdp.h"
+#include "storm/solver/MinMaxLinearEquationSolver.h"
+#include "storm/storage/BitVector.h"
+#include "storm/storage/Scheduler.h"
+#include "storm/storage/SparseMatrix.h"
+#include "storm/utility/Stopwatch.h"
+
+namespace storm {
+namespace models {
+template<typename ValueType>
+class ConcreteMdp;
+}
+
+namespace modelchecker {
+
+// Solves max_sched sum_e weight_e * P(reach exit e) from every entrance of a single leaf for a sequence of weight vectors.
+//
+// Everything that does not depend on the weights is computed once: the states that cannot reach any exit, the elimination of the end
+// components among the remaining states (all of them are reward free, as rewards are only collected on transitions into exits), the
+// matrix of one-step exit probabilities and the min-max solver itself. With policy iteration (or ViToPi), each query starts from the
+// scheduler of the previous one.
+//
+// Exits are treated as absorbing, i.e. leaving the leaf through an exit ends the computation.
+//
+// If a precomputed Pareto set is attached, queries that do not need a scheduler are answered by a maximum over its points instead. These are
+// lower bounds, callers that need upper bounds use getPrecomputedUpperBound.
+template<typename ValueType>
+class WeightedReachabilityEngine {
+   public:
+    typedef std::vector<ValueType> WeightType;
+
+    WeightedReachabilityEngine(models::ConcreteMdp<ValueType> const& concreteMdp);
+
+    /// Returns the values of the entrances (L entrances first) and, if requested, an optimal scheduler for the whole leaf MDP.
+    /// Queries are serialized, the solver is created with the environment of the first query.
+    std::pair<WeightType, boost::optional<storm::storage::Scheduler<ValueType>>> solve(storm::Environment const& env, WeightType const& weights,
+                                                                                       bool returnScheduler);
+
+    /// If a precomputed Pareto set is attached, the maximum of the weighted sum over its over-approximation for each entrance (L entrances first)
+    boost::optional<WeightType> getPrecomputedUpperBound(WeightType const& weights);
+
+    void setPrecomputedParetoSet(std::shared_ptr<storm::storage::PrecomputedParetoSet<ValueType> const> paretoSet);
+    std::shared_ptr<storm::storage::PrecomputedParetoSet<ValueType> const> getPrecomputedParetoSet() const;
+    /// Time spent answering queries from the precomputed Pareto set
+    storm::utility::Stopwatch getPrecomputedQueryTime() const;
+
+   private:
+    void createSolver(storm::Environment const& env);
+    storm::storage::Scheduler<ValueType> extractScheduler(std::vector<uint_fast64_t> const& reducedChoices) const;
+
+    std::shared_ptr<storm::models::sparse::Mdp<ValueType>> mdp;
+    std::vector<size_t> entrances;
+
+    // States that can reach an exit, ordered as in the original MDP
+    storm::storage::BitVector maybeStates;
+    // For each original state the row group in the reduced matrix (end components are merged into a single row group)
+    std::vector<uint_fast64_t> stateToReducedState;
+    // For each row of the reduced matrix the corresponding row of the original matrix
+    std::vector<uint_fast64_t> reducedToOriginalRow;
+    // Rows of end component states that stay inside the end component
+    storm::storage::BitVector endComponentStayRows;
+    bool hasEndComponents;
+
+    storm::storage::SparseMatrix<ValueType> reducedMatrix;
+    // For each row of the reduced matrix the probabilities to move to each exit, the right-hand side is this matrix times the weights
+    storm::storage::SparseMatrix<ValueType> exitProbabilities;
+
+    mutable std::mutex mutex;
+    std::shared_ptr<storm::storage::PrecomputedParetoSet<ValueType> const> precomputedParetoSet;
+    // Over-approximation of each entrance, created on the first upper bound query
+    std::vector<std::shared_ptr<storm::storage::geometry::Polytope<ValueType>>> precomputedOverApproximations;
+    storm::utility::Stopwatch precomputedQueryTime;
+    std::unique_ptr<storm::solver::MinMaxLinearEquationSolver<ValueType>> solver;
+    bool trackSchedulerForWarmStart;
+    boost::optional<std::vector<uint_fast64_t>> previousChoices;
+};
+
+}  // namespace modelchecker
+}  // namespace storm
@@ -1,5 +1,8 @@
 #include "ConcreteMdp.h"
 
+#include <memory>
+
+#include "storm-compose/modelchecker/WeightedReachabilityEngine.h"
 #include "storm-compose/models/visitor/BidirectionalReachabilityResult.h"
 #include "storm/environment/Environment.h"
 #include "storm/modelchecker/multiobjective/Objective.h"
@@ -102,6 +105,19 @@ size_t ConcreteMdp<ValueType>::getRExitCount() const {
     return rExit.size();
 }
 
+template<typename ValueType>
+std::shared_ptr<modelchecker::WeightedReachabilityEngine<ValueType>> ConcreteMdp<ValueType>::getReachabilityEngine() const {
+    // Leaves may be queried from several threads at once (parallel iteration orders), only one of the concurrently created engines is kept
+    auto engine = std::atomic_load(&reachabilityEngine);
+    if (!engine) {
+        auto newEngine = std::make_shared<modelchecker::WeightedReachabilityEngine<ValueType>>(*this);
+        if (std::atomic_compare_exchange_strong(&reachabilityEngine, &engine, newEngine)) {
+            engine = newEngine;
+        }
+    }
+    return engine;
+}
+
 template class ConcreteMdp<double>;
 template class ConcreteMdp<storm::RationalNumber>;
 
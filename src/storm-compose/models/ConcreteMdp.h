@@ -5,6 +5,11 @@
 #include "storm/models/sparse/Mdp.h"
 
 namespace storm {
+namespace modelchecker {
+template<typename ValueType>
+class WeightedReachabilityEngine;
+}
+
 namespace models {
 
 namespace visitor {
@@ -45,9 +50,13 @@ class ConcreteMdp : public OpenMdp<ValueType> {
     size_t getLExitCount() const;
     size_t getRExitCount() const;
 
+    // Created on first use and shared by copies of this leaf
+    std::shared_ptr<modelchecker::WeightedReachabilityEngine<ValueType>> getReachabilityEngine() const;
+
    private:
     std::shared_ptr<storm::models::sparse::Mdp<ValueType>> mdp;
     std::vector<size_t> lEntrance, rEntrance, lExit, rExit;
+    mutable std::shared_ptr<modelchecker::WeightedReachabilityEngine<ValueType>> reachabilityEngine;
 };
 
 }  // namespace models
@@ -1,7 +1,16 @@
 #include "OpenMdpManager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <map>
 #include <memory>
+#include <sstream>
+#include <thread>
 #include "PrismModel.h"
+#include "storm-compose/storage/LeafDiskCache.h"
+#include "storm-compose/utility/ThreadPool.h"
+#include "storm/exceptions/FileIoException.h"
 #include "storm/exceptions/UnexpectedException.h"
 #include "storm/utility/macros.h"
 
@@ -42,14 +51,102 @@ void OpenMdpManager<ValueType>::addReference(const std::string& name, std::share
 
 template<typename ValueType>
 void OpenMdpManager<ValueType>::constructConcreteMdps() {
+    // Visit the references in a fixed order, so the leaf that is built for a group of identical references does not depend on the hashing
+    std::map<std::string, std::shared_ptr<PrismModel<ValueType>>> prismModels;
     for (auto& entry : references) {
-        auto openMdp = entry.second;
-        if (openMdp->isPrismModel()) {
-            auto prismModel = std::dynamic_pointer_cast<storm::models::PrismModel<ValueType>>(openMdp);
-            auto concreteMdp = prismModel->toConcreteMdp();
-            setReference(entry.first, std::make_shared<ConcreteMdp<ValueType>>(concreteMdp));
+        if (entry.second->isPrismModel()) {
+            prismModels[entry.first] = std::dynamic_pointer_cast<storm::models::PrismModel<ValueType>>(entry.second);
         }
     }
+
+    std::unordered_map<std::string, size_t> keyToLeaf;
+    std::vector<std::string> leafNames, leafKeys;
+    std::vector<std::pair<std::string, size_t>> referenceToLeaf;
+    for (auto const& entry : prismModels) {
+        std::string key = getLeafKey(*entry.second);
+        auto inserted = keyToLeaf.emplace(key, leafNames.size());
+        if (inserted.second) {
+            leafNames.push_back(entry.first);
+            leafKeys.push_back(std::move(key));
+        } else {
+            ++sharedLeafCount;
+        }
+        referenceToLeaf.emplace_back(entry.first, inserted.first->second);
+    }
+
+    // Each leaf parses its own program, so the builds are independent
+    std::vector<std::shared_ptr<ConcreteMdp<ValueType>>> leaves(leafNames.size());
+    size_t threadCount = buildThreadCount == 0 ? std::thread::hardware_concurrency() : buildThreadCount;
+    compose::utility::ThreadPool threadPool(std::max<size_t>(1, std::min(threadCount, leaves.size())));
+    std::atomic<size_t> loadedLeaves(0);
+    threadPool.parallelFor(leaves.size(), [&](size_t index, size_t) {
+        auto prismModel = prismModels.at(leafNames[index]);
+        if (diskCache) {
+            leaves[index] = diskCache->loadLeaf(leafKeys[index], prismModel->getManager());
+        }
+        if (leaves[index]) {
+            ++loadedLeaves;
+        } else {
+            leaves[index] = std::make_shared<ConcreteMdp<ValueType>>(prismModel->toConcreteMdp());
+            if (diskCache) {
+                diskCache->storeLeaf(leafKeys[index], *leaves[index]);
+            }
+        }
+        leaves[index]->setName(leafNames[index]);
+    });
+    loadedLeafCount += loadedLeaves;
+
+    // A shared leaf keeps the name of the reference it was built for
+    for (auto const& entry : referenceToLeaf) {
+        references[entry.first] = leaves[entry.second];
+    }
+}
+
+template<typename ValueType>
+void OpenMdpManager<ValueType>::setDiskCache(std::shared_ptr<storm::storage::LeafDiskCache<ValueType>> diskCache) {
+    this->diskCache = diskCache;
+}
+
+template<typename ValueType>
+std::shared_ptr<storm::storage::LeafDiskCache<ValueType>> OpenMdpManager<ValueType>::getDiskCache() const {
+    return diskCache;
+}
+
+template<typename ValueType>
+size_t OpenMdpManager<ValueType>::getLoadedLeafCount() const {
+    return loadedLeafCount;
+}
+
+template<typename ValueType>
+void OpenMdpManager<ValueType>::setBuildThreadCount(size_t threadCount) {
+    buildThreadCount = threadCount;
+}
+
+template<typename ValueType>
+size_t OpenMdpManager<ValueType>::getSharedLeafCount() const {
+    return sharedLeafCount;
+}
+
+template<typename ValueType>
+std::string OpenMdpManager<ValueType>::getLeafKey(PrismModel<ValueType> const& prismModel) const {
+    // The content of the program is used instead of its path, so copies of a file are also shared
+    std::ifstream file(prismModel.getPath());
+    STORM_LOG_THROW(file.good(), storm::exceptions::FileIoException, "Could not open prism file " << prismModel.getPath());
+    std::stringstream key;
+    key << file.rdbuf();
+
+    // Valuations cannot contain newlines, so the separator keeps the key unambiguous
+    auto appendValuations = [&](std::vector<std::string> const& valuations) {
+        key << "\n" << valuations.size();
+        for (auto const& valuation : valuations) {
+            key << "\n" << valuation;
+        }
+    };
+    appendValuations(prismModel.getLEntrance());
+    appendValuations(prismModel.getREntrance());
+    appendValuations(prismModel.getLExit());
+    appendValuations(prismModel.getRExit());
+    return key.str();
 }
 
 template class OpenMdpManager<storm::RationalNumber>;
@@ -6,10 +6,17 @@
 #include <unordered_map>
 
 namespace storm {
+namespace storage {
+template<typename ValueType>
+class LeafDiskCache;
+}
+
 namespace models {
 
 template<typename ValueType>
 class OpenMdp;
+template<typename ValueType>
+class PrismModel;
 
 template<typename ValueType>
 class OpenMdpManager {
@@ -21,11 +28,26 @@ class OpenMdpManager {
     std::shared_ptr<OpenMdp<ValueType>> getRoot() const;
     void setReference(const std::string& name, std::shared_ptr<OpenMdp<ValueType>> reference);
     void addReference(const std::string& name, std::shared_ptr<OpenMdp<ValueType>> reference);
+    // Builds the concrete MDPs of all PRISM references. References with the same PRISM program and the same entrances and exits share a
+    // single ConcreteMdp (and thereby its cache entries and solver).
     void constructConcreteMdps();
+    size_t getSharedLeafCount() const;
+    /// Number of threads used to build the leaves, 0 selects the number of hardware threads
+    void setBuildThreadCount(size_t threadCount);
+    // Leaves are loaded from and stored to the disk cache, if one is set
+    void setDiskCache(std::shared_ptr<storm::storage::LeafDiskCache<ValueType>> diskCache);
+    std::shared_ptr<storm::storage::LeafDiskCache<ValueType>> getDiskCache() const;
+    size_t getLoadedLeafCount() const;
 
    private:
+    std::string getLeafKey(PrismModel<ValueType> const& prismModel) const;
+
     std::shared_ptr<OpenMdp<ValueType>> root;
     std::unordered_map<std::string, std::shared_ptr<OpenMdp<ValueType>>> references;
+    size_t sharedLeafCount = 0;
+    size_t buildThreadCount = 1;
+    std::shared_ptr<storm::storage::LeafDiskCache<ValueType>> diskCache;
+    size_t loadedLeafCount = 0;
 };
 
 }  // namespace models
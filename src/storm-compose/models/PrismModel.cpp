@@ -1,8 +1,10 @@
 #include "PrismModel.h"
+#include <functional>
 #include <memory>
 #include "storm-compose/parser/StateValuationParser.h"
 #include "storm-parsers/api/storm-parsers.h"
 #include "storm/builder/ExplicitModelBuilder.h"
+#include "storm/builder/ExplorationOrder.h"
 #include "storm/generator/PrismNextStateGenerator.h"
 
 namespace storm {
@@ -35,29 +37,53 @@ template<typename ValueType>
 ConcreteMdp<ValueType> PrismModel<ValueType>::toConcreteMdp() {
     // 1) Load the PRISM file
     storm::builder::BuilderOptions buildOptions;
-    buildOptions.setBuildStateValuations();
     buildOptions.setBuildChoiceLabels();
     buildOptions.setBuildAllLabels();
 
     auto program = storm::api::parseProgram(getPath(), false, false);
     auto generator = std::make_shared<storm::generator::PrismNextStateGenerator<ValueType, uint32_t>>(program, buildOptions);
-    storm::builder::ExplicitModelBuilder<ValueType> mdpBuilder(generator);
+
+    // Entrances and exits only mention integer variables. Without Boolean variables they identify a single state, which is looked up in the state
+    // storage of the builder, so no state valuations are needed.
+    bool lookupInStateStorage = generator->getVariableInformation().booleanVariables.empty();
+    if (!lookupInStateStorage) {
+        buildOptions.setBuildStateValuations();
+        generator = std::make_shared<storm::generator::PrismNextStateGenerator<ValueType, uint32_t>>(program, buildOptions);
+    }
+
+    // With breadth-first exploration the state ids of the builder are the states of the model
+    typename storm::builder::ExplicitModelBuilder<ValueType>::Options builderOptions;
+    builderOptions.explorationOrder = storm::builder::ExplorationOrder::Bfs;
+    storm::builder::ExplicitModelBuilder<ValueType> mdpBuilder(generator, builderOptions);
 
     auto mdp = std::dynamic_pointer_cast<storm::models::sparse::Mdp<ValueType>>(mdpBuilder.build());
     auto& labeling = mdp->getStateLabeling();
 
     // 2) resolve entrances and exits
-    const auto& stateValuations = mdp->getStateValuations();
-    // TODO make efficient
+    std::function<boost::optional<uint64_t>(std::string const&)> findState;
+    boost::optional<storm::builder::ExplicitStateLookup<uint32_t>> stateLookup;
+    boost::optional<storm::parser::StateValuationParser> valuationParser;
+    if (lookupInStateStorage) {
+        stateLookup = mdpBuilder.exportExplicitStateLookup();
+        findState = [&](std::string const& entry) -> boost::optional<uint64_t> {
+            auto description = storm::parser::StateValuationParser::parseStateDescription(entry, generator->getVariableInformation());
+            uint64_t state = stateLookup->lookup(description);
+            if (state == stateLookup->size()) {
+                return boost::none;
+            }
+            return state;
+        };
+    } else {
+        valuationParser.emplace(mdp->getStateValuations());
+        findState = [&](std::string const& entry) { return mdp->getStateValuations().findState(valuationParser->parseStateValuation(entry)); };
+    }
 
-    storm::parser::StateValuationParser valuationParser(stateValuations);
     std::vector<size_t> lEntranceIdx, rEntranceIdx, lExitIdx, rExitIdx;
 
     auto processEntranceExit = [&](auto& source, auto& dest, bool entrance, bool left) {
         size_t count = 0;
         for (auto& entry : source) {
-            auto stateVal = valuationParser.parseStateValuation(entry);
-            auto optionalIndex = stateValuations.findState(stateVal);
+            auto optionalIndex = findState(entry);
             if (optionalIndex) {
                 dest.push_back(*optionalIndex);
                 std::string label = (std::string() + (left ? "l" : "r")) + (entrance ? "en" : "ex") + std::to_string(count);
@@ -13,7 +13,8 @@ template<class ValueType>
 BenchmarkStatsVisitor<ValueType>::BenchmarkStatsVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager,
                                                         storm::compose::benchmark::BenchmarkStats<ValueType>& stats)
     : manager(manager), stats(stats) {
-    // intentionally left empty
+    stats.sharedLeaves = manager->getSharedLeafCount();
+    stats.diskCacheLeafLoads = manager->getLoadedLeafCount();
 }
 
 template<class ValueType>
@@ -49,10 +50,11 @@ void BenchmarkStatsVisitor<ValueType>::visitReference(Reference<ValueType>& refe
     std::string referenceName = reference.getReference();
     auto openMdp = reference.getManager()->dereference(referenceName);
 
+    // References to shared leaves count as a single leaf
     if (openMdp->isConcreteMdp()) {
-        if (uniqueLeaves.find(referenceName) == uniqueLeaves.end()) {
+        if (uniqueLeaves.find(openMdp.get()) == uniqueLeaves.end()) {
             stats.uniqueLeaves += 1;
-            uniqueLeaves.insert(referenceName);
+            uniqueLeaves.insert(openMdp.get());
             visitingUniqueLeave = true;
         }
     }
@@ -26,7 +26,7 @@ class BenchmarkStatsVisitor : public OpenMdpVisitor<ValueType> {
     void increaseDepth();
     void decreaseDepth();
 
-    std::set<std::string> uniqueLeaves;
+    std::set<OpenMdp<ValueType>*> uniqueLeaves;
     bool visitingUniqueLeave = false;
     size_t depth = 0;
 };
@@ -4,7 +4,7 @@
 #include "storm-compose/modelchecker/ApproximateReachabilityResult.h"
 #include "storm-compose/modelchecker/MonolithicOpenMdpChecker.h"
 #include "storm-compose/models/ConcreteMdp.h"
-#include "storm-compose/models/visitor/LeafTransformer.h"
+#include "storm-compose/models/visitor/FlatMdpLayoutVisitor.h"
 #include "storm-compose/models/visitor/LowerUpperParetoVisitor.h"
 #include "utility/Stopwatch.h"
 
@@ -25,61 +25,52 @@ void BottomUpTermination<ValueType>::visitPrismModel(PrismModel<ValueType>& mode
 
 template<typename ValueType>
 void BottomUpTermination<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model) {
-    storm::utility::Stopwatch shortcutTimer;
+    auto version = leafVersions.find(&model);
+    if (version != leafVersions.end() && version->second == cache.getVersion(&model)) {
+        return;
+    }
 
     stats.shortcutMdpConstructionTime.start();
     lowerBounds[&model] = cache.toLowerBoundShortcutMdp(this->manager, &model);
     upperBounds[&model] = cache.toUpperBoundShortcutMdp(this->manager, &model);
     stats.shortcutMdpConstructionTime.stop();
-}
 
-// template<typename ValueType>
-// storm::modelchecker::ApproximateReachabilityResult<ValueType> BottomUpTermination<ValueType>::getReachabilityResult(
-//     storm::modelchecker::OpenMdpReachabilityTask task, storm::models::OpenMdp<ValueType>& openMdp) {
-//
-//     stats.bottomUpTerminationTime.start();
-//     LeafTransformer<ValueType> lowerBoundTransform([&](ConcreteMdp<ValueType>& concreteMdp) { return *lowerBounds[&concreteMdp]; });
-//     LeafTransformer<ValueType> upperBoundTransform([&](ConcreteMdp<ValueType>& concreteMdp) { return *upperBounds[&concreteMdp]; });
-//     openMdp.accept(lowerBoundTransform);
-//     openMdp.accept(upperBoundTransform);
-//
-//     auto lowerBoundShortcutMdp = lowerBoundTransform.getResult();
-//     auto upperBoundShortcutMdp = upperBoundTransform.getResult();
-//
-//     storm::modelchecker::MonolithicOpenMdpChecker<ValueType> lowerChecker(lowerBoundTransform.getManager(), stats);
-//     storm::modelchecker::MonolithicOpenMdpChecker<ValueType> upperChecker(upperBoundTransform.getManager(), stats);
-//
-//     auto lowerResult = lowerChecker.check(task);
-//     auto upperResult = upperChecker.check(task);
-//     stats.bottomUpTerminationTime.stop();
-//
-//     return storm::modelchecker::ApproximateReachabilityResult<ValueType>::combineLowerUpper(lowerResult, upperResult);
-// }
+    // Generating the shortcut MDPs initializes the Pareto curve of a new leaf, so the version is only read afterwards
+    leafVersions[&model] = cache.getVersion(&model);
+    updatedLeaves.insert(&model);
+    ++stats.shortcutMdpUpdates;
+}
 
 template<typename ValueType>
 storm::modelchecker::ApproximateReachabilityResult<ValueType> BottomUpTermination<ValueType>::getReachabilityResult(
     storm::modelchecker::OpenMdpReachabilityTask task, storm::models::OpenMdp<ValueType>& openMdp) {
-    storm::utility::Stopwatch transformTimer, reachabilityTimer;
-
-    transformTimer.start();
-    LeafTransformer<ValueType> lowerBoundTransform([&](ConcreteMdp<ValueType>& concreteMdp) {
-        // std::cout << "LB count: " << lowerBounds.count(&concreteMdp) << std::endl;
-        return *lowerBounds[&concreteMdp];
-    });
-    LeafTransformer<ValueType> upperBoundTransform([&](ConcreteMdp<ValueType>& concreteMdp) { return *upperBounds[&concreteMdp]; });
-    openMdp.accept(lowerBoundTransform);
-    openMdp.accept(upperBoundTransform);
-    transformTimer.stop();
+    storm::utility::Stopwatch updateTimer, reachabilityTimer;
 
-    reachabilityTimer.start();
-    storm::modelchecker::MonolithicOpenMdpChecker<ValueType> lowerChecker(lowerBoundTransform.getManager(), stats);
-    storm::modelchecker::MonolithicOpenMdpChecker<ValueType> upperChecker(upperBoundTransform.getManager(), stats);
+    updateTimer.start();
+    if (!flatModelsInitialized) {
+        initializeFlatModels(openMdp);
+    }
+    for (auto leaf : updatedLeaves) {
+        for (size_t offset : leafOffsets.at(leaf)) {
+            replaceLeafRows(lowerModel, *lowerBounds.at(leaf), offset);
+            replaceLeafRows(upperModel, *upperBounds.at(leaf), offset);
+        }
+    }
+    size_t updatedLeafCount = updatedLeaves.size();
+    updatedLeaves.clear();
 
-    auto lowerResult = lowerChecker.check(task);
-    auto upperResult = upperChecker.check(task);
+    auto lowerBoundShortcutMdp = buildFlatModel(lowerModel);
+    auto upperBoundShortcutMdp = buildFlatModel(upperModel);
+    updateTimer.stop();
+
+    reachabilityTimer.start();
+    storm::modelchecker::MonolithicOpenMdpChecker<ValueType> checker(manager, stats);
+    auto lowerResult = checker.checkConcreteMdp(lowerBoundShortcutMdp, task);
+    auto upperResult = checker.checkConcreteMdp(upperBoundShortcutMdp, task);
     reachabilityTimer.stop();
 
-    std::cout << "Transform time: " << transformTimer.getTimeInNanoseconds() * 1e-9 << std::endl;
+    std::cout << "Updated leaves: " << updatedLeafCount << std::endl;
+    std::cout << "Update time: " << updateTimer.getTimeInNanoseconds() * 1e-9 << std::endl;
     std::cout << "Reachability time: " << reachabilityTimer.getTimeInNanoseconds() * 1e-9 << std::endl;
     std::cout << "(Total) shortcut construction time " << stats.shortcutMdpConstructionTime.getTimeInNanoseconds() * 1e-9 << std::endl;
     // updateParetoStats();
@@ -87,6 +78,97 @@ storm::modelchecker::ApproximateReachabilityResult<ValueType> BottomUpTerminatio
     return storm::modelchecker::ApproximateReachabilityResult<ValueType>::combineLowerUpper(lowerResult, upperResult);
 }
 
+template<typename ValueType>
+void BottomUpTermination<ValueType>::initializeFlatModels(storm::models::OpenMdp<ValueType>& openMdp) {
+    // Lower and upper bound shortcut MDPs of a leaf have the same states, so both flat models share the layout
+    FlatMdpLayoutVisitor<ValueType> layoutVisitor(manager, [this](ConcreteMdp<ValueType>& leaf) -> ConcreteMdp<ValueType>& { return *lowerBounds.at(&leaf); });
+    openMdp.accept(layoutVisitor);
+
+    for (auto const& leaf : layoutVisitor.getLeaves()) {
+        leafOffsets[leaf.model].push_back(leaf.offset);
+        updatedLeaves.insert(leaf.model);
+    }
+
+    // All states without rows of a shortcut MDP are exits or sinks, they loop unless a composition redirects them
+    size_t stateCount = layoutVisitor.getStateCount();
+    lowerModel.stateRows.resize(stateCount);
+    for (size_t state = 0; state < stateCount; ++state) {
+        lowerModel.stateRows[state] = {{{state, storm::utility::one<ValueType>()}}};
+    }
+    for (auto const& redirect : layoutVisitor.getRedirects()) {
+        lowerModel.stateRows[redirect.first] = {{{redirect.second, storm::utility::one<ValueType>()}}};
+    }
+
+    auto const& layout = layoutVisitor.getLayout();
+    lowerModel.lEntrance = layout.lEntrance;
+    lowerModel.rEntrance = layout.rEntrance;
+    lowerModel.lExit = layout.lExit;
+    lowerModel.rExit = layout.rExit;
+    upperModel = lowerModel;
+
+    flatModelsInitialized = true;
+}
+
+template<typename ValueType>
+void BottomUpTermination<ValueType>::replaceLeafRows(FlatShortcutModel& flatModel, ConcreteMdp<ValueType> const& shortcutMdp, size_t offset) const {
+    auto const& transitionMatrix = shortcutMdp.getMdp()->getTransitionMatrix();
+    auto replaceRows = [&](std::vector<size_t> const& entrances) {
+        for (size_t entrance : entrances) {
+            auto& rows = flatModel.stateRows[offset + entrance];
+            rows.clear();
+            for (size_t action = 0; action < transitionMatrix.getRowGroupSize(entrance); ++action) {
+                rows.emplace_back();
+                for (auto const& entry : transitionMatrix.getRow(entrance, action)) {
+                    rows.back().emplace_back(offset + entry.getColumn(), entry.getValue());
+                }
+            }
+        }
+    };
+    replaceRows(shortcutMdp.getLEntrance());
+    replaceRows(shortcutMdp.getREntrance());
+}
+
+template<typename ValueType>
+ConcreteMdp<ValueType> BottomUpTermination<ValueType>::buildFlatModel(FlatShortcutModel const& flatModel) const {
+    size_t stateCount = flatModel.stateRows.size();
+    size_t rowCount = 0, entryCount = 0;
+    for (auto const& rows : flatModel.stateRows) {
+        rowCount += rows.size();
+        for (auto const& row : rows) {
+            entryCount += row.size();
+        }
+    }
+
+    storm::storage::SparseMatrixBuilder<ValueType> builder(rowCount, stateCount, entryCount, true, true, stateCount);
+    size_t currentRow = 0;
+    for (auto const& rows : flatModel.stateRows) {
+        builder.newRowGroup(currentRow);
+        for (auto const& row : rows) {
+            for (auto const& entry : row) {
+                builder.addNextValue(currentRow, entry.first, entry.second);
+            }
+            ++currentRow;
+        }
+    }
+
+    storm::models::sparse::StateLabeling labeling(stateCount);
+    labeling.addLabel("init");
+    auto addLabels = [&labeling](std::string const& prefix, std::vector<size_t> const& states) {
+        for (size_t i = 0; i < states.size(); ++i) {
+            std::string label = prefix + std::to_string(i);
+            labeling.addLabel(label);
+            labeling.addLabelToState(label, states[i]);
+        }
+    };
+    addLabels("len", flatModel.lEntrance);
+    addLabels("ren", flatModel.rEntrance);
+    addLabels("lex", flatModel.lExit);
+    addLabels("rex", flatModel.rExit);
+
+    auto mdp = std::make_shared<storm::models::sparse::Mdp<ValueType>>(builder.build(), labeling);
+    return ConcreteMdp<ValueType>(manager, mdp, flatModel.lEntrance, flatModel.rEntrance, flatModel.lExit, flatModel.rExit);
+}
+
 template<typename ValueType>
 void BottomUpTermination<ValueType>::updateParetoStats() {
     stats.lowerParetoPoints = cache.getLowerParetoPointCount();
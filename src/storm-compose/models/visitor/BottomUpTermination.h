@@ -1,5 +1,8 @@
 #pragma once
 
+#include <set>
+#include <unordered_map>
+
 #include "storm-compose/benchmark/BenchmarkStats.h"
 #include "storm-compose/modelchecker/AbstractOpenMdpChecker.h"
 #include "storm-compose/modelchecker/ApproximateReachabilityResult.h"
@@ -12,6 +15,11 @@ namespace storm {
 namespace models {
 namespace visitor {
 
+// Bounds the reachability probability of the diagram by replacing every leaf with the shortcut MDP of its lower and upper Pareto bounds.
+//
+// The visitor is meant to be kept between termination checks: shortcut MDPs are only regenerated for leaves whose bounds changed since the
+// previous check. The monolithic shortcut models are laid out once, their state space only depends on the entrances and exits of the
+// leaves, so an update only replaces the rows of the entrance states of each occurrence of the leaf.
 template<typename ValueType>
 class BottomUpTermination : public OpenMdpVisitor<ValueType> {
    public:
@@ -27,7 +35,26 @@ class BottomUpTermination : public OpenMdpVisitor<ValueType> {
     void updateParetoStats();
 
    private:
+    // Monolithic shortcut model, kept row by row so the rows of single states can be replaced
+    struct FlatShortcutModel {
+        std::vector<std::vector<std::vector<std::pair<uint64_t, ValueType>>>> stateRows;
+        std::vector<size_t> lEntrance, rEntrance, lExit, rExit;
+    };
+
+    void initializeFlatModels(storm::models::OpenMdp<ValueType>& openMdp);
+    void replaceLeafRows(FlatShortcutModel& flatModel, ConcreteMdp<ValueType> const& shortcutMdp, size_t offset) const;
+    ConcreteMdp<ValueType> buildFlatModel(FlatShortcutModel const& flatModel) const;
+
     std::map<ConcreteMdp<ValueType>*, std::shared_ptr<ConcreteMdp<ValueType>>> lowerBounds, upperBounds;
+    // Cache version of the bounds the shortcut MDPs were generated from
+    std::unordered_map<ConcreteMdp<ValueType>*, uint64_t> leafVersions;
+    std::set<ConcreteMdp<ValueType>*> updatedLeaves;
+
+    bool flatModelsInitialized = false;
+    FlatShortcutModel lowerModel, upperModel;
+    // State offsets of all occurrences of each leaf in the flat models
+    std::unordered_map<ConcreteMdp<ValueType>*, std::vector<size_t>> leafOffsets;
+
     storm::Environment env;
     std::shared_ptr<OpenMdpManager<ValueType>> manager;
     storm::storage::ParetoCache<ValueType>& cache;
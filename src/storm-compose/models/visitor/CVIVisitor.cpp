@@ -8,6 +8,7 @@
 #include "storage/SparseMatrix.h"
 #include "storm-compose/benchmark/BenchmarkStats.h"
 #include "storm-compose/modelchecker/CompositionalValueIteration.h"
+#include "storm-compose/modelchecker/WeightedReachabilityEngine.h"
 #include "storm-compose/models/visitor/EntranceExitVisitor.h"
 #include "storm-compose/models/visitor/ParetoVisitor.h"
 #include "storm-compose/storage/EntranceExit.h"
@@ -49,6 +50,7 @@ void CVIVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model) {
     if (allZero) {
         inputValues = std::vector<ValueType>(model.getEntranceCount(), 0);
     } else {
+        auto& leafProfile = stats.getLeafProfile(model);
         boost::optional<std::vector<ValueType>> result;
         result = queryCache(&model, weights);
 
@@ -56,10 +58,14 @@ void CVIVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model) {
         if (result) {
             inputValues = *result;
             ++stats.cacheHits;
+            ++leafProfile.cacheHits;
         } else {
+            ++leafProfile.cacheMisses;
+            auto solveStart = compose::benchmark::BenchmarkStats<ValueType>::Clock::now();
             stats.reachabilityComputationTime.start();
             auto newResult = weightedReachability(weights, model, cache->needScheduler(), env);
             stats.reachabilityComputationTime.stop();
+            stats.recordSolve(leafProfile, solveStart);
             auto weight = newResult.first;
             auto scheduler = newResult.second;
 
@@ -68,20 +74,7 @@ void CVIVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model) {
         }
     }
 
-    size_t weightIndex = 0;
-    for (size_t i = 0; i < model.getLEntrance().size(); ++i) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::L_ENTRANCE, i};
-        valueVector.setWeight(currentLeafId, pos, inputValues[weightIndex]);
-
-        ++weightIndex;
-    }
-
-    for (size_t i = 0; i < model.getREntrance().size(); ++i) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::R_ENTRANCE, i};
-        valueVector.setWeight(currentLeafId, pos, inputValues[weightIndex]);
-
-        ++weightIndex;
-    }
+    valueVector.setInputWeights(currentLeafId, inputValues);
 
     ++currentLeafId;
 }
@@ -105,112 +98,13 @@ void CVIVisitor<ValueType>::visitSumModel(SumModel<ValueType>& model) {
 template<typename ValueType>
 std::pair<std::vector<ValueType>, boost::optional<storm::storage::Scheduler<ValueType>>> CVIVisitor<ValueType>::weightedReachability(
     std::vector<ValueType> weights, ConcreteMdp<ValueType> const& concreteMdp, bool returnScheduler, storm::Environment env) {
-    // static size_t EXACT_QUERIES = 0;
-    // std::cout << "Exact queries: " << EXACT_QUERIES << " Mdp size: " << concreteMdp.getMdp()->getTransitionMatrix().getRowGroupCount() << std::endl;
-    //++EXACT_QUERIES;
-
-    if (false) {
-        std::ofstream f("out.dot");
-        concreteMdp.getMdp()->writeDotToStream(f);
-        f.close();
-    }
-    // std::cout << "V: ";
-    // for (const auto& v : weights) {
-    //     std::cout << v << " " << std::endl;
-    // }
-    // std::cout << std::endl;
-
-    using storm::models::sparse::Mdp;
-    auto mdp = concreteMdp.getMdp();
-    auto transitionMatrix = mdp->getTransitionMatrix();
-
-    std::map<size_t, storm::storage::Position> stateToPositionMap;
-    storm::storage::BitVector initialStates(transitionMatrix.getRowGroupCount());
-    size_t positionIndex = 0;
-    for (const auto& state : concreteMdp.getLEntrance()) {
-        initialStates.set(state);
-        stateToPositionMap[state] = {storage::L_ENTRANCE, positionIndex};
-
-        ++positionIndex;
-    }
-    positionIndex = 0;
-    for (const auto& state : concreteMdp.getREntrance()) {
-        initialStates.set(state);
-        stateToPositionMap[state] = {storage::R_ENTRANCE, positionIndex};
-
-        ++positionIndex;
-    }
-    mdp->setInitialStates(initialStates);
-
-    size_t weightIndex = 0;
-    std::map<size_t, ValueType> stateToWeightMap;
-    storm::storage::BitVector exitStates(transitionMatrix.getRowGroupCount());
-    for (const auto& state : concreteMdp.getLExit()) {
-        // std::cout << "state: " << state << " -> " << weights[weightIndex] << std::endl;
-        stateToWeightMap[state] = weights[weightIndex];
-        exitStates.set(state);
-
-        ++weightIndex;
-    }
-    for (const auto& state : concreteMdp.getRExit()) {
-        // std::cout << "state: " << state << " -> " << weights[weightIndex] << std::endl;
-        stateToWeightMap[state] = weights[weightIndex];
-        exitStates.set(state);
-
-        ++weightIndex;
-    }
-
-    storm::storage::SparseMatrixBuilder<ValueType> rewardMatrixBuilder(transitionMatrix.getRowCount(), transitionMatrix.getColumnCount(), 0, true, true,
-                                                                       transitionMatrix.getRowGroupCount());
-
-    for (size_t rowGroup = 0; rowGroup < transitionMatrix.getRowGroupCount(); ++rowGroup) {
-        size_t rowGroupStartIndex = transitionMatrix.getRowGroupIndices()[rowGroup];
-        rewardMatrixBuilder.newRowGroup(rowGroupStartIndex);
-        if (exitStates[rowGroup])
-            continue;
-
-        for (size_t action = 0; action < transitionMatrix.getRowGroupSize(rowGroup); ++action) {
-            auto row = transitionMatrix.getRow(rowGroup, action);
-
-            for (const auto& entry : row) {
-                auto column = entry.getColumn();
-                const auto it = stateToWeightMap.find(column);
-                if (it != stateToWeightMap.end()) {
-                    rewardMatrixBuilder.addNextValue(rowGroupStartIndex + action, column, it->second);
-                }
-            }
-        }
-    }
-
-    auto rewardMatrix = rewardMatrixBuilder.build();
-    // std::cout << "Reward Matrix: " << std::endl << rewardMatrix << std::endl;
-    storm::models::sparse::StandardRewardModel<ValueType> rewardModel(std::nullopt, std::nullopt, rewardMatrix);
-    STORM_LOG_ASSERT(transitionMatrix.isProbabilistic(), "not probabilistic");
-
-    auto result = modelchecker::helper::SparseMdpPrctlHelper<ValueType>::computeTotalRewards(
-        env, storm::solver::SolveGoal<ValueType>(false), transitionMatrix, mdp->getBackwardTransitions(), rewardModel, false, returnScheduler);
-    boost::optional<storm::storage::Scheduler<ValueType>> scheduler;
-    if (returnScheduler) {
-        scheduler = *result.scheduler;  // TODO prevent copy
-    }
-
-    std::vector<ValueType> newWeights(concreteMdp.getEntranceCount());
-
-    for (size_t state : initialStates) {
-        auto pos = stateToPositionMap.at(state);
-        size_t index = pos.second;
-        if (pos.first == storm::storage::R_ENTRANCE) {
-            index += concreteMdp.getLEntrance().size();
-        }
-        newWeights[index] = result.values[state];
-    }
-
-    return {newWeights, scheduler};
+    return concreteMdp.getReachabilityEngine()->solve(env, weights, returnScheduler);
 }
 
 template<typename ValueType>
 void CVIVisitor<ValueType>::visitTraceModel(TraceModel<ValueType>& model) {
-    STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Trace operator currently not supported");
+    // One sweep over the value, the values of the connected exits are the ones of the previous sweep
+    model.getValue()->accept(*this);
 }
 
 template<typename ValueType>
@@ -61,7 +61,8 @@ void EntranceExitMappingVisitor<ValueType>::visitSumModel(SumModel<ValueType>& m
 
 template<typename ValueType>
 void EntranceExitMappingVisitor<ValueType>::visitTraceModel(TraceModel<ValueType>& model) {
-    STORM_LOG_THROW(false, storm::exceptions::InvalidOperationException, "Not yet supported");
+    // The scope of the entrances does not change, connected entrances are still entrances of their leaves
+    model.getValue()->accept(*this);
 }
 
 // template <typename ValueType>
@@ -1,7 +1,14 @@
 #include "FlatMdpBuilderVisitor.h"
+
+#include <algorithm>
+
 #include "storm-compose/models/SequenceModel.h"
 #include "storm-compose/models/SumModel.h"
 #include "storm-compose/models/TraceModel.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/storage/BitVector.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/macros.h"
 
 namespace storm {
 namespace models {
@@ -13,7 +20,8 @@ using storm::storage::SparseMatrix;
 using storm::storage::SparseMatrixBuilder;
 
 template<typename ValueType>
-FlatMdpBuilderVisitor<ValueType>::FlatMdpBuilderVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager) : manager(manager), current(manager) {}
+FlatMdpBuilderVisitor<ValueType>::FlatMdpBuilderVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager, Substitution substitution)
+    : manager(manager), substitution(substitution), current(manager) {}
 
 template<typename ValueType>
 void FlatMdpBuilderVisitor<ValueType>::visitPrismModel(PrismModel<ValueType>& model) {
@@ -21,335 +29,206 @@ void FlatMdpBuilderVisitor<ValueType>::visitPrismModel(PrismModel<ValueType>& mo
 }
 
 template<typename ValueType>
-void FlatMdpBuilderVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model) {
-    // Model already concrete so we do not need to do anything.
-    // ConcreteMdp<ValueType> test = model;
-    current = model;
+void FlatMdpBuilderVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& visitedModel) {
+    ConcreteMdp<ValueType>& model = substitution ? substitution(visitedModel) : visitedModel;
+    if (depth == 0) {
+        // Model already concrete so we do not need to do anything.
+        current = model;
+        return;
+    }
+
+    size_t offset = stateCount;
+    auto shift = [offset](std::vector<size_t> const& states) {
+        std::vector<size_t> result;
+        result.reserve(states.size());
+        for (size_t state : states) {
+            result.push_back(offset + state);
+        }
+        return result;
+    };
+    layout.lEntrance = shift(model.getLEntrance());
+    layout.rEntrance = shift(model.getREntrance());
+    layout.lExit = shift(model.getLExit());
+    layout.rExit = shift(model.getRExit());
+
+    leaves.push_back({model.getMdp(), offset, &visitedModel});
+    stateCount += model.getMdp()->getNumberOfStates();
 }
 
 template<typename ValueType>
 void FlatMdpBuilderVisitor<ValueType>::visitSequenceModel(SequenceModel<ValueType>& model) {
-    // Obtain concrete MDPs
-    size_t totalStateCount = 0;
-    std::vector<ConcreteMdp<ValueType>> concreteMdps;
+    enterComposition();
+
+    std::vector<Layout> children;
     for (auto& m : model.getValues()) {
         m->accept(*this);
-        concreteMdps.push_back(current);  // TODO remove redundant copying
-        totalStateCount += current.getMdp()->getNumberOfStates();
-    }
-
-    // Stitch them together.
-    // This is done as follows:
-    // 1) Copy over the first matrix and connect the right exits to the left
-    //    entrances of the second matrix. Also connect left exists of the
-    //    second matrix to the right entrances of the first matrix.
-    // 2) Update the offset value, which keeps track of where in the matrix
-    //    we are. The offset is incremented by the state count of the first
-    //    matrix.
-    // 3) Repeat with all consecutive pairs of MDPs.
-    // 4) Afterwards, the left entrances and exists are exactly that of the
-    //    first MDP. The right entrances and exists are exactly that of the
-    //    last MDP + offset.
-    storm::storage::SparseMatrixBuilder<ValueType> builder(0, 0, 0, true, true);
-    storm::models::sparse::StateLabeling labeling(totalStateCount);
-    labeling.addLabel("init");
-    size_t offset = 0;
-    std::vector<size_t> lEntrance, lExit, rEntrance, rExit;
-
-    size_t currentRow = 0;
-    size_t currentEntrance = 0;
-    size_t currentExit = 0;
-
-    for (size_t v : concreteMdps[0].getLEntrance()) {
-        lEntrance.push_back(v);
-        std::string entranceLabel = "len" + std::to_string(currentEntrance);
-        labeling.addLabel(entranceLabel);
-        labeling.addLabelToState(entranceLabel, v);
-        ++currentEntrance;
-    }
-    for (size_t v : concreteMdps[0].getLExit()) {
-        lExit.push_back(v);
-        std::string exitLabel = "lex" + std::to_string(currentExit);
-        labeling.addLabel(exitLabel);
-        labeling.addLabelToState(exitLabel, v);
-        ++currentExit;
+        children.push_back(std::move(layout));
     }
 
-    for (size_t i = 0; i < concreteMdps.size(); ++i) {
-        const auto& c = concreteMdps[i];
-        const auto& transitionMatrix = c.getMdp()->getTransitionMatrix();
-        // Iterate over all states
-        size_t stateCount = transitionMatrix.getRowGroupCount();
-        for (size_t state = 0; state < stateCount; ++state) {
-            builder.newRowGroup(currentRow);
-
-            auto lExitPos = std::find(c.getLExit().begin(), c.getLExit().end(), state);
-            auto rExitPos = std::find(c.getRExit().begin(), c.getRExit().end(), state);
-            // TODO do the above using a map
-            // TODO cannot be both lExit and rExit
-
-            if (i != 0 && lExitPos != c.getLExit().end()) {
-                // State is a left exit
-                const auto& previous = concreteMdps[i - 1];
-                size_t exit = lExitPos - c.getLExit().begin();
-                size_t previousOffset = offset - previous.getMdp()->getNumberOfStates();
-                size_t entranceState = previousOffset + previous.getREntrance()[exit];
-
-                builder.addNextValue(currentRow++, entranceState, 1);
-            } else if (i != concreteMdps.size() - 1 && rExitPos != c.getRExit().end()) {
-                // State is a right exit
-                const auto& next = concreteMdps[i + 1];
-                size_t exit = rExitPos - c.getRExit().begin();
-                size_t nextOffset = offset + c.getMdp()->getNumberOfStates();
-                size_t entranceState = nextOffset + next.getLEntrance()[exit];
-
-                builder.addNextValue(currentRow++, entranceState, 1);
-            } else {
-                // State is not an exit
-
-                // Iterate over all actions
-                size_t actionCount = transitionMatrix.getRowGroupSize(state);
-                for (size_t action = 0; action < actionCount; ++action) {
-                    const auto& row = transitionMatrix.getRow(state, action);
-
-                    // Iterate over all entries
-                    for (const auto& entry : row) {
-                        // And add it to the new transition matrix
-                        builder.addNextValue(currentRow, offset + entry.getColumn(), entry.getValue());
-                    }
-                    ++currentRow;
-                }
+    // Right exits are connected to the left entrances of the next MDP, left exits to the right entrances of the previous MDP. A state that is
+    // both keeps the left exit connection, so these are recorded last.
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (i != children.size() - 1) {
+            for (size_t exit = 0; exit < children[i].rExit.size(); ++exit) {
+                redirect(children[i].rExit[exit], children[i + 1].lEntrance, exit);
+            }
+        }
+        if (i != 0) {
+            for (size_t exit = 0; exit < children[i].lExit.size(); ++exit) {
+                redirect(children[i].lExit[exit], children[i - 1].rEntrance, exit);
             }
         }
-
-        offset += stateCount;
     }
 
-    size_t lastIndex = concreteMdps.size() - 1;
-    size_t lastOffset = offset - concreteMdps[lastIndex].getMdp()->getNumberOfStates();
-    currentEntrance = 0;
-    for (size_t v : concreteMdps[lastIndex].getREntrance()) {
-        rEntrance.push_back(lastOffset + v);
-        std::string entranceLabel = "ren" + std::to_string(currentEntrance);
-        labeling.addLabel(entranceLabel);
-        labeling.addLabelToState(entranceLabel, lastOffset + v);
-        ++currentEntrance;
-    }
-    currentExit = 0;
-    for (size_t v : concreteMdps[lastIndex].getRExit()) {
-        rExit.push_back(lastOffset + v);
-        std::string exitLabel = "rex" + std::to_string(currentExit);
-        labeling.addLabel(exitLabel);
-        labeling.addLabelToState(exitLabel, lastOffset + v);
-        ++currentExit;
-    }
+    // The left entrances and exits are those of the first MDP, the right ones those of the last MDP
+    layout.lEntrance = std::move(children.front().lEntrance);
+    layout.lExit = std::move(children.front().lExit);
+    layout.rEntrance = std::move(children.back().rEntrance);
+    layout.rExit = std::move(children.back().rExit);
 
-    auto newMdp = std::make_shared<Mdp<ValueType>>(builder.build(), labeling);
-    current = ConcreteMdp<ValueType>(manager, newMdp, lEntrance, rEntrance, lExit, rExit);
+    leaveComposition(true);
 }
 
 template<typename ValueType>
 void FlatMdpBuilderVisitor<ValueType>::visitSumModel(SumModel<ValueType>& model) {
-    // Obtain concrete MDPs
-    std::vector<ConcreteMdp<ValueType>> concreteMdps;
-    size_t totalStateCount = 0;
+    enterComposition();
+
+    Layout sum;
+    auto append = [](std::vector<size_t>& target, std::vector<size_t> const& source) { target.insert(target.end(), source.begin(), source.end()); };
     for (auto& m : model.getValues()) {
         m->accept(*this);
-        concreteMdps.push_back(current);  // TODO remove redundant copying
-        totalStateCount += current.getMdp()->getNumberOfStates();
+        append(sum.lEntrance, layout.lEntrance);
+        append(sum.rEntrance, layout.rEntrance);
+        append(sum.lExit, layout.lExit);
+        append(sum.rExit, layout.rExit);
     }
+    layout = std::move(sum);
 
-    // Stitch them together.
-    storm::storage::SparseMatrixBuilder<ValueType> builder(0, 0, 0, true, true);
-    storm::models::sparse::StateLabeling labeling(totalStateCount);
-
-    size_t offset = 0;
-    std::vector<size_t> lEntrance, lExit, rEntrance, rExit;
-
-    size_t leftExitCount = 0, rightExitCount = 0, leftEntranceCount = 0, rightEntranceCount = 0;
-    size_t currentRow = 0;
-    for (const auto& c : concreteMdps) {
-        const auto& transitionMatrix = c.getMdp()->getTransitionMatrix();
-        // Iterate over all states
-        size_t stateCount = transitionMatrix.getRowGroupCount();
-        for (size_t state = 0; state < stateCount; ++state) {
-            builder.newRowGroup(currentRow);
-
-            // Iterate over all actions
-            size_t actionCount = transitionMatrix.getRowGroupSize(state);
-            for (size_t action = 0; action < actionCount; ++action) {
-                const auto& row = transitionMatrix.getRow(state, action);
-
-                // Iterate over all entries
-                for (const auto& entry : row) {
-                    // And add it to the new transition matrix
-                    builder.addNextValue(currentRow, offset + entry.getColumn(), entry.getValue());
-                }
-
-                ++currentRow;
-            }
-        }
-
-        for (size_t v : c.getLEntrance()) {
-            lEntrance.push_back(offset + v);
+    leaveComposition(false);
+}
 
-            std::string label = "len" + std::to_string(leftEntranceCount);
-            labeling.addLabel(label);
-            labeling.addLabelToState(label, offset + v);
-            ++leftEntranceCount;
-        }
+template<typename ValueType>
+void FlatMdpBuilderVisitor<ValueType>::visitTraceModel(TraceModel<ValueType>& model) {
+    enterComposition();
 
-        for (size_t v : c.getREntrance()) {
-            rEntrance.push_back(offset + v);
+    model.value->accept(*this);
 
-            std::string label = "ren" + std::to_string(rightEntranceCount);
-            labeling.addLabel(label);
-            labeling.addLabelToState(label, offset + v);
-            ++rightEntranceCount;
+    // The first exits are connected to the corresponding entrances on the other side, the remaining exits get a self loop. A state that is
+    // both a left and a right exit keeps the left exit transition.
+    for (size_t exit = 0; exit < layout.rExit.size(); ++exit) {
+        if (exit < model.right) {
+            redirect(layout.rExit[exit], layout.lEntrance, exit);
+        } else {
+            redirects.emplace_back(layout.rExit[exit], layout.rExit[exit]);
         }
-
-        for (size_t v : c.getLExit()) {
-            lExit.push_back(offset + v);
-
-            std::string label = "lex" + std::to_string(leftExitCount);
-            labeling.addLabel(label);
-            labeling.addLabelToState(label, offset + v);
-            ++leftExitCount;
+    }
+    for (size_t exit = 0; exit < layout.lExit.size(); ++exit) {
+        if (exit < model.left) {
+            redirect(layout.lExit[exit], layout.rEntrance, exit);
+        } else {
+            redirects.emplace_back(layout.lExit[exit], layout.lExit[exit]);
         }
+    }
 
-        for (size_t v : c.getRExit()) {
-            rExit.push_back(offset + v);
+    auto dropFront = [](std::vector<size_t>& states, size_t count) { states.erase(states.begin(), states.begin() + std::min(count, states.size())); };
+    dropFront(layout.rEntrance, model.left);
+    dropFront(layout.lExit, model.left);
+    dropFront(layout.lEntrance, model.right);
+    dropFront(layout.rExit, model.right);
 
-            std::string label = "rex" + std::to_string(rightExitCount);
-            labeling.addLabel(label);
-            labeling.addLabelToState(label, offset + v);
-            ++rightExitCount;
-        }
+    leaveComposition(true);
+}
 
-        offset += stateCount;
+template<typename ValueType>
+void FlatMdpBuilderVisitor<ValueType>::enterComposition() {
+    if (depth == 0) {
+        layout = Layout();
+        leaves.clear();
+        stateCount = 0;
+        redirects.clear();
     }
-
-    auto newMdp = std::make_shared<Mdp<ValueType>>(builder.build(), labeling);
-    current = ConcreteMdp<ValueType>(manager, newMdp, lEntrance, rEntrance, lExit, rExit);
+    ++depth;
 }
 
 template<typename ValueType>
-void FlatMdpBuilderVisitor<ValueType>::visitTraceModel(TraceModel<ValueType>& model) {
-    // Obtain concrete MDP
-    model.value->accept(*this);
+void FlatMdpBuilderVisitor<ValueType>::leaveComposition(bool addInitLabel) {
+    --depth;
+    if (depth == 0) {
+        build(addInitLabel);
+    }
+}
 
-    // We ignore transitions that are present in the exits.  We simply add
-    // an unique action that goes to the corresponding entrance with
-    // probability 0.
+template<typename ValueType>
+void FlatMdpBuilderVisitor<ValueType>::redirect(size_t exitState, std::vector<size_t> const& entrances, size_t index) {
+    STORM_LOG_THROW(index < entrances.size(), storm::exceptions::InvalidArgumentException,
+                    "Exit " << index << " is connected to a side with only " << entrances.size() << " entrances");
+    redirects.emplace_back(exitState, entrances[index]);
+}
 
-    storm::storage::SparseMatrixBuilder<ValueType> builder(0, 0, 0, true, true);
-    const size_t totalStateCount = current.getMdp()->getNumberOfStates();
-    storm::models::sparse::StateLabeling labeling(totalStateCount);
-    labeling.addLabel("init");
-    size_t currentRow = 0;
+template<typename ValueType>
+void FlatMdpBuilderVisitor<ValueType>::build(bool addInitLabel) {
+    storm::storage::BitVector redirected(stateCount);
+    std::vector<size_t> target(stateCount);
+    for (auto const& r : redirects) {
+        redirected.set(r.first);
+        target[r.first] = r.second;
+    }
 
-    const auto& transitionMatrix = current.getMdp()->getTransitionMatrix();
-    // Iterate over all states
-    size_t stateCount = transitionMatrix.getRowGroupCount();
-    for (size_t state = 0; state < stateCount; ++state) {
-        builder.newRowGroup(currentRow);
-
-        auto lExitPos = std::find(current.getLExit().begin(), current.getLExit().end(), state);
-        auto rExitPos = std::find(current.getRExit().begin(), current.getRExit().end(), state);
-        // TODO do the above using a map
-        // TODO cannot be both lExit and rExit
-
-        bool isExit = false;
-        if (lExitPos != current.getLExit().end()) {
-            isExit = true;
-
-            // State is a left exit
-            size_t exit = lExitPos - current.getLExit().begin();
-            if (exit >= model.left) {
-                builder.addNextValue(currentRow++, state, 1);
+    // Count rows and entries first, so the builder never reallocates
+    size_t rowCount = 0, entryCount = 0;
+    for (auto const& leaf : leaves) {
+        auto const& transitionMatrix = leaf.mdp->getTransitionMatrix();
+        for (size_t state = 0; state < transitionMatrix.getRowGroupCount(); ++state) {
+            if (redirected.get(leaf.offset + state)) {
+                ++rowCount;
+                ++entryCount;
             } else {
-                size_t entranceState = current.getREntrance()[exit];
-                builder.addNextValue(currentRow++, entranceState, 1);
+                rowCount += transitionMatrix.getRowGroupSize(state);
+                entryCount += transitionMatrix.getRowGroupEntryCount(state);
             }
-        } else if (rExitPos != current.getRExit().end()) {
-            isExit = true;
+        }
+    }
 
-            // State is a right exit
-            size_t exit = rExitPos - current.getRExit().begin();
-            if (exit >= model.right) {
-                builder.addNextValue(currentRow++, state, 1);
-            } else {
-                size_t entranceState = current.getLEntrance()[exit];
-                builder.addNextValue(currentRow++, entranceState, 1);
+    SparseMatrixBuilder<ValueType> builder(rowCount, stateCount, entryCount, true, true, stateCount);
+    size_t currentRow = 0;
+    for (auto const& leaf : leaves) {
+        auto const& transitionMatrix = leaf.mdp->getTransitionMatrix();
+        for (size_t state = 0; state < transitionMatrix.getRowGroupCount(); ++state) {
+            builder.newRowGroup(currentRow);
+            if (redirected.get(leaf.offset + state)) {
+                builder.addNextValue(currentRow++, target[leaf.offset + state], storm::utility::one<ValueType>());
+                continue;
             }
-        }
-        if (isExit)
-            continue;
-        // State is not an exit
-
-        // Iterate over all actions
-        size_t actionCount = transitionMatrix.getRowGroupSize(state);
-        for (size_t action = 0; action < actionCount; ++action) {
-            const auto& row = transitionMatrix.getRow(state, action);
-
-            // Iterate over all entries
-            for (const auto& entry : row) {
-                // And add it to the new transition matrix
-                builder.addNextValue(currentRow, entry.getColumn(), entry.getValue());
+            for (size_t action = 0; action < transitionMatrix.getRowGroupSize(state); ++action) {
+                for (auto const& entry : transitionMatrix.getRow(state, action)) {
+                    builder.addNextValue(currentRow, leaf.offset + entry.getColumn(), entry.getValue());
+                }
+                ++currentRow;
             }
-            ++currentRow;
         }
     }
 
-    for (size_t i = builder.getCurrentRowGroupCount(); i < totalStateCount; ++i) {
-        builder.newRowGroup(currentRow);
-        builder.addNextValue(currentRow, i, 1);
-        ++currentRow;
-    }
-
-    size_t currentEntrance = 0;
-    std::vector<size_t> lEntrance, lExit, rEntrance, rExit;
-    for (size_t i = model.left; i < current.getREntrance().size(); ++i) {
-        rEntrance.push_back(current.getREntrance()[i]);
-
-        std::string label = "ren" + std::to_string(currentEntrance);
-        labeling.addLabel(label);
-        labeling.addLabelToState(label, current.getREntrance()[i]);
-        ++currentEntrance;
-    }
-
-    currentEntrance = 0;
-    for (size_t i = model.right; i < current.getLEntrance().size(); ++i) {
-        lEntrance.push_back(current.getLEntrance()[i]);
-
-        std::string label = "len" + std::to_string(currentEntrance);
-        labeling.addLabel(label);
-        labeling.addLabelToState(label, current.getLEntrance()[i]);
-        ++currentEntrance;
-    }
-
-    size_t currentExit = 0;
-    for (size_t i = model.left; i < current.getLExit().size(); ++i) {
-        lExit.push_back(current.getLExit()[i]);
-
-        std::string label = "lex" + std::to_string(currentExit);
-        labeling.addLabel(label);
-        labeling.addLabelToState(label, current.getLExit()[i]);
-        ++currentExit;
-    }
-
-    currentExit = 0;
-    for (size_t i = model.right; i < current.getRExit().size(); ++i) {
-        rExit.push_back(current.getRExit()[i]);
-
-        std::string label = "rex" + std::to_string(currentExit);
-        labeling.addLabel(label);
-        labeling.addLabelToState(label, current.getRExit()[i]);
-        ++currentExit;
+    storm::models::sparse::StateLabeling labeling(stateCount);
+    if (addInitLabel) {
+        labeling.addLabel("init");
     }
+    auto addLabels = [&labeling](std::string const& prefix, std::vector<size_t> const& states) {
+        for (size_t i = 0; i < states.size(); ++i) {
+            std::string label = prefix + std::to_string(i);
+            labeling.addLabel(label);
+            labeling.addLabelToState(label, states[i]);
+        }
+    };
+    addLabels("len", layout.lEntrance);
+    addLabels("ren", layout.rEntrance);
+    addLabels("lex", layout.lExit);
+    addLabels("rex", layout.rExit);
 
     auto newMdp = std::make_shared<Mdp<ValueType>>(builder.build(), labeling);
-    current = ConcreteMdp<ValueType>(manager, newMdp, lEntrance, rEntrance, lExit, rExit);
+    current = ConcreteMdp<ValueType>(manager, newMdp, layout.lEntrance, layout.rEntrance, layout.lExit, layout.rExit);
+
+    leaves.clear();
+    redirects.clear();
 }
 
 template<typename ValueType>
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include "OpenMdpVisitor.h"
 #include "storm-compose/models/ConcreteMdp.h"
 #include "storm-compose/models/OpenMdp.h"
@@ -9,10 +11,19 @@ namespace storm {
 namespace models {
 namespace visitor {
 
+// Builds the monolithic MDP of a string diagram.
+//
+// The visit methods only lay out the diagram: every leaf gets a state offset, and each composition records which exit states are redirected
+// to which entrance states. Once the outermost composition has been visited, the transition matrix is streamed into a single preallocated
+// builder, so no intermediate MDP is created for the inner compositions.
+//
+// Optionally, every leaf is replaced by the MDP returned by the substitution (e.g. a shortcut MDP with the same entrances and exits).
 template<typename ValueType>
 class FlatMdpBuilderVisitor : public OpenMdpVisitor<ValueType> {
    public:
-    FlatMdpBuilderVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager);
+    typedef std::function<ConcreteMdp<ValueType>&(ConcreteMdp<ValueType>&)> Substitution;
+
+    FlatMdpBuilderVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager, Substitution substitution = nullptr);
 
     void visitPrismModel(PrismModel<ValueType>& model) override;
     void visitConcreteModel(ConcreteMdp<ValueType>& model) override;
@@ -26,10 +37,37 @@ class FlatMdpBuilderVisitor : public OpenMdpVisitor<ValueType> {
 
     ConcreteMdp<ValueType> getCurrent();
 
+    // Entrances and exits of the last visited node, as states of the monolithic MDP
+    struct Layout {
+        std::vector<size_t> lEntrance, rEntrance, lExit, rExit;
+    };
+
+    struct Leaf {
+        std::shared_ptr<storm::models::sparse::Mdp<ValueType>> mdp;
+        size_t offset;
+        ConcreteMdp<ValueType>* model;  // The visited leaf (before substitution)
+    };
+
    protected:
+    /// Starts a new layout if the visited node is the root
+    void enterComposition();
+    /// Builds the MDP if the visited node is the root
+    void leaveComposition(bool addInitLabel);
+
+    /// Redirects the exit state to the entrance with the given index
+    void redirect(size_t exitState, std::vector<size_t> const& entrances, size_t index);
+    virtual void build(bool addInitLabel);
+
     std::shared_ptr<OpenMdpManager<ValueType>> manager;
-    // boost::optional<ConcreteMdp<ValueType>> current;
+    Substitution substitution;
     ConcreteMdp<ValueType> current;
+
+    size_t depth = 0;
+    Layout layout;
+    std::vector<Leaf> leaves;
+    size_t stateCount = 0;
+    // Redirects in the order they were recorded, outer compositions come later and take precedence
+    std::vector<std::pair<size_t, size_t>> redirects;
 };
 
 }  // namespace visitor
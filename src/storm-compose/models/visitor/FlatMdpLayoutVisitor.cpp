@@ -0,0 +1,52 @@
+#include "FlatMdpLayoutVisitor.h"
+
+#include "storm/adapters/RationalNumberAdapter.h"
+
+namespace storm {
+namespace models {
+namespace visitor {
+
+template<typename ValueType>
+FlatMdpLayoutVisitor<ValueType>::FlatMdpLayoutVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager,
+                                                      typename FlatMdpBuilderVisitor<ValueType>::Substitution substitution)
+    : FlatMdpBuilderVisitor<ValueType>(manager, substitution) {}
+
+template<typename ValueType>
+void FlatMdpLayoutVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model) {
+    // A plain leaf is laid out like a composition with a single child
+    this->enterComposition();
+    FlatMdpBuilderVisitor<ValueType>::visitConcreteModel(model);
+    this->leaveComposition(false);
+}
+
+template<typename ValueType>
+typename FlatMdpBuilderVisitor<ValueType>::Layout const& FlatMdpLayoutVisitor<ValueType>::getLayout() const {
+    return this->layout;
+}
+
+template<typename ValueType>
+std::vector<typename FlatMdpBuilderVisitor<ValueType>::Leaf> const& FlatMdpLayoutVisitor<ValueType>::getLeaves() const {
+    return this->leaves;
+}
+
+template<typename ValueType>
+std::vector<std::pair<size_t, size_t>> const& FlatMdpLayoutVisitor<ValueType>::getRedirects() const {
+    return this->redirects;
+}
+
+template<typename ValueType>
+size_t FlatMdpLayoutVisitor<ValueType>::getStateCount() const {
+    return this->stateCount;
+}
+
+template<typename ValueType>
+void FlatMdpLayoutVisitor<ValueType>::build(bool) {
+    // Only the layout is kept
+}
+
+template class FlatMdpLayoutVisitor<double>;
+template class FlatMdpLayoutVisitor<storm::RationalNumber>;
+
+}  // namespace visitor
+}  // namespace models
+}  // namespace storm
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "FlatMdpBuilderVisitor.h"
+
+namespace storm {
+namespace models {
+namespace visitor {
+
+// Performs the layout pass of FlatMdpBuilderVisitor and keeps the layout instead of building the monolithic MDP.
+template<typename ValueType>
+class FlatMdpLayoutVisitor : public FlatMdpBuilderVisitor<ValueType> {
+   public:
+    FlatMdpLayoutVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager,
+                         typename FlatMdpBuilderVisitor<ValueType>::Substitution substitution = nullptr);
+
+    void visitConcreteModel(ConcreteMdp<ValueType>& model) override;
+
+    typename FlatMdpBuilderVisitor<ValueType>::Layout const& getLayout() const;
+    std::vector<typename FlatMdpBuilderVisitor<ValueType>::Leaf> const& getLeaves() const;
+    /// Exit states and the states they lead to, later redirects take precedence
+    std::vector<std::pair<size_t, size_t>> const& getRedirects() const;
+    size_t getStateCount() const;
+
+   protected:
+    void build(bool addInitLabel) override;
+};
+
+}  // namespace visitor
+}  // namespace models
+}  // namespace storm
@@ -51,7 +51,7 @@ void LeafTransformer<ValueType>::visitSumModel(SumModel<ValueType>& model) {
 
 template<typename ValueType>
 void LeafTransformer<ValueType>::visitTraceModel(TraceModel<ValueType>& model) {
-    model.accept(*this);
+    model.getValue()->accept(*this);
     result = std::make_shared<TraceModel<ValueType>>(this->manager, result, model.getLeft(), model.getRight());
 }
 
@@ -1,7 +1,7 @@
 #include "MappingVisitor.h"
 #include "exceptions/InvalidArgumentException.h"
 #include "exceptions/InvalidOperationException.h"
-#include "exceptions/NotSupportedException.h"
+#include "storm-compose/models/TraceModel.h"
 #include "storm-compose/storage/EntranceExit.h"
 
 namespace storm {
@@ -19,6 +19,7 @@ void MappingVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model
     outerPositions = {};
     entranceExitStartIndices[currentLeafId] = {leftEntrancePos, rightEntrancePos, leftExitPos, rightExitPos};
     leaves.push_back(&model);
+    leafOrigins.push_back({currentOriginalLeafId, nullptr});
 
     auto processEntranceExit = [&](const auto& list, storage::EntranceExit entranceExit, auto& entranceExitPos) {
         for (size_t i = 0; i < list.size(); ++i) {
@@ -35,6 +36,7 @@ void MappingVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model
     processEntranceExit(model.getRExit(), storage::R_EXIT, rightExitPos);
 
     ++currentLeafId;
+    ++currentOriginalLeafId;
 }
 
 template<typename ValueType>
@@ -45,6 +47,10 @@ void MappingVisitor<ValueType>::visitReference(Reference<ValueType>& reference)
 
 template<typename ValueType>
 void MappingVisitor<ValueType>::visitSequenceModel(SequenceModel<ValueType>& model) {
+    if (visitSummary(model)) {
+        return;
+    }
+
     STORM_LOG_THROW(model.getValues().size() > 0, storm::exceptions::InvalidArgumentException, "expected >0 children");
 
     std::map<std::pair<size_t, storage::Position>, size_t> mapping;
@@ -77,7 +83,7 @@ void MappingVisitor<ValueType>::visitSequenceModel(SequenceModel<ValueType>& mod
         size_t offset = mapping.size();
 
         for (const auto& entry : nextMapping) {
-            auto pos = entry.first.second;
+            auto pos = getOuterPosition(entry.first);
 
             bool isLeft = pos.first == storage::L_ENTRANCE || pos.first == storage::L_EXIT;
             if (isLeft) {
@@ -88,7 +94,7 @@ void MappingVisitor<ValueType>::visitSequenceModel(SequenceModel<ValueType>& mod
                     // Map to correct shared index
                     bool inserted = false;
                     for (const auto& key : prevOuter) {
-                        if (key.second == matchedPosition) {
+                        if (getOuterPosition(key) == matchedPosition) {
                             mapping.insert({entry.first, mapping[key]});
                             inserted = true;
                             break;
@@ -119,6 +125,10 @@ void MappingVisitor<ValueType>::visitSequenceModel(SequenceModel<ValueType>& mod
 
 template<typename ValueType>
 void MappingVisitor<ValueType>::visitSumModel(SumModel<ValueType>& model) {
+    if (visitSummary(model)) {
+        return;
+    }
+
     std::map<std::pair<size_t, storage::Position>, size_t> mapping;
     std::set<std::pair<size_t, storage::Position>> outer;
 
@@ -143,19 +153,59 @@ void MappingVisitor<ValueType>::visitSumModel(SumModel<ValueType>& model) {
 
 template<typename ValueType>
 void MappingVisitor<ValueType>::visitTraceModel(TraceModel<ValueType>& model) {
-    STORM_LOG_THROW(false, storm::exceptions::NotSupportedException, "Trace operator is currently not supported");
     model.getValue()->accept(*this);
 
-    size_t left = model.getLeft();
-    size_t right = model.getRight();
+    // The positions of the value are numbered from its first outer position of each kind. As in FlatMdpBuilderVisitor, the first right exits
+    // are connected to the left entrances and the first left exits to the right entrances.
+    std::map<storage::EntranceExit, size_t> firstPosition;
+    for (const auto& key : outerPositions) {
+        auto pos = getOuterPosition(key);
+        auto it = firstPosition.find(pos.first);
+        if (it == firstPosition.end() || pos.second < it->second) {
+            firstPosition[pos.first] = pos.second;
+        }
+    }
+    auto getTracePosition = [&](Key const& key) {
+        auto pos = getOuterPosition(key);
+        return storage::Position{pos.first, pos.second - firstPosition.at(pos.first)};
+    };
+    auto isConnected = [&](storage::Position const& pos) {
+        bool isRightward = pos.first == storage::L_ENTRANCE || pos.first == storage::R_EXIT;
+        return pos.second < (isRightward ? model.getRight() : model.getLeft());
+    };
 
-    // Map 0..left-1 exits to the same index as their right entrance counterpart
-    for (size_t i = 0; i < left; ++i) {
+    std::map<storage::Position, Key> entrances;
+    std::map<storage::EntranceExit, size_t> connectedCounts;
+    for (const auto& key : outerPositions) {
+        auto pos = getTracePosition(key);
+        if (pos.first == storage::L_ENTRANCE || pos.first == storage::R_ENTRANCE) {
+            entrances.insert({pos, key});
+        }
+        if (isConnected(pos)) {
+            ++connectedCounts[pos.first];
+        }
     }
 
-    // Map 0..right-1 exits to the same index as their left entrance counterpart
-    for (size_t i = 0; i < right; ++i) {
+    // Connected exits share the value index of their entrance, the remaining positions are renumbered from zero
+    std::set<Key> outer;
+    for (const auto& key : outerPositions) {
+        auto pos = getTracePosition(key);
+        if (!isConnected(pos)) {
+            outer.insert(key);
+            positionShifts[key] += connectedCounts[pos.first];
+        } else if (pos.first == storage::L_EXIT || pos.first == storage::R_EXIT) {
+            auto entrance = entrances.find(storage::positionMatch(pos));
+            STORM_LOG_THROW(entrance != entrances.end(), storm::exceptions::InvalidArgumentException,
+                            "Exit " << pos.second << " is connected to a side with only " << connectedCounts[storage::match(pos.first)] << " entrances");
+            localMapping[key] = localMapping.at(entrance->second);
+        }
     }
+    outerPositions = outer;
+
+    leftEntrancePos -= connectedCounts[storage::L_ENTRANCE];
+    rightEntrancePos -= connectedCounts[storage::R_ENTRANCE];
+    leftExitPos -= connectedCounts[storage::L_EXIT];
+    rightExitPos -= connectedCounts[storage::R_EXIT];
 }
 
 template<typename ValueType>
@@ -229,6 +279,33 @@ void MappingVisitor<ValueType>::performPostProcessing() {
     // std::cout << "After: " << localMapping.size() << std::endl;
 }
 
+template<typename ValueType>
+std::vector<typename MappingVisitor<ValueType>::LeafOrigin> const& MappingVisitor<ValueType>::getLeafOrigins() const {
+    return leafOrigins;
+}
+
+template<typename ValueType>
+bool MappingVisitor<ValueType>::visitSummary(OpenMdp<ValueType>& model) {
+    auto summary = summaries.find(&model);
+    if (summary == summaries.end()) {
+        return false;
+    }
+
+    visitConcreteModel(*summary->second->mdp);
+    leafOrigins.back().second = summary->second;
+    currentOriginalLeafId += summary->second->leafCount - 1;
+    return true;
+}
+
+template<typename ValueType>
+storage::Position MappingVisitor<ValueType>::getOuterPosition(Key const& key) const {
+    auto shift = positionShifts.find(key);
+    if (shift == positionShifts.end()) {
+        return key.second;
+    }
+    return {key.second.first, key.second.second - shift->second};
+}
+
 template<typename ValueType>
 void MappingVisitor<ValueType>::resetPos() {
     leftEntrancePos = 0;
@@ -2,6 +2,7 @@
 
 #include "EntranceExitVisitor.h"
 #include "OpenMdpVisitor.h"
+#include "SubtreeSummaryVisitor.h"
 #include "exceptions/InvalidOperationException.h"
 #include "storm-compose/models/PrismModel.h"
 #include "storm-compose/models/Reference.h"
@@ -24,7 +25,13 @@ class MappingVisitor : public OpenMdpVisitor<ValueType> {
     typedef std::pair<size_t, storage::Position> Key;
 
    public:
+    typedef typename SubtreeSummaryVisitor<ValueType>::SummaryMap SummaryMap;
+    /// First leaf occurrence of the diagram that a leaf of the mapping stands for, and its summary if it summarizes a subtree
+    typedef std::pair<size_t, std::shared_ptr<SubtreeSummary<ValueType> const>> LeafOrigin;
+
     MappingVisitor() {}
+    /// Summarized subtrees are mapped as a single leaf
+    MappingVisitor(SummaryMap summaries) : summaries(std::move(summaries)) {}
     virtual ~MappingVisitor() override {}
 
     virtual void visitPrismModel(PrismModel<ValueType>& model) override;
@@ -36,20 +43,28 @@ class MappingVisitor : public OpenMdpVisitor<ValueType> {
 
     storage::ValueVectorMapping<ValueType> getMapping();
     void performPostProcessing();
+    std::vector<LeafOrigin> const& getLeafOrigins() const;
 
    private:
     void resetPos();
+    /// Position of an outer key as seen from the enclosing composition, traces renumber the positions they do not connect
+    storage::Position getOuterPosition(Key const& key) const;
+    bool visitSummary(OpenMdp<ValueType>& model);
 
     std::map<Key, size_t> localMapping;
     std::set<Key> outerPositions;
+    std::map<Key, size_t> positionShifts;
 
     /// Maps leafId -> <lEntranceStart, rEntranceStart, lExitStart, rExitStart>
     std::map<size_t, std::tuple<size_t, size_t, size_t, size_t>> entranceExitStartIndices;
     std::vector<ConcreteMdp<ValueType>*> leaves;
+    std::vector<LeafOrigin> leafOrigins;
+    SummaryMap summaries;
 
     size_t leftEntrancePos = 0, rightEntrancePos = 0, leftExitPos = 0, rightExitPos = 0;
     size_t currentSequencePosition = 0;
     size_t currentLeafId = 0;
+    size_t currentOriginalLeafId = 0;
 };
 
 }  // namespace visitor
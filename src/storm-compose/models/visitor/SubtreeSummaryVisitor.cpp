@@ -0,0 +1,157 @@
+#include "SubtreeSummaryVisitor.h"
+
+#include <algorithm>
+#include <string>
+
+#include "storm-compose/models/visitor/FlatMdpLayoutVisitor.h"
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/exceptions/InvalidOperationException.h"
+#include "storm/utility/macros.h"
+
+namespace storm {
+namespace models {
+namespace visitor {
+
+template<typename ValueType>
+SubtreeSummaryVisitor<ValueType>::SubtreeSummaryVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager, storm::storage::ParetoCache<ValueType>& cache,
+                                                        std::function<bool(ConcreteMdp<ValueType>*)> isStable, SummaryMap previousSummaries)
+    : manager(manager), cache(cache), isStable(isStable), previousSummaries(std::move(previousSummaries)) {}
+
+template<typename ValueType>
+void SubtreeSummaryVisitor<ValueType>::visitPrismModel(PrismModel<ValueType>& model) {
+    STORM_LOG_THROW(false, storm::exceptions::InvalidOperationException, "Concretize MDPs first");
+}
+
+template<typename ValueType>
+void SubtreeSummaryVisitor<ValueType>::visitConcreteModel(ConcreteMdp<ValueType>& model) {
+    stable = isStable(&model);
+    leafCount = 1;
+    ++leafOccurrences;
+    composition = nullptr;
+}
+
+template<typename ValueType>
+void SubtreeSummaryVisitor<ValueType>::visitSequenceModel(SequenceModel<ValueType>& model) {
+    visitComposition(model, model.getValues(), true);
+}
+
+template<typename ValueType>
+void SubtreeSummaryVisitor<ValueType>::visitSumModel(SumModel<ValueType>& model) {
+    visitComposition(model, model.getValues(), true);
+}
+
+template<typename ValueType>
+void SubtreeSummaryVisitor<ValueType>::visitTraceModel(TraceModel<ValueType>& model) {
+    visitComposition(model, {model.getValue()}, false);
+}
+
+template<typename ValueType>
+void SubtreeSummaryVisitor<ValueType>::visitComposition(OpenMdp<ValueType>& model, std::vector<std::shared_ptr<OpenMdp<ValueType>>> const& values,
+                                                        bool summarizable) {
+    // Subtrees with the leaf occurrence their leaves start at
+    std::vector<std::pair<OpenMdp<ValueType>*, size_t>> candidates;
+    bool allStable = true;
+    size_t totalLeafCount = 0;
+    size_t firstLeaf = leafOccurrences;
+
+    ++depth;
+    for (auto const& value : values) {
+        size_t valueFirstLeaf = leafOccurrences;
+        value->accept(*this);
+        allStable &= stable;
+        totalLeafCount += leafCount;
+        if (stable && composition && leafCount >= 2) {
+            candidates.push_back({composition, valueFirstLeaf});
+        }
+    }
+    --depth;
+
+    stable = allStable && summarizable;
+    leafCount = totalLeafCount;
+    composition = summarizable ? &model : nullptr;
+
+    // Only summarize the largest subtrees, a stable node is summarized by its parent unless it is the root
+    if (!stable) {
+        for (auto const& candidate : candidates) {
+            summarize(*candidate.first, candidate.second);
+        }
+    } else if (depth == 0 && leafCount >= 2) {
+        summarize(model, firstLeaf);
+    }
+}
+
+template<typename ValueType>
+void SubtreeSummaryVisitor<ValueType>::summarize(OpenMdp<ValueType>& node, size_t firstLeaf) {
+    auto previous = previousSummaries.find(&node);
+    if (previous != previousSummaries.end()) {
+        summaries[&node] = previous->second;
+        return;
+    }
+
+    auto substitution = [this](ConcreteMdp<ValueType>& leaf) -> ConcreteMdp<ValueType>& { return getShortcutMdp(leaf); };
+    FlatMdpLayoutVisitor<ValueType> layoutVisitor(manager, substitution);
+    node.accept(layoutVisitor);
+    FlatMdpBuilderVisitor<ValueType> builder(manager, substitution);
+    node.accept(builder);
+
+    auto summary = std::make_shared<SubtreeSummary<ValueType>>();
+    summary->mdp = std::make_shared<ConcreteMdp<ValueType>>(builder.getCurrent());
+
+    auto const& leaves = layoutVisitor.getLeaves();
+    summary->leafCount = leaves.size();
+    // Summarized subtrees are disjoint or nested with a different leaf count, so the range of leaf occurrences names them uniquely
+    summary->mdp->setName("summary of leaves " + std::to_string(firstLeaf) + "-" + std::to_string(firstLeaf + leaves.size() - 1));
+
+    // Entrances and exits of the summary are entrances and exits of the shortcut MDPs of its leaves
+    auto addOrigins = [&](std::vector<size_t> const& states, storage::EntranceExit entranceExit) {
+        for (size_t i = 0; i < states.size(); ++i) {
+            auto nextLeaf = std::upper_bound(leaves.begin(), leaves.end(), states[i], [](size_t state, auto const& leaf) { return state < leaf.offset; });
+            size_t leafIndex = nextLeaf - leaves.begin() - 1;
+            size_t localState = states[i] - leaves[leafIndex].offset;
+
+            auto const& shortcutMdp = getShortcutMdp(*leaves[leafIndex].model);
+            boost::optional<storage::Position> position;
+            auto findState = [&](std::vector<size_t> const& list, storage::EntranceExit type) {
+                auto it = std::find(list.begin(), list.end(), localState);
+                if (it != list.end()) {
+                    position = storage::Position{type, static_cast<size_t>(it - list.begin())};
+                }
+            };
+            findState(shortcutMdp.getLEntrance(), storage::L_ENTRANCE);
+            findState(shortcutMdp.getREntrance(), storage::R_ENTRANCE);
+            findState(shortcutMdp.getLExit(), storage::L_EXIT);
+            findState(shortcutMdp.getRExit(), storage::R_EXIT);
+            STORM_LOG_THROW(position, storm::exceptions::InvalidOperationException, "Summary state is no entrance or exit of a leaf");
+
+            summary->origins[{entranceExit, i}] = {leafIndex, *position};
+        }
+    };
+    auto const& layout = layoutVisitor.getLayout();
+    addOrigins(layout.lEntrance, storage::L_ENTRANCE);
+    addOrigins(layout.rEntrance, storage::R_ENTRANCE);
+    addOrigins(layout.lExit, storage::L_EXIT);
+    addOrigins(layout.rExit, storage::R_EXIT);
+
+    summaries[&node] = summary;
+}
+
+template<typename ValueType>
+ConcreteMdp<ValueType>& SubtreeSummaryVisitor<ValueType>::getShortcutMdp(ConcreteMdp<ValueType>& leaf) {
+    auto& shortcutMdp = shortcutMdps[&leaf];
+    if (!shortcutMdp) {
+        shortcutMdp = cache.toLowerBoundShortcutMdp(manager, &leaf);
+    }
+    return *shortcutMdp;
+}
+
+template<typename ValueType>
+typename SubtreeSummaryVisitor<ValueType>::SummaryMap const& SubtreeSummaryVisitor<ValueType>::getSummaries() const {
+    return summaries;
+}
+
+template class SubtreeSummaryVisitor<double>;
+template class SubtreeSummaryVisitor<storm::RationalNumber>;
+
+}  // namespace visitor
+}  // namespace models
+}  // namespace storm
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <functional>
+#include <map>
+
+#include "storm-compose/models/ConcreteMdp.h"
+#include "storm-compose/models/OpenMdp.h"
+#include "storm-compose/models/visitor/OpenMdpVisitor.h"
+#include "storm-compose/storage/EntranceExit.h"
+#include "storm-compose/storage/ParetoCache.h"
+
+namespace storm {
+namespace models {
+namespace visitor {
+
+// A subtree of the string diagram that is replaced by a single leaf
+template<typename ValueType>
+struct SubtreeSummary {
+    std::shared_ptr<ConcreteMdp<ValueType>> mdp;
+    size_t leafCount;  // Leaf occurrences of the subtree
+    // Maps every entrance and exit of the summary to the leaf occurrence (counted from the first leaf of the subtree) and position it belongs to
+    std::map<storage::Position, std::pair<size_t, storage::Position>> origins;
+};
+
+// Finds the maximal sequence and sum subtrees with at least two leaf occurrences whose leaves are all stable, and summarizes each of them as
+// the monolithic MDP of the lower bound shortcut MDPs of its leaves. Every scheduler of the summary is realized by a scheduler of the subtree,
+// so iterating on the summary gives lower bounds.
+//
+// Summaries of the previous run are reused for subtrees that are summarized again.
+template<typename ValueType>
+class SubtreeSummaryVisitor : public OpenMdpVisitor<ValueType> {
+   public:
+    typedef std::map<OpenMdp<ValueType> const*, std::shared_ptr<SubtreeSummary<ValueType> const>> SummaryMap;
+
+    SubtreeSummaryVisitor(std::shared_ptr<OpenMdpManager<ValueType>> manager, storm::storage::ParetoCache<ValueType>& cache,
+                          std::function<bool(ConcreteMdp<ValueType>*)> isStable, SummaryMap previousSummaries = {});
+
+    virtual void visitPrismModel(PrismModel<ValueType>& model) override;
+    virtual void visitConcreteModel(ConcreteMdp<ValueType>& model) override;
+    virtual void visitSequenceModel(SequenceModel<ValueType>& model) override;
+    virtual void visitSumModel(SumModel<ValueType>& model) override;
+    virtual void visitTraceModel(TraceModel<ValueType>& model) override;
+
+    SummaryMap const& getSummaries() const;
+
+   private:
+    void visitComposition(OpenMdp<ValueType>& model, std::vector<std::shared_ptr<OpenMdp<ValueType>>> const& values, bool summarizable);
+    // The first leaf is the number of leaf occurrences visited before the subtree
+    void summarize(OpenMdp<ValueType>& node, size_t firstLeaf);
+    ConcreteMdp<ValueType>& getShortcutMdp(ConcreteMdp<ValueType>& leaf);
+
+    std::shared_ptr<OpenMdpManager<ValueType>> manager;
+    storm::storage::ParetoCache<ValueType>& cache;
+    std::function<bool(ConcreteMdp<ValueType>*)> isStable;
+    SummaryMap previousSummaries, summaries;
+    std::map<ConcreteMdp<ValueType>*, std::shared_ptr<ConcreteMdp<ValueType>>> shortcutMdps;
+
+    // Result of the last visited node, composition is nullptr if the node cannot be summarized on its own
+    bool stable = false;
+    size_t leafCount = 0;
+    OpenMdp<ValueType>* composition = nullptr;
+    size_t depth = 0;
+    size_t leafOccurrences = 0;
+};
+
+}  // namespace visitor
+}  // namespace models
+}  // namespace storm
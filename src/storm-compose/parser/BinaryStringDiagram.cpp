@@ -0,0 +1,353 @@
+#include "BinaryStringDiagram.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include "storm-compose/parser/JsonStringDiagramParser.h"
+#include "storm-parsers/parser/MappedFile.h"
+#include "storm/adapters/JsonAdapter.h"
+#include "storm/exceptions/FileIoException.h"
+#include "storm/exceptions/WrongFormatException.h"
+#include "storm/utility/macros.h"
+
+namespace storm {
+namespace parser {
+
+namespace {
+const char MAGIC[4] = {'S', 'C', 'S', 'D'};
+}
+
+struct BinaryStringDiagram::Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t rootNode;
+    uint32_t nodeCount;
+    uint32_t childCount;
+    uint32_t portCount;
+    uint32_t componentCount;
+    uint32_t stringCount;
+    uint32_t stringBytes;
+};
+
+namespace {
+
+// Converts the JSON representation, mirroring JsonStringDiagramParser
+class JsonConverter {
+   public:
+    typedef BinaryStringDiagram::Node Node;
+
+    JsonConverter(boost::filesystem::path jsonRoot, boost::filesystem::path binaryRoot) : jsonRoot(jsonRoot), binaryRoot(binaryRoot) {}
+
+    void convert(storm::json<double> const& data) {
+        storm::json<double> componentData = data.count("components") == 0 ? storm::json<double>::object() : data.at("components");
+        for (auto it = componentData.begin(); it != componentData.end(); ++it) {
+            componentIndices.emplace(it.key(), static_cast<uint32_t>(componentIndices.size()));
+        }
+        rootNode = convertNode(data.at("root"));
+
+        components.resize(2 * componentIndices.size());
+        for (auto it = componentData.begin(); it != componentData.end(); ++it) {
+            uint32_t component = componentIndices.at(it.key());
+            components[2 * component] = addString(it.key());
+            components[2 * component + 1] = convertNode(it.value());
+        }
+    }
+
+    void write(std::ostream& out) const {
+        BinaryStringDiagram::Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = BinaryStringDiagram::FORMAT_VERSION;
+        header.rootNode = rootNode;
+        header.nodeCount = static_cast<uint32_t>(nodes.size());
+        header.childCount = static_cast<uint32_t>(children.size());
+        header.portCount = static_cast<uint32_t>(ports.size());
+        header.componentCount = static_cast<uint32_t>(components.size() / 2);
+        header.stringCount = static_cast<uint32_t>(strings.size());
+
+        std::vector<uint32_t> stringOffsets(1, 0);
+        for (auto const& string : strings) {
+            stringOffsets.push_back(stringOffsets.back() + static_cast<uint32_t>(string.size()));
+        }
+        header.stringBytes = stringOffsets.back();
+
+        out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        writeTable(out, nodes);
+        writeTable(out, children);
+        writeTable(out, ports);
+        writeTable(out, components);
+        writeTable(out, stringOffsets);
+        for (auto const& string : strings) {
+            out.write(string.data(), string.size());
+        }
+    }
+
+   private:
+    template<typename T>
+    static void writeTable(std::ostream& out, std::vector<T> const& table) {
+        out.write(reinterpret_cast<char const*>(table.data()), table.size() * sizeof(T));
+    }
+
+    uint32_t addString(std::string const& string) {
+        auto inserted = stringIndices.emplace(string, static_cast<uint32_t>(strings.size()));
+        if (inserted.second) {
+            strings.push_back(string);
+        }
+        return inserted.first->second;
+    }
+
+    // Identical nodes are stored once, the key consists of the type and the contents of the node
+    uint32_t addNode(std::vector<uint32_t> const& key, std::function<Node()> const& create) {
+        auto inserted = nodeIndices.emplace(key, static_cast<uint32_t>(nodes.size()));
+        if (inserted.second) {
+            nodes.push_back(create());
+        }
+        return inserted.first->second;
+    }
+
+    uint32_t convertNode(storm::json<double> const& data) {
+        if (data.is_string()) {
+            auto component = componentIndices.find(data.get<std::string>());
+            STORM_LOG_THROW(component != componentIndices.end(), storm::exceptions::WrongFormatException,
+                            "String diagram error: Unknown reference '" << data.get<std::string>() << "'");
+            return addNode({BinaryStringDiagram::REFERENCE, component->second},
+                           [&]() { return Node{BinaryStringDiagram::REFERENCE, component->second, 0, 0}; });
+        }
+
+        STORM_LOG_THROW(data.is_object(), storm::exceptions::WrongFormatException, "expected object");
+        std::string type = data.at("type").get<std::string>();
+        if (type == "prism") {
+            return convertPrismModel(data);
+        } else if (type == "sum" || type == "sequence") {
+            uint32_t nodeType = type == "sum" ? BinaryStringDiagram::SUM : BinaryStringDiagram::SEQUENCE;
+            std::vector<uint32_t> key{nodeType};
+            for (auto const& element : data.at("values")) {
+                key.push_back(convertNode(element));
+            }
+            return addNode(key, [&]() {
+                Node node{nodeType, static_cast<uint32_t>(children.size()), static_cast<uint32_t>(key.size() - 1), 0};
+                children.insert(children.end(), key.begin() + 1, key.end());
+                return node;
+            });
+        } else if (type == "trace") {
+            uint32_t value = convertNode(data.at("value"));
+            int64_t left = data.count("left") == 0 ? 0 : data.at("left").get<int64_t>();
+            int64_t right = data.count("right") == 0 ? 0 : data.at("right").get<int64_t>();
+            STORM_LOG_THROW(left >= 0 && right >= 0, storm::exceptions::WrongFormatException, "left and right need to be positive");
+            Node node{BinaryStringDiagram::TRACE, value, static_cast<uint32_t>(left), static_cast<uint32_t>(right)};
+            return addNode({node.type, node.first, node.second, node.third}, [&]() { return node; });
+        }
+        STORM_LOG_THROW(false, storm::exceptions::WrongFormatException, "type not supported (yet?)");
+    }
+
+    uint32_t convertPrismModel(storm::json<double> const& data) {
+        // The path is resolved like in the JSON parser and stored relative to the binary file if possible
+        boost::filesystem::path prismPath = boost::filesystem::absolute(jsonRoot / data.at("path").get<std::string>()).lexically_normal();
+        boost::filesystem::path relativePath = prismPath.lexically_relative(binaryRoot);
+
+        std::vector<uint32_t> key{BinaryStringDiagram::PRISM, addString((relativePath.empty() ? prismPath : relativePath).string())};
+        std::vector<uint32_t> portStrings;
+        for (auto const& jsonName : {JsonStringDiagramParser<double>::LEFT_ENTRANCE, JsonStringDiagramParser<double>::RIGHT_ENTRANCE,
+                                     JsonStringDiagramParser<double>::LEFT_EXIT, JsonStringDiagramParser<double>::RIGHT_EXIT}) {
+            uint32_t count = 0;
+            if (data.count(jsonName) != 0) {
+                for (auto const& entry : data.at(jsonName)) {
+                    portStrings.push_back(addString(entry.get<std::string>()));
+                    ++count;
+                }
+            }
+            key.push_back(count);
+        }
+        key.insert(key.end(), portStrings.begin(), portStrings.end());
+
+        return addNode(key, [&]() {
+            Node node{BinaryStringDiagram::PRISM, key[1], static_cast<uint32_t>(ports.size()), 0};
+            ports.insert(ports.end(), key.begin() + 2, key.end());
+            return node;
+        });
+    }
+
+    boost::filesystem::path jsonRoot, binaryRoot;
+
+    std::map<std::string, uint32_t> componentIndices;
+    std::unordered_map<std::string, uint32_t> stringIndices;
+    std::map<std::vector<uint32_t>, uint32_t> nodeIndices;
+
+    uint32_t rootNode = 0;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> children, ports, components;
+    std::vector<std::string> strings;
+};
+
+}  // namespace
+
+BinaryStringDiagram::BinaryStringDiagram(std::string const& path) : file(std::make_unique<MappedFile>(path.c_str())), root(path) {
+    root.remove_filename();
+
+    uint64_t size = file->getDataSize();
+    char const* data = file->getData();
+    STORM_LOG_THROW(size >= sizeof(Header), storm::exceptions::WrongFormatException, "Binary string diagram " << path << " is too short");
+    header = reinterpret_cast<Header const*>(data);
+    STORM_LOG_THROW(std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0, storm::exceptions::WrongFormatException,
+                    path << " is not a binary string diagram");
+    STORM_LOG_THROW(header->version == FORMAT_VERSION, storm::exceptions::WrongFormatException,
+                    "Binary string diagram " << path << " has format version " << header->version << ", expected " << FORMAT_VERSION);
+
+    uint64_t offset = sizeof(Header);
+    auto table = [&](uint64_t bytes) {
+        char const* begin = data + offset;
+        offset += bytes;
+        STORM_LOG_THROW(offset <= size, storm::exceptions::WrongFormatException, "Binary string diagram " << path << " is truncated");
+        return begin;
+    };
+    nodes = reinterpret_cast<Node const*>(table(uint64_t(header->nodeCount) * sizeof(Node)));
+    children = reinterpret_cast<uint32_t const*>(table(uint64_t(header->childCount) * sizeof(uint32_t)));
+    ports = reinterpret_cast<uint32_t const*>(table(uint64_t(header->portCount) * sizeof(uint32_t)));
+    components = reinterpret_cast<uint32_t const*>(table(uint64_t(header->componentCount) * 2 * sizeof(uint32_t)));
+    stringOffsets = reinterpret_cast<uint32_t const*>(table((uint64_t(header->stringCount) + 1) * sizeof(uint32_t)));
+    strings = table(header->stringBytes);
+
+    validate();
+}
+
+BinaryStringDiagram::~BinaryStringDiagram() = default;
+
+bool BinaryStringDiagram::isBinaryStringDiagram(std::string const& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void BinaryStringDiagram::convertJson(std::string const& jsonPath, std::string const& binaryPath) {
+    std::ifstream in(jsonPath);
+    STORM_LOG_THROW(in, storm::exceptions::FileIoException, "Could not open " << jsonPath);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    storm::json<double> data = storm::json<double>::parse(buffer.str());
+
+    boost::filesystem::path jsonRoot(jsonPath);
+    jsonRoot.remove_filename();
+    boost::filesystem::path binaryRoot = boost::filesystem::absolute(boost::filesystem::path(binaryPath)).parent_path().lexically_normal();
+
+    JsonConverter converter(jsonRoot, binaryRoot);
+    converter.convert(data);
+
+    std::ofstream out(binaryPath, std::ios::binary);
+    STORM_LOG_THROW(out, storm::exceptions::FileIoException, "Could not open " << binaryPath);
+    converter.write(out);
+    STORM_LOG_THROW(out, storm::exceptions::FileIoException, "Could not write " << binaryPath);
+}
+
+void BinaryStringDiagram::validate() const {
+    auto check = [](bool condition) { STORM_LOG_THROW(condition, storm::exceptions::WrongFormatException, "Corrupt binary string diagram"); };
+
+    check(header->rootNode < header->nodeCount);
+    check(stringOffsets[0] == 0 && stringOffsets[header->stringCount] == header->stringBytes);
+    for (uint32_t i = 0; i < header->stringCount; ++i) {
+        check(stringOffsets[i] <= stringOffsets[i + 1]);
+    }
+    for (uint32_t component = 0; component < header->componentCount; ++component) {
+        check(components[2 * component] < header->stringCount && components[2 * component + 1] < header->nodeCount);
+    }
+
+    for (uint32_t index = 0; index < header->nodeCount; ++index) {
+        Node const& node = nodes[index];
+        switch (node.type) {
+            case PRISM: {
+                check(node.first < header->stringCount && uint64_t(node.second) + 4 <= header->portCount);
+                uint64_t end = uint64_t(node.second) + 4;
+                for (uint32_t i = 0; i < 4; ++i) {
+                    end += ports[node.second + i];
+                }
+                check(end <= header->portCount);
+                for (uint64_t port = node.second + 4; port < end; ++port) {
+                    check(ports[port] < header->stringCount);
+                }
+                break;
+            }
+            case REFERENCE:
+                check(node.first < header->componentCount);
+                break;
+            case SEQUENCE:
+            case SUM:
+                check(uint64_t(node.first) + node.second <= header->childCount);
+                for (auto child = childrenBegin(node); child != childrenEnd(node); ++child) {
+                    check(*child < index);
+                }
+                break;
+            case TRACE:
+                check(node.first < index);
+                break;
+            default:
+                check(false);
+        }
+    }
+}
+
+uint32_t BinaryStringDiagram::getNodeCount() const {
+    return header->nodeCount;
+}
+
+BinaryStringDiagram::Node const& BinaryStringDiagram::getNode(uint32_t index) const {
+    return nodes[index];
+}
+
+BinaryStringDiagram::Node const* BinaryStringDiagram::getNodes() const {
+    return nodes;
+}
+
+uint32_t BinaryStringDiagram::getRootNode() const {
+    return header->rootNode;
+}
+
+uint32_t const* BinaryStringDiagram::childrenBegin(Node const& node) const {
+    return children + node.first;
+}
+
+uint32_t const* BinaryStringDiagram::childrenEnd(Node const& node) const {
+    return children + node.first + node.second;
+}
+
+std::string BinaryStringDiagram::getPrismPath(Node const& node) const {
+    boost::filesystem::path path(getString(node.first));
+    return path.is_absolute() ? path.native() : (root / path).native();
+}
+
+std::vector<std::string> BinaryStringDiagram::getPorts(Node const& node, storage::EntranceExit entranceExit) const {
+    uint32_t const* counts = ports + node.second;
+    uint32_t const* begin = counts + 4;
+    for (int i = 0; i < entranceExit; ++i) {
+        begin += counts[i];
+    }
+
+    std::vector<std::string> result;
+    result.reserve(counts[entranceExit]);
+    for (uint32_t const* port = begin; port != begin + counts[entranceExit]; ++port) {
+        result.push_back(getString(*port));
+    }
+    return result;
+}
+
+uint32_t BinaryStringDiagram::getComponentCount() const {
+    return header->componentCount;
+}
+
+std::string BinaryStringDiagram::getComponentName(uint32_t component) const {
+    return getString(components[2 * component]);
+}
+
+uint32_t BinaryStringDiagram::getComponentNode(uint32_t component) const {
+    return components[2 * component + 1];
+}
+
+std::string BinaryStringDiagram::getString(uint32_t index) const {
+    return std::string(strings + stringOffsets[index], strings + stringOffsets[index + 1]);
+}
+
+}  // namespace parser
+}  // namespace storm
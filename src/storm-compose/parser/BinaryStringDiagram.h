@@ -0,0 +1,86 @@
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storm-compose/storage/EntranceExit.h"
+
+namespace storm {
+namespace parser {
+
+class MappedFile;
+
+// Compact binary representation of a string diagram, the JSON representation is converted with convertJson.
+//
+// The file is a header followed by flat tables of 32 bit integers: the nodes, the children of sequence and sum nodes, the entrances and exits of
+// PRISM nodes, the components and the string table. A node only refers to nodes with a smaller index, so the diagram can be built in a single
+// pass over the node table. Identical nodes, in particular identical PRISM leaves, are stored once. The file is mapped into memory and the
+// tables are read in place. Integers are stored in the byte order of the machine that wrote the file.
+class BinaryStringDiagram {
+   public:
+    constexpr static uint32_t FORMAT_VERSION = 1;
+
+    enum NodeType : uint32_t { PRISM = 0, REFERENCE = 1, SEQUENCE = 2, SUM = 3, TRACE = 4 };
+
+    // The meaning of the fields depends on the type:
+    // PRISM: first = path string, second = offset in the port table. The port table holds the number of left entrances, right entrances,
+    //        left exits and right exits, followed by the strings of the state valuations in this order.
+    // REFERENCE: first = component
+    // SEQUENCE, SUM: first = offset in the child table, second = number of children
+    // TRACE: first = child, second = left, third = right
+    struct Node {
+        uint32_t type;
+        uint32_t first;
+        uint32_t second;
+        uint32_t third;
+    };
+
+    explicit BinaryStringDiagram(std::string const& path);
+    ~BinaryStringDiagram();
+
+    /// Checks the magic number at the beginning of the file
+    static bool isBinaryStringDiagram(std::string const& path);
+
+    /// Writes the binary representation of the JSON string diagram at jsonPath. Paths of PRISM files are stored relative to the binary file.
+    static void convertJson(std::string const& jsonPath, std::string const& binaryPath);
+
+    uint32_t getNodeCount() const;
+    Node const& getNode(uint32_t index) const;
+    Node const* getNodes() const;
+    uint32_t getRootNode() const;
+
+    /// Children of a sequence or sum node
+    uint32_t const* childrenBegin(Node const& node) const;
+    uint32_t const* childrenEnd(Node const& node) const;
+
+    /// Full path of the PRISM file of a PRISM node
+    std::string getPrismPath(Node const& node) const;
+    std::vector<std::string> getPorts(Node const& node, storage::EntranceExit entranceExit) const;
+
+    uint32_t getComponentCount() const;
+    std::string getComponentName(uint32_t component) const;
+    uint32_t getComponentNode(uint32_t component) const;
+
+   private:
+    struct Header;
+
+    void validate() const;
+    std::string getString(uint32_t index) const;
+
+    std::unique_ptr<MappedFile> file;
+    boost::filesystem::path root;
+
+    Header const* header;
+    Node const* nodes;
+    uint32_t const* children;
+    uint32_t const* ports;
+    uint32_t const* components;
+    uint32_t const* stringOffsets;
+    char const* strings;
+};
+
+}  // namespace parser
+}  // namespace storm
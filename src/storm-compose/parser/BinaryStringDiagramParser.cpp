@@ -0,0 +1,79 @@
+#include "BinaryStringDiagramParser.h"
+
+#include <set>
+
+#include "storm/adapters/RationalNumberAdapter.h"
+
+#include "storm-compose/models/PrismModel.h"
+#include "storm-compose/models/Reference.h"
+#include "storm-compose/models/SequenceModel.h"
+#include "storm-compose/models/SumModel.h"
+#include "storm-compose/models/TraceModel.h"
+
+namespace storm {
+namespace parser {
+
+template<typename ValueType>
+BinaryStringDiagramParser<ValueType>::BinaryStringDiagramParser(std::shared_ptr<BinaryStringDiagram const> diagram,
+                                                                std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager)
+    : diagram(diagram), manager(manager) {}
+
+template<typename ValueType>
+BinaryStringDiagramParser<ValueType> BinaryStringDiagramParser<ValueType>::fromFilePath(const std::string& path,
+                                                                                      std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager) {
+    return BinaryStringDiagramParser<ValueType>(std::make_shared<BinaryStringDiagram const>(path), manager);
+}
+
+template<typename ValueType>
+void BinaryStringDiagramParser<ValueType>::parse() {
+    // Children have smaller indices than their parents, so one pass over the node table builds all nodes. Nodes that occur several times in the
+    // diagram are built once and shared.
+    std::vector<std::shared_ptr<storm::models::OpenMdp<ValueType>>> built(diagram->getNodeCount());
+    for (uint32_t index = 0; index < diagram->getNodeCount(); ++index) {
+        built[index] = buildNode(index, built);
+    }
+    manager->setRoot(built[diagram->getRootNode()]);
+
+    // Every component gets its own node, as the manager names the node after the component
+    std::set<uint32_t> usedNodes;
+    for (uint32_t component = 0; component < diagram->getComponentCount(); ++component) {
+        uint32_t node = diagram->getComponentNode(component);
+        auto openMdp = usedNodes.insert(node).second ? built[node] : buildNode(node, built);
+        manager->addReference(diagram->getComponentName(component), openMdp);
+    }
+}
+
+template<typename ValueType>
+std::shared_ptr<storm::models::OpenMdp<ValueType>> BinaryStringDiagramParser<ValueType>::buildNode(
+    uint32_t index, std::vector<std::shared_ptr<storm::models::OpenMdp<ValueType>>> const& built) {
+    auto const& node = diagram->getNode(index);
+    switch (node.type) {
+        case BinaryStringDiagram::PRISM:
+            return std::make_shared<storm::models::PrismModel<ValueType>>(
+                manager, diagram->getPrismPath(node), diagram->getPorts(node, storage::L_ENTRANCE), diagram->getPorts(node, storage::R_ENTRANCE),
+                diagram->getPorts(node, storage::L_EXIT), diagram->getPorts(node, storage::R_EXIT));
+        case BinaryStringDiagram::REFERENCE:
+            return std::make_shared<storm::models::Reference<ValueType>>(manager, diagram->getComponentName(node.first));
+        case BinaryStringDiagram::SEQUENCE:
+        case BinaryStringDiagram::SUM: {
+            std::vector<std::shared_ptr<storm::models::OpenMdp<ValueType>>> values;
+            values.reserve(node.second);
+            for (auto child = diagram->childrenBegin(node); child != diagram->childrenEnd(node); ++child) {
+                values.push_back(built[*child]);
+            }
+            if (node.type == BinaryStringDiagram::SEQUENCE) {
+                return std::make_shared<storm::models::SequenceModel<ValueType>>(manager, values);
+            }
+            return std::make_shared<storm::models::SumModel<ValueType>>(manager, values);
+        }
+        default:
+            // The node table was validated when the diagram was loaded, so this is a trace
+            return std::make_shared<storm::models::TraceModel<ValueType>>(manager, built[node.first], node.second, node.third);
+    }
+}
+
+template class BinaryStringDiagramParser<storm::RationalNumber>;
+template class BinaryStringDiagramParser<double>;
+
+}  // namespace parser
+}  // namespace storm
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "storm-compose/models/OpenMdp.h"
+#include "storm-compose/models/OpenMdpManager.h"
+#include "storm-compose/parser/BinaryStringDiagram.h"
+
+#include <memory>
+#include <string>
+
+namespace storm {
+namespace parser {
+
+// Builds the open MDPs of a binary string diagram, see BinaryStringDiagram for the format
+template<typename ValueType>
+class BinaryStringDiagramParser {
+   public:
+    BinaryStringDiagramParser(std::shared_ptr<BinaryStringDiagram const> diagram, std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager);
+    static BinaryStringDiagramParser<ValueType> fromFilePath(const std::string& path, std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager);
+
+    /// Parse input (in-place, storing results in manager)
+    void parse();
+
+   private:
+    std::shared_ptr<storm::models::OpenMdp<ValueType>> buildNode(uint32_t index, std::vector<std::shared_ptr<storm::models::OpenMdp<ValueType>>> const& built);
+
+    std::shared_ptr<BinaryStringDiagram const> diagram;
+    std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager;
+};
+
+}  // namespace parser
+}  // namespace storm
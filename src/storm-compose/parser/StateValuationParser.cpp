@@ -1,11 +1,13 @@
 #include "StateValuationParser.h"
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <ostream>
 
 #include "storm/adapters/RationalNumberAdapter.h"
 #include "storm/exceptions/InvalidOperationException.h"
+#include "storm/storage/expressions/ExpressionManager.h"
 
 namespace storm {
 namespace parser {
@@ -39,5 +41,28 @@ storm::storage::sparse::StateValuations::StateValuation StateValuationParser::pa
     return storm::storage::sparse::StateValuations::StateValuation({}, std::move(integerValues), {});
 }
 
+std::map<storm::expressions::Variable, storm::expressions::Expression> StateValuationParser::parseStateDescription(
+    std::string const& toParse, storm::generator::VariableInformation const& variableInformation) {
+    std::map<storm::expressions::Variable, storm::expressions::Expression> description;
+    std::vector<std::string> parts;
+    boost::algorithm::split(parts, toParse, boost::is_any_of("&"));
+    for (auto& part : parts) {
+        std::vector<std::string> parts2;
+        boost::algorithm::split(parts2, part, boost::is_any_of("="));
+        STORM_LOG_THROW(parts2.size() == 2, storm::exceptions::InvalidOperationException, "incorrect equality");
+
+        auto name = boost::algorithm::trim_copy(parts2.at(0));
+        auto variable = std::find_if(variableInformation.integerVariables.begin(), variableInformation.integerVariables.end(),
+                                     [&name](auto const& integerVariable) { return integerVariable.getName() == name; });
+        STORM_LOG_THROW(variable != variableInformation.integerVariables.end(), storm::exceptions::InvalidOperationException,
+                        "Unknown integer variable " << name << " in state valuation " << toParse);
+
+        int64_t number = std::atoi(boost::algorithm::trim_copy(parts2.at(1)).c_str());
+        description[variable->variable] = variable->variable.getManager().integer(number);
+    }
+
+    return description;
+}
+
 }  // namespace parser
 }  // namespace storm
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <map>
+
+#include "storm/generator/VariableInformation.h"
+#include "storm/storage/expressions/Expression.h"
 #include "storm/storage/sparse/StateValuations.h"
 
 namespace storm {
@@ -10,6 +14,11 @@ class StateValuationParser {
     StateValuationParser(const storm::storage::sparse::StateValuations& stateValuations);
     storm::storage::sparse::StateValuations::StateValuation parseStateValuation(std::string toParse);
 
+    // Parses a valuation of the form "x=1 & y=2" into a state description that can be looked up in the state storage of a model builder.
+    // Unlike parseStateValuation, the variables are identified by name, so they may be given in any order.
+    static std::map<storm::expressions::Variable, storm::expressions::Expression> parseStateDescription(
+        std::string const& toParse, storm::generator::VariableInformation const& variableInformation);
+
    private:
     const storm::storage::sparse::StateValuations& stateValuations;
 
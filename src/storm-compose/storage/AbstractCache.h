@@ -23,6 +23,11 @@ class AbstractCache {
 
     virtual bool needScheduler() = 0;
 
+    // Whether queries and insertions may be issued concurrently from several threads without external synchronization
+    virtual bool isThreadSafe() const {
+        return false;
+    }
+
    protected:
     ValueType errorTolerance;
 };
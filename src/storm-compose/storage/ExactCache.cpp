@@ -7,13 +7,15 @@ namespace storm {
 namespace storage {
 
 template<typename ValueType>
-ExactCache<ValueType>::ExactCache(ValueType oviEpsilon) : oviEpsilon(oviEpsilon) {}
+ExactCache<ValueType>::ExactCache(ValueType oviEpsilon, bool useLipschitzBounds) : oviEpsilon(oviEpsilon), useLipschitzBounds(useLipschitzBounds) {}
 
 template<typename ValueType>
 boost::optional<std::vector<ValueType>> ExactCache<ValueType>::getLowerBound(models::ConcreteMdp<ValueType>* ptr, std::vector<ValueType> outputWeight) {
     const auto it = cache.find({outputWeight, ptr});
     if (it != cache.end()) {
         return it->second;
+    } else if (auto bounds = getLipschitzBounds(ptr, outputWeight)) {
+        return bounds->first;
     } else {
         return boost::none;
     }
@@ -28,15 +30,53 @@ boost::optional<std::vector<ValueType>> ExactCache<ValueType>::getUpperBound(mod
             v = storm::utility::min<ValueType>(v + oviEpsilon, storm::utility::one<ValueType>());
         }
         return values;
+    } else if (auto bounds = getLipschitzBounds(ptr, outputWeight)) {
+        return bounds->second;
     } else {
         return boost::none;
     }
 }
 
+template<typename ValueType>
+boost::optional<std::pair<std::vector<ValueType>, std::vector<ValueType>>> ExactCache<ValueType>::getLipschitzBounds(models::ConcreteMdp<ValueType>* ptr,
+                                                                                                                      WeightType const& outputWeight) const {
+    if (!useLipschitzBounds) {
+        return boost::none;
+    }
+    auto indexIt = weightIndices.find(ptr);
+    if (indexIt == weightIndices.end()) {
+        return boost::none;
+    }
+    auto nearest = indexIt->second.tree.nearest(outputWeight);
+    if (!nearest) {
+        return boost::none;
+    }
+
+    auto const& entry = indexIt->second.entries[nearest->first];
+    auto distances = WeightKdTree<ValueType>::getOneSidedDistances(outputWeight, entry.first);
+
+    WeightType lower = entry.second, upper = entry.second;
+    for (size_t i = 0; i < lower.size(); ++i) {
+        lower[i] = storm::utility::max<ValueType>(lower[i] - distances.second, storm::utility::zero<ValueType>());
+        upper[i] = storm::utility::min<ValueType>(upper[i] + oviEpsilon + distances.first, storm::utility::one<ValueType>());
+    }
+    return std::make_pair(lower, upper);
+}
+
 template<typename ValueType>
 void ExactCache<ValueType>::addToCache(models::ConcreteMdp<ValueType>* ptr, std::vector<ValueType> outputWeight, std::vector<ValueType> inputWeight,
                                        boost::optional<storm::storage::Scheduler<ValueType>> sched) {
-    cache.insert({{outputWeight, ptr}, inputWeight});
+    bool inserted = cache.insert({{outputWeight, ptr}, inputWeight}).second;
+
+    if (useLipschitzBounds && inserted) {
+        auto indexIt = weightIndices.find(ptr);
+        if (indexIt == weightIndices.end()) {
+            indexIt = weightIndices.emplace(ptr, LeafIndex{WeightKdTree<ValueType>(outputWeight.size()), {}}).first;
+        }
+        auto& index = indexIt->second;
+        index.tree.insert(outputWeight, index.entries.size());
+        index.entries.emplace_back(outputWeight, inputWeight);
+    }
 }
 
 template<typename ValueType>
@@ -1,7 +1,9 @@
 #include "AbstractCache.h"
+#include "WeightKdTree.h"
 #include "storm-compose/models/ConcreteMdp.h"
 
 #include <map>
+#include <unordered_map>
 
 namespace storm {
 namespace storage {
@@ -11,7 +13,8 @@ class ExactCache : public AbstractCache<ValueType> {
    public:
     typedef std::vector<ValueType> WeightType;
 
-    ExactCache(ValueType oviEpsilon);
+    // If useLipschitzBounds is set, queries for unseen weights are answered with bounds derived from the closest previously seen weight
+    ExactCache(ValueType oviEpsilon, bool useLipschitzBounds = false);
 
     boost::optional<WeightType> getLowerBound(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight) override;
     boost::optional<WeightType> getUpperBound(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight) override;
@@ -20,8 +23,17 @@ class ExactCache : public AbstractCache<ValueType> {
     bool needScheduler() override;
 
    private:
+    struct LeafIndex {
+        WeightKdTree<ValueType> tree;
+        std::vector<std::pair<WeightType, WeightType>> entries;
+    };
+
+    boost::optional<std::pair<WeightType, WeightType>> getLipschitzBounds(models::ConcreteMdp<ValueType>* ptr, WeightType const& outputWeight) const;
+
     std::map<std::pair<WeightType, models::ConcreteMdp<ValueType>*>, WeightType> cache;
     ValueType oviEpsilon;
+    bool useLipschitzBounds;
+    std::unordered_map<models::ConcreteMdp<ValueType>*, LeafIndex> weightIndices;
 };
 
 }  // namespace storage
@@ -0,0 +1,220 @@
+#include "FloatParetoBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/utility/macros.h"
+
+namespace storm {
+namespace storage {
+
+namespace {
+constexpr double UNIT_ROUNDOFF = std::numeric_limits<double>::epsilon() / 2;
+constexpr double PIVOT_TOLERANCE = 1e-12;
+constexpr double INFINITY_VALUE = std::numeric_limits<double>::infinity();
+
+// Bound on the rounding error of a floating point sum of n products, relative to the sum of the absolute values of the products.
+double gamma(size_t n) {
+    double nu = static_cast<double>(n) * UNIT_ROUNDOFF;
+    return nu / (1 - nu);
+}
+
+// Computes a*b together with the sum of the absolute values of the products (used for error bounds).
+std::pair<double, double> dotProduct(std::vector<double> const& a, std::vector<double> const& b) {
+    double result = 0, absResult = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        double product = a[i] * b[i];
+        result += product;
+        absResult += std::abs(product);
+    }
+    return {result, absResult};
+}
+
+// Adds enough to the computed value to cover underflow and the rounding of the final addition.
+double roundUp(double value, double errorBound) {
+    return std::nextafter(value + errorBound + std::numeric_limits<double>::min(), INFINITY_VALUE);
+}
+
+double roundDown(double value, double errorBound) {
+    return std::nextafter(value - errorBound - std::numeric_limits<double>::min(), -INFINITY_VALUE);
+}
+}  // namespace
+
+FloatParetoBounds::FloatParetoBounds(size_t dimension) : dimension(dimension) {}
+
+void FloatParetoBounds::addPoint(std::vector<double> const& weight, std::vector<double> const& point, double padding) {
+    STORM_LOG_THROW(weight.size() == dimension && point.size() == dimension, storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+
+    auto offset = dotProduct(weight, point);
+    points.push_back(point);
+    normals.push_back(weight);
+    // The padding is added with one more rounding
+    offsets.push_back(roundUp(offset.first + padding, gamma(dimension + 1) * (offset.second + padding)));
+}
+
+void FloatParetoBounds::addLowerBoundPoint(std::vector<double> const& point) {
+    STORM_LOG_THROW(point.size() == dimension, storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+    points.push_back(point);
+}
+
+void FloatParetoBounds::addHalfspace(std::vector<double> const& normal, double offset) {
+    STORM_LOG_THROW(normal.size() == dimension, storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+    normals.push_back(normal);
+    // The offset is usually converted from an exact value
+    offsets.push_back(roundUp(offset, gamma(1) * std::abs(offset)));
+}
+
+double FloatParetoBounds::maximizeLowerBound(std::vector<double> const& weight) const {
+    double best = 0;
+    for (auto const& point : points) {
+        auto value = dotProduct(weight, point);
+        best = std::max(best, roundDown(value.first, gamma(dimension) * value.second));
+    }
+    return best;
+}
+
+boost::optional<double> FloatParetoBounds::maximizeUpperBound(std::vector<double> const& weight) const {
+    // Trivial bound from the subdistribution polytope, the simplex result is only used if it improves on it.
+    double trivialBound = std::max(0.0, *std::max_element(weight.begin(), weight.end()));
+    size_t halfspaceCount = normals.size();
+    if (halfspaceCount == 0 || dimension == 0) {
+        return trivialBound;
+    }
+
+    // Compact simplex tableau for max weight*x s.t. normals*x <= offsets, sum(x) <= 1, x >= 0.
+    // Rows [0, halfspaceCount) are the halfspaces, the next row is sum(x) <= 1 and the last row is the objective.
+    // Variables [0, dimension) are the x_j, variable dimension + i is the slack of row i.
+    // All offsets are non-negative, so the origin is a feasible starting vertex.
+    size_t rows = halfspaceCount + 1;
+    size_t columns = dimension + 1;
+    std::vector<double> tableau((rows + 1) * columns);
+    auto at = [&](size_t row, size_t column) -> double& { return tableau[row * columns + column]; };
+
+    for (size_t i = 0; i < halfspaceCount; ++i) {
+        if (offsets[i] < 0) {
+            return boost::none;
+        }
+        std::copy(normals[i].begin(), normals[i].end(), &at(i, 0));
+        at(i, dimension) = offsets[i];
+    }
+    for (size_t j = 0; j < dimension; ++j) {
+        at(halfspaceCount, j) = 1;
+        at(rows, j) = -weight[j];
+    }
+    at(halfspaceCount, dimension) = 1;
+    at(rows, dimension) = 0;
+
+    std::vector<size_t> basic(rows), nonBasic(dimension);
+    std::iota(nonBasic.begin(), nonBasic.end(), 0);
+    std::iota(basic.begin(), basic.end(), dimension);
+
+    // Dantzig's rule, switching to Bland's rule (which cannot cycle) if it takes unusually long
+    size_t blandThreshold = rows + dimension;
+    size_t maxPivots = 50 * (rows + dimension);
+    for (size_t pivots = 0;; ++pivots) {
+        if (pivots >= maxPivots) {
+            return boost::none;
+        }
+        bool useBland = pivots >= blandThreshold;
+
+        size_t pivotColumn = dimension;
+        for (size_t j = 0; j < dimension; ++j) {
+            if (at(rows, j) >= -PIVOT_TOLERANCE) {
+                continue;
+            }
+            if (pivotColumn == dimension || (useBland ? nonBasic[j] < nonBasic[pivotColumn] : at(rows, j) < at(rows, pivotColumn))) {
+                pivotColumn = j;
+            }
+        }
+        if (pivotColumn == dimension) {
+            break;
+        }
+
+        size_t pivotRow = rows;
+        double bestRatio = INFINITY_VALUE;
+        for (size_t i = 0; i < rows; ++i) {
+            if (at(i, pivotColumn) <= PIVOT_TOLERANCE) {
+                continue;
+            }
+            double ratio = at(i, dimension) / at(i, pivotColumn);
+            if (ratio < bestRatio || (ratio == bestRatio && basic[i] < basic[pivotRow])) {
+                bestRatio = ratio;
+                pivotRow = i;
+            }
+        }
+        STORM_LOG_ASSERT(pivotRow < rows, "Simplex is unbounded on a bounded polytope");
+
+        double pivot = at(pivotRow, pivotColumn);
+        for (size_t i = 0; i <= rows; ++i) {
+            if (i == pivotRow) {
+                continue;
+            }
+            double factor = at(i, pivotColumn) / pivot;
+            if (factor == 0) {
+                continue;
+            }
+            for (size_t j = 0; j < columns; ++j) {
+                if (j != pivotColumn) {
+                    at(i, j) -= factor * at(pivotRow, j);
+                }
+            }
+            at(i, pivotColumn) = -factor;
+        }
+        for (size_t j = 0; j < columns; ++j) {
+            if (j != pivotColumn) {
+                at(pivotRow, j) /= pivot;
+            }
+        }
+        at(pivotRow, pivotColumn) = 1 / pivot;
+        std::swap(basic[pivotRow], nonBasic[pivotColumn]);
+    }
+
+    // The reduced costs of the non-basic slack variables are the dual multipliers of the halfspaces.
+    std::vector<double> multipliers(halfspaceCount, 0);
+    for (size_t j = 0; j < dimension; ++j) {
+        size_t variable = nonBasic[j];
+        if (variable >= dimension && variable - dimension < halfspaceCount) {
+            multipliers[variable - dimension] = std::max(0.0, at(rows, j));
+        }
+    }
+
+    // For any multipliers y >= 0 and x in the polytope we have
+    //   weight*x = y*(normals*x) + r*x <= y*offsets + max(0, max_j r_j)   with r = weight - y*normals,
+    // as x is a subdistribution. All terms are rounded upwards.
+    double bound = 0, absBound = 0;
+    for (size_t i = 0; i < halfspaceCount; ++i) {
+        double product = multipliers[i] * offsets[i];
+        bound += product;
+        absBound += std::abs(product);
+    }
+    bound = roundUp(bound, gamma(halfspaceCount + 1) * absBound);
+
+    double maxResidual = 0;
+    for (size_t j = 0; j < dimension; ++j) {
+        double sum = 0, absSum = std::abs(weight[j]);
+        for (size_t i = 0; i < halfspaceCount; ++i) {
+            double product = multipliers[i] * normals[i][j];
+            sum += product;
+            absSum += std::abs(product);
+        }
+        maxResidual = std::max(maxResidual, roundUp(weight[j] - sum, gamma(halfspaceCount + 2) * absSum));
+    }
+
+    double result = roundUp(bound + maxResidual, gamma(2) * (std::abs(bound) + maxResidual));
+    return std::min(result, trivialBound);
+}
+
+void FloatParetoBounds::clearLowerBound() {
+    points.clear();
+}
+
+void FloatParetoBounds::clearUpperBound() {
+    normals.clear();
+    offsets.clear();
+}
+
+}  // namespace storage
+}  // namespace storm
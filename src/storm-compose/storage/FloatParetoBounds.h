@@ -0,0 +1,45 @@
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+namespace storm {
+namespace storage {
+
+// Floating point counterpart of the bounds stored in the Pareto cache for a single entrance: the lower bound points p and the
+// upper bound polytope, i.e. the subdistribution polytope {x >= 0 | sum(x) <= 1} intersected with the halfspaces {x | w*x <= w*p}.
+//
+// All results are rounded outwards. The upper bound is computed with a small dense simplex whose result is only used to guess
+// dual multipliers, the returned value is derived from these multipliers, so it is an over-approximation of the exact optimum
+// even if the simplex itself suffers from rounding errors.
+class FloatParetoBounds {
+   public:
+    FloatParetoBounds(size_t dimension);
+
+    /// Adds the point to the lower bound and the halfspace {x | weight*x <= weight*point + padding} to the upper bound.
+    void addPoint(std::vector<double> const& weight, std::vector<double> const& point, double padding = 0);
+
+    /// Adds the point only to the lower bound.
+    void addLowerBoundPoint(std::vector<double> const& point);
+
+    /// Adds the halfspace {x | normal*x <= offset} to the upper bound. The normal must be non-negative.
+    void addHalfspace(std::vector<double> const& normal, double offset);
+
+    /// Returns a value that is at most max {weight*p | p lower bound point}. The origin is always a lower bound point.
+    double maximizeLowerBound(std::vector<double> const& weight) const;
+
+    /// Returns a value that is at least max {weight*x | x in the upper bound polytope}, or none if the simplex did not converge.
+    boost::optional<double> maximizeUpperBound(std::vector<double> const& weight) const;
+
+    void clearLowerBound();
+    void clearUpperBound();
+
+   private:
+    size_t dimension;
+    std::vector<std::vector<double>> points;
+    std::vector<std::vector<double>> normals;
+    std::vector<double> offsets;  // rounded upwards
+};
+
+}  // namespace storage
+}  // namespace storm
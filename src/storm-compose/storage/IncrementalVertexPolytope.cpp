@@ -0,0 +1,171 @@
+#include "IncrementalVertexPolytope.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/macros.h"
+#include "storm/utility/vector.h"
+
+namespace storm {
+namespace storage {
+
+template<typename ValueType>
+IncrementalVertexPolytope<ValueType>::IncrementalVertexPolytope(size_t dimension, size_t constraintCount)
+    : dimension(dimension), constraintCount(constraintCount) {}
+
+template<typename ValueType>
+std::shared_ptr<IncrementalVertexPolytope<ValueType> const> IncrementalVertexPolytope<ValueType>::createSubdistributionPolytope(size_t dimension) {
+    std::shared_ptr<IncrementalVertexPolytope<ValueType>> result(new IncrementalVertexPolytope<ValueType>(dimension, dimension + 1));
+
+    // The origin, all non-negativity constraints are tight
+    result->vertices.push_back(Point(dimension, storm::utility::zero<ValueType>()));
+    std::vector<size_t> allNonNegative(dimension);
+    for (size_t i = 0; i < dimension; ++i) {
+        allNonNegative[i] = i;
+    }
+    result->tightConstraints.push_back(allNonNegative);
+
+    // The unit vectors, all but one non-negativity constraint and the sum constraint are tight
+    for (size_t i = 0; i < dimension; ++i) {
+        Point unitVector(dimension, storm::utility::zero<ValueType>());
+        unitVector[i] = storm::utility::one<ValueType>();
+        result->vertices.push_back(unitVector);
+
+        std::vector<size_t> tight;
+        for (size_t j = 0; j <= dimension; ++j) {
+            if (j != i) {
+                tight.push_back(j);
+            }
+        }
+        result->tightConstraints.push_back(tight);
+    }
+
+    return result;
+}
+
+template<typename ValueType>
+std::shared_ptr<IncrementalVertexPolytope<ValueType> const> IncrementalVertexPolytope<ValueType>::intersection(Point const& normal,
+                                                                                                            ValueType const& offset) const {
+    STORM_LOG_THROW(normal.size() == dimension, storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+
+    std::vector<ValueType> slack(vertices.size());
+    std::vector<size_t> inside, outside;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        slack[i] = storm::utility::vector::dotProduct(normal, vertices[i]) - offset;
+        if (slack[i] > storm::utility::zero<ValueType>()) {
+            outside.push_back(i);
+        } else if (slack[i] < storm::utility::zero<ValueType>()) {
+            inside.push_back(i);
+        }
+    }
+
+    if (outside.empty()) {
+        return this->shared_from_this();
+    }
+
+    size_t newConstraint = constraintCount;
+    std::shared_ptr<IncrementalVertexPolytope<ValueType>> result(new IncrementalVertexPolytope<ValueType>(dimension, constraintCount + 1));
+
+    // Keep all vertices that satisfy the new constraint
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (slack[i] > storm::utility::zero<ValueType>()) {
+            continue;
+        }
+        result->vertices.push_back(vertices[i]);
+        result->tightConstraints.push_back(tightConstraints[i]);
+        if (slack[i] == storm::utility::zero<ValueType>()) {
+            result->tightConstraints.back().push_back(newConstraint);
+        }
+    }
+
+    // Each edge between a vertex strictly inside and a vertex strictly outside yields a new vertex on the hyperplane.
+    // Two vertices are adjacent iff their common tight constraints have (at least) dimension - 1 elements and are not all tight in
+    // any third vertex.
+    std::vector<size_t> common;
+    for (size_t in : inside) {
+        for (size_t out : outside) {
+            common.clear();
+            std::set_intersection(tightConstraints[in].begin(), tightConstraints[in].end(), tightConstraints[out].begin(), tightConstraints[out].end(),
+                                  std::back_inserter(common));
+            if (common.size() + 1 < dimension) {
+                continue;
+            }
+
+            bool adjacent = true;
+            for (size_t other = 0; other < vertices.size() && adjacent; ++other) {
+                if (other != in && other != out &&
+                    std::includes(tightConstraints[other].begin(), tightConstraints[other].end(), common.begin(), common.end())) {
+                    adjacent = false;
+                }
+            }
+            if (!adjacent) {
+                continue;
+            }
+
+            ValueType factor = slack[in] / (slack[in] - slack[out]);
+            Point newVertex(dimension);
+            for (size_t i = 0; i < dimension; ++i) {
+                newVertex[i] = vertices[in][i] + factor * (vertices[out][i] - vertices[in][i]);
+            }
+            result->vertices.push_back(std::move(newVertex));
+            common.push_back(newConstraint);
+            result->tightConstraints.push_back(common);
+        }
+    }
+
+    return result;
+}
+
+template<typename ValueType>
+std::pair<typename IncrementalVertexPolytope<ValueType>::Point, ValueType> IncrementalVertexPolytope<ValueType>::optimize(Point const& direction) const {
+    STORM_LOG_ASSERT(!vertices.empty(), "Polytope is empty");
+
+    {
+        std::lock_guard<std::mutex> lock(memoMutex);
+        for (auto const& entry : memo) {
+            if (entry.first == direction) {
+                Point const& vertex = vertices[entry.second];
+                return {vertex, storm::utility::vector::dotProduct(direction, vertex)};
+            }
+        }
+    }
+
+    size_t best = 0;
+    ValueType bestValue = storm::utility::vector::dotProduct(direction, vertices[0]);
+    for (size_t i = 1; i < vertices.size(); ++i) {
+        ValueType value = storm::utility::vector::dotProduct(direction, vertices[i]);
+        if (value > bestValue) {
+            best = i;
+            bestValue = value;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(memoMutex);
+        if (memo.size() >= MEMO_SIZE) {
+            memo.pop_front();
+        }
+        memo.emplace_back(direction, best);
+    }
+
+    return {vertices[best], bestValue};
+}
+
+template<typename ValueType>
+std::vector<typename IncrementalVertexPolytope<ValueType>::Point> const& IncrementalVertexPolytope<ValueType>::getVertices() const {
+    return vertices;
+}
+
+template<typename ValueType>
+size_t IncrementalVertexPolytope<ValueType>::getDimension() const {
+    return dimension;
+}
+
+template class IncrementalVertexPolytope<double>;
+template class IncrementalVertexPolytope<storm::RationalNumber>;
+
+}  // namespace storage
+}  // namespace storm
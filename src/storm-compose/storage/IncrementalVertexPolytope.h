@@ -0,0 +1,49 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace storm {
+namespace storage {
+
+// Vertex representation of a polytope contained in the subdistribution polytope {x >= 0 | sum(x) <= 1}, maintained under
+// halfspace intersection with the (incremental) double description method.
+//
+// Instances are immutable (except for the memoization of optimization results), an intersection returns a new polytope. This allows
+// readers to keep using a polytope while a newer version is published.
+template<typename ValueType>
+class IncrementalVertexPolytope : public std::enable_shared_from_this<IncrementalVertexPolytope<ValueType>> {
+   public:
+    typedef std::vector<ValueType> Point;
+
+    static std::shared_ptr<IncrementalVertexPolytope<ValueType> const> createSubdistributionPolytope(size_t dimension);
+
+    /// Returns the intersection with {x | normal*x <= offset}. If the halfspace is redundant, this polytope is returned.
+    std::shared_ptr<IncrementalVertexPolytope<ValueType> const> intersection(Point const& normal, ValueType const& offset) const;
+
+    /// Returns a vertex that maximizes direction*x and its value. The result for the most recent directions is memoized.
+    std::pair<Point, ValueType> optimize(Point const& direction) const;
+
+    std::vector<Point> const& getVertices() const;
+    size_t getDimension() const;
+
+   private:
+    IncrementalVertexPolytope(size_t dimension, size_t constraintCount);
+
+    constexpr static size_t MEMO_SIZE = 8;
+
+    size_t dimension;
+    // Constraints [0, dimension) are x_i >= 0, constraint dimension is sum(x) <= 1, the following ones are the intersected halfspaces.
+    size_t constraintCount;
+    std::vector<Point> vertices;
+    // For each vertex, the (sorted) indices of the constraints that are tight in it, used for the combinatorial adjacency test
+    std::vector<std::vector<size_t>> tightConstraints;
+
+    mutable std::mutex memoMutex;
+    mutable std::deque<std::pair<Point, size_t>> memo;
+};
+
+}  // namespace storage
+}  // namespace storm
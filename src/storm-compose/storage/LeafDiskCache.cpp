@@ -0,0 +1,465 @@
+#include "LeafDiskCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+#include "storm-compose/models/ConcreteMdp.h"
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/exceptions/BaseException.h"
+#include "storm/exceptions/FileIoException.h"
+#include "storm/models/sparse/Mdp.h"
+#include "storm/models/sparse/StateLabeling.h"
+#include "storm/storage/SparseMatrix.h"
+#include "storm/storage/sparse/ModelComponents.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/macros.h"
+
+namespace storm {
+namespace storage {
+
+namespace {
+const std::string LEAF_MAGIC = "SCLF";
+const std::string PARETO_MAGIC = "SCPS";
+const std::string LEAF_EXTENSION = ".leaf";
+const std::string PARETO_EXTENSION = ".pareto";
+const uint64_t MAX_STRING_LENGTH = uint64_t(1) << 32;
+
+// Unlike std::hash the results are the same for every run. get() is FNV-1a, getSecond() is an independent multiply-rotate hash that is only used
+// to detect collisions of the first one.
+class Hasher {
+   public:
+    void add(void const* data, size_t size) {
+        auto bytes = static_cast<unsigned char const*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+            secondHash = ((secondHash << 5) | (secondHash >> 59)) ^ bytes[i];
+            secondHash *= 0x9E3779B97F4A7C15ull;
+        }
+    }
+
+    void add(uint64_t value) {
+        add(&value, sizeof(value));
+    }
+
+    void add(std::string const& value) {
+        add(value.size());
+        add(value.data(), value.size());
+    }
+
+    void add(double value) {
+        add(&value, sizeof(value));
+    }
+
+    void add(storm::RationalNumber const& value) {
+        add(storm::utility::to_string(value));
+    }
+
+    uint64_t get() const {
+        return hash;
+    }
+
+    uint64_t getSecond() const {
+        // Final avalanche step, so all input bytes affect all bits
+        uint64_t result = secondHash;
+        result ^= result >> 33;
+        result *= 0xFF51AFD7ED558CCDull;
+        result ^= result >> 33;
+        return result;
+    }
+
+   private:
+    uint64_t hash = 14695981039346656037ull;
+    uint64_t secondHash = 0;
+};
+
+template<typename T>
+void writePod(std::ostream& out, T const& value) {
+    out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template<typename T>
+T readPod(std::istream& in) {
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    STORM_LOG_THROW(in, storm::exceptions::FileIoException, "Unexpected end of cache file");
+    return value;
+}
+
+void writeString(std::ostream& out, std::string const& value) {
+    writePod<uint64_t>(out, value.size());
+    out.write(value.data(), value.size());
+}
+
+std::string readString(std::istream& in) {
+    uint64_t size = readPod<uint64_t>(in);
+    STORM_LOG_THROW(size <= MAX_STRING_LENGTH, storm::exceptions::FileIoException, "Corrupt cache file");
+    std::string value(size, '\0');
+    in.read(&value[0], size);
+    STORM_LOG_THROW(in, storm::exceptions::FileIoException, "Unexpected end of cache file");
+    return value;
+}
+
+void writeValue(std::ostream& out, double value) {
+    writePod(out, value);
+}
+
+void writeValue(std::ostream& out, storm::RationalNumber const& value) {
+    writeString(out, storm::utility::to_string(value));
+}
+
+template<typename ValueType>
+ValueType readValue(std::istream& in);
+
+template<>
+double readValue<double>(std::istream& in) {
+    return readPod<double>(in);
+}
+
+template<>
+storm::RationalNumber readValue<storm::RationalNumber>(std::istream& in) {
+    return storm::utility::convertNumber<storm::RationalNumber>(readString(in));
+}
+
+template<typename ValueType>
+void writeVector(std::ostream& out, std::vector<ValueType> const& values) {
+    writePod<uint64_t>(out, values.size());
+    for (auto const& value : values) {
+        writeValue(out, value);
+    }
+}
+
+template<typename ValueType>
+std::vector<ValueType> readVector(std::istream& in, uint64_t expectedSize) {
+    uint64_t size = readPod<uint64_t>(in);
+    STORM_LOG_THROW(size == expectedSize, storm::exceptions::FileIoException, "Dimension mismatch in cache file");
+    std::vector<ValueType> values;
+    values.reserve(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        values.push_back(readValue<ValueType>(in));
+    }
+    return values;
+}
+
+void writeIndices(std::ostream& out, std::vector<size_t> const& indices) {
+    writePod<uint64_t>(out, indices.size());
+    for (auto index : indices) {
+        writePod<uint64_t>(out, index);
+    }
+}
+
+std::vector<size_t> readIndices(std::istream& in, uint64_t bound) {
+    uint64_t size = readPod<uint64_t>(in);
+    STORM_LOG_THROW(size <= bound, storm::exceptions::FileIoException, "Corrupt cache file");
+    std::vector<size_t> indices(size);
+    for (auto& index : indices) {
+        index = readPod<uint64_t>(in);
+        STORM_LOG_THROW(index < bound, storm::exceptions::FileIoException, "Corrupt cache file");
+    }
+    return indices;
+}
+
+template<typename ValueType>
+uint32_t getValueTypeTag() {
+    return std::is_same<ValueType, double>::value ? 0 : 1;
+}
+
+template<typename ValueType>
+void writeHeader(std::ostream& out, std::string const& magic) {
+    out.write(magic.data(), magic.size());
+    writePod<uint32_t>(out, LeafDiskCache<ValueType>::FORMAT_VERSION);
+    writePod<uint32_t>(out, getValueTypeTag<ValueType>());
+}
+
+template<typename ValueType>
+bool readHeader(std::istream& in, std::string const& magic) {
+    std::string fileMagic(magic.size(), '\0');
+    in.read(&fileMagic[0], magic.size());
+    if (!in || fileMagic != magic) {
+        return false;
+    }
+    uint32_t version = readPod<uint32_t>(in);
+    uint32_t valueTypeTag = readPod<uint32_t>(in);
+    STORM_LOG_WARN_COND(version == LeafDiskCache<ValueType>::FORMAT_VERSION, "Ignoring cache file with format version " << version);
+    return version == LeafDiskCache<ValueType>::FORMAT_VERSION && valueTypeTag == getValueTypeTag<ValueType>();
+}
+
+// Writes to a temporary file with a unique name first, so concurrent runs neither write into the same file nor read a partially written one
+void writeFile(std::string const& path, std::function<void(std::ostream&)> const& write) {
+    std::random_device random;
+    std::stringstream temporaryPath;
+    temporaryPath << path << "." << std::hex << random() << random() << ".tmp";
+    try {
+        {
+            std::ofstream out(temporaryPath.str(), std::ios::binary);
+            STORM_LOG_THROW(out, storm::exceptions::FileIoException, "Could not open cache file " << temporaryPath.str());
+            write(out);
+            STORM_LOG_THROW(out, storm::exceptions::FileIoException, "Could not write cache file " << temporaryPath.str());
+        }
+        std::filesystem::rename(temporaryPath.str(), path);
+    } catch (...) {
+        std::error_code error;
+        std::filesystem::remove(temporaryPath.str(), error);
+        throw;
+    }
+}
+
+// Everything of the leaf that the Pareto bounds depend on besides the transition values, stored next to the hashes to reject collisions
+template<typename ValueType>
+void writeLeafSignature(std::ostream& out, models::ConcreteMdp<ValueType> const& leaf, uint64_t secondHash) {
+    auto const& matrix = leaf.getMdp()->getTransitionMatrix();
+    writePod<uint64_t>(out, secondHash);
+    writePod<uint64_t>(out, matrix.getRowGroupCount());
+    writePod<uint64_t>(out, matrix.getRowCount());
+    writePod<uint64_t>(out, matrix.getEntryCount());
+    writeIndices(out, leaf.getLEntrance());
+    writeIndices(out, leaf.getREntrance());
+    writeIndices(out, leaf.getLExit());
+    writeIndices(out, leaf.getRExit());
+}
+
+template<typename ValueType>
+bool readLeafSignature(std::istream& in, models::ConcreteMdp<ValueType> const& leaf, uint64_t secondHash) {
+    auto const& matrix = leaf.getMdp()->getTransitionMatrix();
+    uint64_t stateCount = matrix.getRowGroupCount();
+    bool matches = readPod<uint64_t>(in) == secondHash;
+    matches &= readPod<uint64_t>(in) == stateCount;
+    matches &= readPod<uint64_t>(in) == matrix.getRowCount();
+    matches &= readPod<uint64_t>(in) == matrix.getEntryCount();
+    matches &= readIndices(in, stateCount) == leaf.getLEntrance();
+    matches &= readIndices(in, stateCount) == leaf.getREntrance();
+    matches &= readIndices(in, stateCount) == leaf.getLExit();
+    matches &= readIndices(in, stateCount) == leaf.getRExit();
+    return matches;
+}
+}  // namespace
+
+template<typename ValueType>
+LeafDiskCache<ValueType>::LeafDiskCache(std::string const& directory) : directory(directory) {
+    std::filesystem::create_directories(directory);
+}
+
+template<typename ValueType>
+void LeafDiskCache<ValueType>::invalidate() {
+    for (auto const& file : std::filesystem::directory_iterator(directory)) {
+        auto extension = file.path().extension().string();
+        if (file.is_regular_file() && (extension == LEAF_EXTENSION || extension == PARETO_EXTENSION)) {
+            std::filesystem::remove(file.path());
+        }
+    }
+}
+
+template<typename ValueType>
+std::shared_ptr<models::ConcreteMdp<ValueType>> LeafDiskCache<ValueType>::loadLeaf(std::string const& key,
+                                                                                  std::weak_ptr<models::OpenMdpManager<ValueType>> manager) const {
+    Hasher hasher;
+    hasher.add(key);
+    std::ifstream in(getPath(hasher.get(), LEAF_EXTENSION), std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+
+    try {
+        if (!readHeader<ValueType>(in, LEAF_MAGIC) || readString(in) != key) {
+            return nullptr;
+        }
+
+        uint64_t rowCount = readPod<uint64_t>(in);
+        uint64_t columnCount = readPod<uint64_t>(in);
+        uint64_t entryCount = readPod<uint64_t>(in);
+        uint64_t rowGroupCount = readPod<uint64_t>(in);
+        std::vector<uint64_t> rowGroupIndices(rowGroupCount + 1);
+        for (uint64_t group = 0; group <= rowGroupCount; ++group) {
+            rowGroupIndices[group] = readPod<uint64_t>(in);
+            STORM_LOG_THROW(group == 0 ? rowGroupIndices[group] == 0 : rowGroupIndices[group] >= rowGroupIndices[group - 1],
+                            storm::exceptions::FileIoException, "Corrupt cache file");
+        }
+        STORM_LOG_THROW(rowGroupIndices.back() == rowCount && rowGroupCount == columnCount, storm::exceptions::FileIoException, "Corrupt cache file");
+
+        storm::storage::SparseMatrixBuilder<ValueType> builder(rowCount, columnCount, entryCount, true, true, rowGroupCount);
+        for (uint64_t group = 0; group < rowGroupCount; ++group) {
+            builder.newRowGroup(rowGroupIndices[group]);
+            for (uint64_t row = rowGroupIndices[group]; row < rowGroupIndices[group + 1]; ++row) {
+                uint64_t rowEntryCount = readPod<uint64_t>(in);
+                for (uint64_t i = 0; i < rowEntryCount; ++i) {
+                    uint64_t column = readPod<uint64_t>(in);
+                    builder.addNextValue(row, column, readValue<ValueType>(in));
+                }
+            }
+        }
+
+        storm::models::sparse::StateLabeling labeling(columnCount);
+        uint64_t labelCount = readPod<uint64_t>(in);
+        for (uint64_t i = 0; i < labelCount; ++i) {
+            std::string label = readString(in);
+            storm::storage::BitVector states(columnCount);
+            for (auto state : readIndices(in, columnCount)) {
+                states.set(state);
+            }
+            labeling.addLabel(label, std::move(states));
+        }
+
+        auto lEntrance = readIndices(in, columnCount);
+        auto rEntrance = readIndices(in, columnCount);
+        auto lExit = readIndices(in, columnCount);
+        auto rExit = readIndices(in, columnCount);
+
+        storm::storage::sparse::ModelComponents<ValueType> components(builder.build(), std::move(labeling));
+        auto mdp = std::make_shared<storm::models::sparse::Mdp<ValueType>>(std::move(components));
+        return std::make_shared<models::ConcreteMdp<ValueType>>(manager, mdp, lEntrance, rEntrance, lExit, rExit);
+    } catch (storm::exceptions::BaseException const& e) {
+        STORM_LOG_WARN("Ignoring cached leaf: " << e.what());
+        return nullptr;
+    }
+}
+
+template<typename ValueType>
+void LeafDiskCache<ValueType>::storeLeaf(std::string const& key, models::ConcreteMdp<ValueType> const& leaf) const {
+    Hasher hasher;
+    hasher.add(key);
+    auto const& mdp = *leaf.getMdp();
+    auto const& matrix = mdp.getTransitionMatrix();
+
+    writeFile(getPath(hasher.get(), LEAF_EXTENSION), [&](std::ostream& out) {
+        writeHeader<ValueType>(out, LEAF_MAGIC);
+        writeString(out, key);
+
+        writePod<uint64_t>(out, matrix.getRowCount());
+        writePod<uint64_t>(out, matrix.getColumnCount());
+        writePod<uint64_t>(out, matrix.getEntryCount());
+        writePod<uint64_t>(out, matrix.getRowGroupCount());
+        for (auto index : matrix.getRowGroupIndices()) {
+            writePod<uint64_t>(out, index);
+        }
+        for (uint64_t row = 0; row < matrix.getRowCount(); ++row) {
+            writePod<uint64_t>(out, matrix.getRow(row).getNumberOfEntries());
+            for (auto const& entry : matrix.getRow(row)) {
+                writePod<uint64_t>(out, entry.getColumn());
+                writeValue(out, entry.getValue());
+            }
+        }
+
+        auto const& labeling = mdp.getStateLabeling();
+        auto labels = labeling.getLabels();
+        writePod<uint64_t>(out, labels.size());
+        for (auto const& label : labels) {
+            writeString(out, label);
+            auto const& states = labeling.getStates(label);
+            writeIndices(out, std::vector<size_t>(states.begin(), states.end()));
+        }
+
+        writeIndices(out, leaf.getLEntrance());
+        writeIndices(out, leaf.getREntrance());
+        writeIndices(out, leaf.getLExit());
+        writeIndices(out, leaf.getRExit());
+    });
+}
+
+template<typename ValueType>
+std::shared_ptr<PrecomputedParetoSet<ValueType> const> LeafDiskCache<ValueType>::loadParetoSet(models::ConcreteMdp<ValueType> const& leaf) const {
+    auto leafHash = hashLeaf(leaf);
+    std::ifstream in(getPath(leafHash.first, PARETO_EXTENSION), std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+
+    try {
+        if (!readHeader<ValueType>(in, PARETO_MAGIC) || readPod<uint64_t>(in) != leafHash.first) {
+            return nullptr;
+        }
+        if (!readLeafSignature(in, leaf, leafHash.second)) {
+            STORM_LOG_WARN("Ignoring cached Pareto bounds of another leaf with the same hash");
+            return nullptr;
+        }
+
+        uint64_t entranceCount = readPod<uint64_t>(in);
+        STORM_LOG_THROW(entranceCount == leaf.getEntranceCount(), storm::exceptions::FileIoException, "Entrance count mismatch in cache file");
+        size_t dimension = leaf.getExitCount();
+
+        auto result = std::make_shared<PrecomputedParetoSet<ValueType>>(entranceCount);
+        for (uint64_t entrance = 0; entrance < entranceCount; ++entrance) {
+            uint64_t pointCount = readPod<uint64_t>(in);
+            for (uint64_t i = 0; i < pointCount; ++i) {
+                result->addPoint(entrance, readVector<ValueType>(in, dimension));
+            }
+            uint64_t halfspaceCount = readPod<uint64_t>(in);
+            for (uint64_t i = 0; i < halfspaceCount; ++i) {
+                auto normal = readVector<ValueType>(in, dimension);
+                result->addHalfspace(entrance, normal, readValue<ValueType>(in));
+            }
+        }
+        return result;
+    } catch (storm::exceptions::BaseException const& e) {
+        STORM_LOG_WARN("Ignoring cached Pareto bounds: " << e.what());
+        return nullptr;
+    }
+}
+
+template<typename ValueType>
+void LeafDiskCache<ValueType>::storeParetoSet(models::ConcreteMdp<ValueType> const& leaf, PrecomputedParetoSet<ValueType> const& paretoSet) const {
+    auto leafHash = hashLeaf(leaf);
+
+    writeFile(getPath(leafHash.first, PARETO_EXTENSION), [&](std::ostream& out) {
+        writeHeader<ValueType>(out, PARETO_MAGIC);
+        writePod<uint64_t>(out, leafHash.first);
+        writeLeafSignature(out, leaf, leafHash.second);
+        writePod<uint64_t>(out, paretoSet.getEntranceCount());
+        for (size_t entrance = 0; entrance < paretoSet.getEntranceCount(); ++entrance) {
+            writePod<uint64_t>(out, paretoSet.getPoints(entrance).size());
+            for (auto const& point : paretoSet.getPoints(entrance)) {
+                writeVector(out, point);
+            }
+            writePod<uint64_t>(out, paretoSet.getHalfspaces(entrance).size());
+            for (auto const& halfspace : paretoSet.getHalfspaces(entrance)) {
+                writeVector(out, halfspace.first);
+                writeValue(out, halfspace.second);
+            }
+        }
+    });
+}
+
+template<typename ValueType>
+std::string LeafDiskCache<ValueType>::getPath(uint64_t hash, std::string const& extension) const {
+    std::stringstream fileName;
+    fileName << std::hex << std::setw(16) << std::setfill('0') << hash << extension;
+    return (std::filesystem::path(directory) / fileName.str()).string();
+}
+
+template<typename ValueType>
+std::pair<uint64_t, uint64_t> LeafDiskCache<ValueType>::hashLeaf(models::ConcreteMdp<ValueType> const& leaf) {
+    Hasher hasher;
+    auto const& matrix = leaf.getMdp()->getTransitionMatrix();
+    for (auto index : matrix.getRowGroupIndices()) {
+        hasher.add(uint64_t(index));
+    }
+    for (uint64_t row = 0; row < matrix.getRowCount(); ++row) {
+        hasher.add(uint64_t(matrix.getRow(row).getNumberOfEntries()));
+        for (auto const& entry : matrix.getRow(row)) {
+            hasher.add(uint64_t(entry.getColumn()));
+            hasher.add(entry.getValue());
+        }
+    }
+
+    auto addIndices = [&](std::vector<size_t> const& indices) {
+        hasher.add(uint64_t(indices.size()));
+        for (auto index : indices) {
+            hasher.add(uint64_t(index));
+        }
+    };
+    addIndices(leaf.getLEntrance());
+    addIndices(leaf.getREntrance());
+    addIndices(leaf.getLExit());
+    addIndices(leaf.getRExit());
+    return {hasher.get(), hasher.getSecond()};
+}
+
+template class LeafDiskCache<double>;
+template class LeafDiskCache<storm::RationalNumber>;
+
+}  // namespace storage
+}  // namespace storm
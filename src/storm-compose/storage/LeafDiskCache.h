@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "PrecomputedParetoSet.h"
+
+namespace storm {
+namespace models {
+template<typename ValueType>
+class ConcreteMdp;
+template<typename ValueType>
+class OpenMdpManager;
+}  // namespace models
+
+namespace storage {
+
+// Cache directory that keeps built leaves and the Pareto bounds computed for them between runs.
+//
+// A leaf is stored under the hash of its key (see OpenMdpManager), the file contains the transition matrix, the state labeling and the
+// entrance and exit indices. Pareto bounds are stored under the hash of the built leaf, so they are found for every reference to an identical
+// MDP, independently of how it was specified. As the Pareto bounds are trusted, their file also stores a second, independent hash of the leaf,
+// its state, choice and transition counts and its entrances and exits. Files are a flat binary layout with a header containing the format
+// version and the value type. Files with another version or value type, or with a different key or leaf (hash collision), are ignored and
+// overwritten.
+template<typename ValueType>
+class LeafDiskCache {
+   public:
+    constexpr static uint32_t FORMAT_VERSION = 2;
+
+    LeafDiskCache(std::string const& directory);
+
+    /// Removes all cache files from the directory
+    void invalidate();
+
+    /// Returns nullptr if the leaf is not in the cache
+    std::shared_ptr<models::ConcreteMdp<ValueType>> loadLeaf(std::string const& key, std::weak_ptr<models::OpenMdpManager<ValueType>> manager) const;
+    void storeLeaf(std::string const& key, models::ConcreteMdp<ValueType> const& leaf) const;
+
+    /// Returns nullptr if no bounds are stored for the leaf
+    std::shared_ptr<PrecomputedParetoSet<ValueType> const> loadParetoSet(models::ConcreteMdp<ValueType> const& leaf) const;
+    void storeParetoSet(models::ConcreteMdp<ValueType> const& leaf, PrecomputedParetoSet<ValueType> const& paretoSet) const;
+
+   private:
+    std::string getPath(uint64_t hash, std::string const& extension) const;
+    // The hash that names the file and a second, independent one
+    static std::pair<uint64_t, uint64_t> hashLeaf(models::ConcreteMdp<ValueType> const& leaf);
+
+    std::string directory;
+};
+
+}  // namespace storage
+}  // namespace storm
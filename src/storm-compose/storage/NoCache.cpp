@@ -22,6 +22,11 @@ bool NoCache<ValueType>::needScheduler() {
     return false;
 }
 
+template<typename ValueType>
+bool NoCache<ValueType>::isThreadSafe() const {
+    return true;
+}
+
 template class NoCache<double>;
 template class NoCache<storm::RationalNumber>;
 
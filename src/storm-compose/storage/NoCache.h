@@ -16,6 +16,7 @@ class NoCache : public AbstractCache<ValueType> {
     void addToCache(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight, WeightType inputWeight,
                     boost::optional<storm::storage::Scheduler<ValueType>> sched = boost::none) override;
     bool needScheduler() override;
+    bool isThreadSafe() const override;
 };
 
 }  // namespace storage
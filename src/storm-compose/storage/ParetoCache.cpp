@@ -1,5 +1,12 @@
 #include "ParetoCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <type_traits>
+
 #include "environment/solver/MinMaxSolverEnvironment.h"
+#include "environment/solver/NativeSolverEnvironment.h"
 #include "environment/solver/SolverEnvironment.h"
 #include "exceptions/BaseException.h"
 #include "exceptions/InvalidArgumentException.h"
@@ -11,22 +18,93 @@
 #include "storm-compose/models/visitor/BidirectionalReachabilityResult.h"
 #include "storm-compose/storage/EntranceExit.h"
 #include "storm/environment/Environment.h"
-#include "storm/modelchecker/prctl/helper/SparseDtmcPrctlHelper.h"
-#include "storm/solver/SolveGoal.h"
+#include "storm/solver/LinearEquationSolver.h"
+#include "storm/utility/NumberTraits.h"
 #include "storm/utility/constants.h"
+#include "storm/utility/graph.h"
 #include "storm/utility/vector.h"
 #include "utility/Stopwatch.h"
 
 namespace storm {
 namespace storage {
 
+namespace {
+// Number of insertions into a leaf that are built without its lock before falling back to building under the exclusive lock
+const size_t OPTIMISTIC_INSERTION_ATTEMPTS = 2;
+
+// Guaranteed absolute error of the exit probabilities of inserted schedulers
+const double EXIT_PROBABILITY_PRECISION = 1e-6;
+
+// Interval iteration returns the midpoint of a lower and upper bound at most twice the precision apart, so every value is within the precision
+storm::Environment getExitProbabilityEnvironment() {
+    storm::Environment env;
+    env.solver().setForceSoundness(true);
+    env.solver().setLinearEquationSolverType(storm::solver::EquationSolverType::Native);
+    env.solver().native().setMethod(storm::solver::NativeLinearEquationSolverMethod::IntervalIteration);
+    env.solver().native().setPrecision(storm::utility::convertNumber<storm::RationalNumber>(EXIT_PROBABILITY_PRECISION));
+    env.solver().native().setRelativeTerminationCriterion(false);
+    return env;
+}
+
+// Largest amount by which a coordinate of the point exceeds the other point, zero if the point is dominated by the other point
+template<typename T>
+T getExcess(std::vector<T> const& point, std::vector<T> const& other) {
+    T excess = storm::utility::zero<T>();
+    for (size_t i = 0; i < point.size(); ++i) {
+        excess = storm::utility::max<T>(excess, point[i] - other[i]);
+    }
+    return excess;
+}
+}  // namespace
+
+template<typename ValueType>
+ParetoCache<ValueType>::ParetoCache() : ParetoCache(Options()) {}
+
+template<typename ValueType>
+ParetoCache<ValueType>::ParetoCache(Options const& options)
+    : useFloatingPointFastPath(options.floatingPointFastPath && std::is_same<ValueType, double>::value),
+      useVertexUpperBounds(options.vertexUpperBounds),
+      useLipschitzBounds(options.lipschitzBounds),
+      pruneBounds(options.pruneBounds),
+      entranceBudget(options.entranceBudget),
+      solverPrecision(storm::utility::convertNumber<ParetoRational>(options.solverPrecision)),
+      exitProbabilityPrecision(storm::NumberTraits<ValueType>::IsExact ? storm::utility::zero<ParetoRational>()
+                                                                        : storm::utility::convertNumber<ParetoRational>(EXIT_PROBABILITY_PRECISION)) {}
+
 template<typename ValueType>
 boost::optional<typename ParetoCache<ValueType>::WeightType> ParetoCache<ValueType>::getLowerBound(models::ConcreteMdp<ValueType>* ptr,
                                                                                                    WeightType outputWeight) {
     // std::cout << "Cache context, model " << ptr->getName() << " weight " << storm::utility::vector::toString(outputWeight) << std::endl;;
+    if (queryTrace) {
+        queryTrace->recordLowerBoundQuery(ptr, outputWeight);
+    }
+    if (auto lipschitzBounds = getLipschitzBounds(ptr, outputWeight)) {
+        return lipschitzBounds->first;
+    }
 
-    ParetoPointType convertedOutputWeight = storm::utility::vector::convertNumericVector<ParetoRational>(outputWeight);
     WeightType lowerBound(ptr->getEntranceCount());
+    storm::utility::Stopwatch timer(true);
+
+    if (useFloatingPointFastPath) {
+        std::vector<double> floatOutputWeight = storm::utility::vector::convertNumericVector<double>(outputWeight);
+        size_t weightIndex = 0;
+        auto processEntrances = [&](const auto& entrances, storage::EntranceExit entrance) {
+            for (size_t i = 0; i < entrances.size(); ++i) {
+                Position pos = {entrance, i};
+                lowerBound[weightIndex] = storm::utility::convertNumber<ValueType>(getFloatBoundsSnapshot(ptr, pos)->maximizeLowerBound(floatOutputWeight));
+                ++weightIndex;
+            }
+        };
+
+        processEntrances(ptr->getLEntrance(), storage::L_ENTRANCE);
+        processEntrances(ptr->getREntrance(), storage::R_ENTRANCE);
+
+        timer.stop();
+        recordArithmeticTime(timer, false);
+        return lowerBound;
+    }
+
+    ParetoPointType convertedOutputWeight = storm::utility::vector::convertNumericVector<ParetoRational>(outputWeight);
 
     size_t weightIndex = 0;
     auto processEntrances = [&](const auto& entrances, storage::EntranceExit entrance) {
@@ -42,6 +120,8 @@ boost::optional<typename ParetoCache<ValueType>::WeightType> ParetoCache<ValueTy
     processEntrances(ptr->getLEntrance(), storage::L_ENTRANCE);
     processEntrances(ptr->getREntrance(), storage::R_ENTRANCE);
 
+    timer.stop();
+    recordArithmeticTime(timer, true);
     return lowerBound;
 }
 
@@ -49,19 +129,54 @@ boost::optional<typename ParetoCache<ValueType>::WeightType> ParetoCache<ValueTy
 template<typename ValueType>
 boost::optional<typename ParetoCache<ValueType>::WeightType> ParetoCache<ValueType>::getUpperBound(models::ConcreteMdp<ValueType>* ptr,
                                                                                                    WeightType outputWeight) {
+    if (queryTrace) {
+        queryTrace->recordUpperBoundQuery(ptr, outputWeight);
+    }
+    if (auto lipschitzBounds = getLipschitzBounds(ptr, outputWeight)) {
+        std::lock_guard<std::mutex> lock(arithmeticStatisticsMutex);
+        ++arithmeticStatistics.lipschitzUpperBounds;
+        return lipschitzBounds->second;
+    }
+
     ParetoPointType convertedOutputWeight = storm::utility::vector::convertNumericVector<ParetoRational>(outputWeight);
+    std::vector<double> floatOutputWeight;
+    if (useFloatingPointFastPath) {
+        floatOutputWeight = storm::utility::vector::convertNumericVector<double>(outputWeight);
+    }
+    double tolerance = storm::utility::convertNumber<double>(this->errorTolerance);
     WeightType upperBound(ptr->getEntranceCount());
 
     size_t weightIndex = 0;
     auto processEntrances = [&](const auto& entrances, storage::EntranceExit entrance) {
         for (size_t i = 0; i < entrances.size(); ++i) {
             Position pos = {entrance, i};
+
+            if (useFloatingPointFastPath) {
+                // The floating point bounds are sound but not exact. Only if the gap is so close to the tolerance that the (tiny) difference
+                // to the exact optimum could change the decision of the caller, the exact polytope is consulted.
+                storm::utility::Stopwatch floatTimer(true);
+                auto floatBounds = getFloatBoundsSnapshot(ptr, pos);
+                auto floatUpper = floatBounds->maximizeUpperBound(floatOutputWeight);
+                double floatGap = floatUpper ? *floatUpper - floatBounds->maximizeLowerBound(floatOutputWeight) : 0;
+                floatTimer.stop();
+                recordArithmeticTime(floatTimer, false, true);
+
+                if (floatUpper && std::abs(floatGap - tolerance) > FLOAT_FALLBACK_MARGIN * std::max(1.0, tolerance)) {
+                    upperBound[weightIndex] = storm::utility::convertNumber<ValueType>(*floatUpper);
+                    ++weightIndex;
+                    continue;
+                }
+            }
+
+            storm::utility::Stopwatch exactTimer(true);
             try {
                 const auto& ub = getBestUpperBound(ptr, convertedOutputWeight, pos);
                 upperBound[weightIndex] = storm::utility::convertNumber<ValueType>(storm::utility::vector::dotProduct(ub, convertedOutputWeight));
             } catch (storm::exceptions::BaseException e) {
                 return false;
             }
+            exactTimer.stop();
+            recordArithmeticTime(exactTimer, true, true);
             ++weightIndex;
         }
         return true;
@@ -84,51 +199,19 @@ template<typename ValueType>
 void ParetoCache<ValueType>::addToCache(models::ConcreteMdp<ValueType>* ptr, std::vector<ValueType> outputWeight, std::vector<ValueType> inputWeight,
                                         boost::optional<storm::storage::Scheduler<ValueType>> sched) {
     STORM_LOG_THROW(sched, storm::exceptions::InvalidArgumentException, "need scheduler present");
+    if (queryTrace) {
+        queryTrace->recordInsertion(ptr, outputWeight, inputWeight, sched);
+    }
+
     ParetoPointType convertedOutputWeight = storm::utility::vector::convertNumericVector<ParetoRational>(outputWeight);
     ParetoPointType normalizedOutputWeight = ParetoPointType(convertedOutputWeight);
     storm::utility::vector::normalizeInPlace(normalizedOutputWeight);
 
     // std::cout << "Adding something to the cache of concrete mdp " << ptr->getName() << std::endl;
 
-    size_t stateCount = ptr->getMdp()->getTransitionMatrix().getRowGroupCount();
-    storage::BitVector phi(stateCount, true);
-
-    storm::Environment env;
-
-    // TODO make configurable:
-    env.solver().minMax().setMethod(solver::MinMaxMethod::OptimisticValueIteration);
-    env.solver().minMax().setPrecision(1e-5);
-    // Store point for each entrance
-    std::vector<ParetoPointType> points(ptr->getEntranceCount());
-
-    // Compute induced Markov chain
-    auto mc = ptr->getMdp()->applyScheduler(*sched, false);
-
-    // For each exit, compute the reachability probabilty for each entrance
-    auto processExits = [&](const auto& exits) {
-        for (size_t exitState : exits) {
-            storage::BitVector psi(stateCount);
-            psi.set(exitState);
-
-            storm::solver::SolveGoal<ValueType> goal(false);
-            modelchecker::helper::SparseDtmcPrctlHelper<ValueType> helper;
-            auto values = helper.computeUntilProbabilities(env, std::move(goal), mc->getTransitionMatrix(), mc->getBackwardTransitions(), phi, psi, false);
-
-            size_t entranceIndex = 0;
-            for (size_t entranceState : ptr->getLEntrance()) {
-                points[entranceIndex].push_back(values[entranceState]);
-                ++entranceIndex;
-            }
-            for (size_t entranceState : ptr->getREntrance()) {
-                points[entranceIndex].push_back(values[entranceState]);
-                ++entranceIndex;
-            }
-        }
-    };
-    processExits(ptr->getLExit());
-    processExits(ptr->getRExit());
+    std::vector<ParetoPointType> points = computeExitProbabilities(ptr, *sched);
 
-    // Now that we have the points, update the lower and upper bounds:
+    // Now that we have the points, update the lower and upper bounds. Only publishing the new bounds needs exclusive access to the leaf.
     size_t entranceIndex = 0;
     size_t leftEntranceCount = ptr->getLEntrance().size();
     for (const auto& p : points) {
@@ -138,10 +221,13 @@ void ParetoCache<ValueType>::addToCache(models::ConcreteMdp<ValueType>* ptr, std
         Position pos{entranceExit, realEntranceIndex};
 
         std::pair<models::ConcreteMdp<ValueType>*, Position> key{ptr, pos};
-        updateLowerUpperBounds(key, p, normalizedOutputWeight);
+        updateLowerUpperBounds(key, p, normalizedOutputWeight, outputWeight);
 
         ++entranceIndex;
     }
+    if (useLipschitzBounds) {
+        addToWeightIndex(ptr, outputWeight, points);
+    }
 
     // auto lb = *getLowerBound(ptr, outputWeight);
     // auto ub = *getUpperBound(ptr, outputWeight);
@@ -155,31 +241,539 @@ void ParetoCache<ValueType>::addToCache(models::ConcreteMdp<ValueType>* ptr, std
 }
 
 template<typename ValueType>
-void ParetoCache<ValueType>::updateLowerUpperBounds(std::pair<models::ConcreteMdp<ValueType>*, Position> key, ParetoPointType point, ParetoPointType weight) {
-    auto& lb = lowerBounds[key];
-    auto& ub = upperBounds[key];
+std::vector<typename ParetoCache<ValueType>::ParetoPointType> ParetoCache<ValueType>::computeExitProbabilities(
+    models::ConcreteMdp<ValueType>* ptr, storm::storage::Scheduler<ValueType> const& sched) const {
+    STORM_LOG_THROW(sched.isMemorylessScheduler() && sched.isDeterministicScheduler(), storm::exceptions::InvalidArgumentException,
+                    "need a memoryless deterministic scheduler");
+    auto const& transitionMatrix = ptr->getMdp()->getTransitionMatrix();
+    size_t stateCount = transitionMatrix.getRowGroupCount();
+
+    // The chain induced by the scheduler is read off the chosen rows, the induced model is never built
+    std::vector<uint64_t> choices(stateCount);
+    for (size_t state = 0; state < stateCount; ++state) {
+        auto const& choice = sched.getChoice(state);
+        choices[state] = choice.isDefined() ? choice.getDeterministicChoice() : 0;
+    }
+
+    // Exits are absorbing, as in the weighted reachability queries that produced the scheduler
+    std::vector<size_t> exits(ptr->getLExit());
+    exits.insert(exits.end(), ptr->getRExit().begin(), ptr->getRExit().end());
+    std::vector<size_t> entrances(ptr->getLEntrance());
+    entrances.insert(entrances.end(), ptr->getREntrance().begin(), ptr->getREntrance().end());
+
+    storage::BitVector exitStates(stateCount);
+    std::vector<size_t> exitIndex(stateCount);
+    for (size_t i = 0; i < exits.size(); ++i) {
+        exitStates.set(exits[i]);
+        exitIndex[exits[i]] = i;
+    }
+
+    std::vector<ParetoPointType> points(entrances.size(), ParetoPointType(exits.size(), storm::utility::zero<ParetoRational>()));
+    for (size_t i = 0; i < entrances.size(); ++i) {
+        if (exitStates.get(entrances[i])) {
+            points[i][exitIndex[entrances[i]]] = storm::utility::one<ParetoRational>();
+        }
+    }
+
+    // Only states that reach some exit need to be solved, all others have probability zero for every exit
+    auto backwardTransitions = transitionMatrix.transposeSelectedRowsFromRowGroups(choices);
+    storage::BitVector maybeStates = storm::utility::graph::performProbGreater0(backwardTransitions, ~exitStates, exitStates) & ~exitStates;
+    if (maybeStates.empty()) {
+        return points;
+    }
+
+    // One right-hand side per exit, stored interleaved: the probability of moving from a maybe state directly into that exit
+    size_t maybeCount = maybeStates.getNumberOfSetBits();
+    size_t exitCount = exits.size();
+    std::vector<ValueType> b(maybeCount * exitCount, storm::utility::zero<ValueType>());
+    size_t maybeIndex = 0;
+    for (auto state : maybeStates) {
+        for (auto const& entry : transitionMatrix.getRow(state, choices[state])) {
+            if (exitStates.get(entry.getColumn())) {
+                b[maybeIndex * exitCount + exitIndex[entry.getColumn()]] += entry.getValue();
+            }
+        }
+        ++maybeIndex;
+    }
 
-    storage::geometry::Halfspace<ParetoRational> newHalfspace(weight, point);  // TODO add OVI epsilon
+    // Exact types are solved exactly, otherwise interval iteration bounds the error of each probability by EXIT_PROBABILITY_PRECISION
+    storm::Environment env = storm::NumberTraits<ValueType>::IsExact ? storm::Environment() : getExitProbabilityEnvironment();
+    storm::solver::GeneralLinearEquationSolverFactory<ValueType> linearEquationSolverFactory;
+    bool convertToEquationSystem =
+        linearEquationSolverFactory.getEquationProblemFormat(env) == storm::solver::LinearEquationSolverProblemFormat::EquationSystem;
+    storm::storage::SparseMatrix<ValueType> submatrix =
+        transitionMatrix.selectRowsFromRowGroups(choices, convertToEquationSystem).getSubmatrix(false, maybeStates, maybeStates, convertToEquationSystem);
+    if (convertToEquationSystem) {
+        submatrix.convertToEquationSystem();
+    }
 
-    lb.push_back(point);
-    ub = ub->intersection(newHalfspace);
+    // All exits are solved together
+    auto solver = linearEquationSolverFactory.create(env, std::move(submatrix));
+    solver->setBounds(storm::utility::zero<ValueType>(), storm::utility::one<ValueType>());
+    std::vector<ValueType> x(maybeCount * exitCount, storm::utility::zero<ValueType>());
+    solver->solveEquationsBlock(env, x, b, exitCount);
+    for (size_t i = 0; i < entrances.size(); ++i) {
+        if (maybeStates.get(entrances[i])) {
+            size_t offset = maybeStates.getNumberOfSetBitsBeforeIndex(entrances[i]) * exitCount;
+            for (size_t exit = 0; exit < exitCount; ++exit) {
+                points[i][exit] = storm::utility::convertNumber<ParetoRational>(x[offset + exit]);
+            }
+        }
+    }
+
+    return points;
 }
 
 template<typename ValueType>
-bool ParetoCache<ValueType>::isInitialized(models::ConcreteMdp<ValueType>* ptr) const {
-    Position leftPos{L_ENTRANCE, 0};
-    const auto it1 = lowerBounds.find({ptr, leftPos});
-    if (it1 != lowerBounds.end()) {
-        return true;
+void ParetoCache<ValueType>::updateLowerUpperBounds(std::pair<models::ConcreteMdp<ValueType>*, Position> key, ParetoPointType point, ParetoPointType weight,
+                                                    WeightType const& outputWeight) {
+    LeafEntry& entry = getOrCreateEntry(key.first);
+    size_t dimension = point.size();
+
+    // The scheduler is only close to optimal and its exit probabilities are approximate, so the true optimum may exceed the point in the
+    // weight direction by the padding (given for the unnormalized weight, which is scaled like the weight)
+    ParetoRational scale = storm::utility::zero<ParetoRational>();
+    for (size_t i = 0; i < dimension && storm::utility::isZero(scale); ++i) {
+        ParetoRational unnormalized = storm::utility::convertNumber<ParetoRational>(outputWeight[i]);
+        if (!storm::utility::isZero(unnormalized)) {
+            scale = weight[i] / unnormalized;
+        }
+    }
+    ParetoRational padding = getUpperBoundPadding(outputWeight);
+    storage::geometry::Halfspace<ParetoRational> newHalfspace(weight, storm::utility::vector::dotProduct(weight, point) + padding * scale);
+
+    // The floating point halfspace uses the original (unnormalized) weight, which is exactly representable
+    std::vector<double> floatWeight, floatPoint;
+    double floatPadding = 0;
+    if (useFloatingPointFastPath) {
+        floatWeight = storm::utility::vector::convertNumericVector<double>(outputWeight);
+        floatPoint = storm::utility::vector::convertNumericVector<double>(point);
+        floatPadding = storm::utility::convertNumber<double>(padding);
     }
 
-    Position rightPos{R_ENTRANCE, 0};
-    const auto it2 = lowerBounds.find({ptr, rightPos});
-    if (it2 != lowerBounds.end()) {
-        return true;
+    // Both require the lock of the leaf to be held
+    auto takeSnapshot = [&]() {
+        EntranceBounds bounds;
+        bounds.lowerBound = entry.lowerBounds.at(key.second);
+        if (useVertexUpperBounds) {
+            bounds.vertexUpperBound = entry.vertexUpperBounds.at(key.second);
+        } else {
+            bounds.upperBound = entry.upperBounds.at(key.second);
+        }
+        if (useFloatingPointFastPath) {
+            bounds.floatBounds = entry.floatBounds.at(key.second);
+        }
+        auto halfspaces = entry.halfspaces.find(key.second);
+        if (halfspaces != entry.halfspaces.end()) {
+            bounds.halfspaces = halfspaces->second;
+        }
+        auto prunedSize = entry.hullPrunedSizes.find(key.second);
+        if (prunedSize != entry.hullPrunedSizes.end()) {
+            bounds.hullPrunedSize = prunedSize->second;
+        }
+        return bounds;
+    };
+    auto publish = [&](EntranceBounds& bounds) {
+        entry.lowerBounds.at(key.second) = std::move(bounds.lowerBound);
+        if (useVertexUpperBounds) {
+            entry.vertexUpperBounds.at(key.second) = std::move(bounds.vertexUpperBound);
+        } else {
+            entry.upperBounds.at(key.second) = std::move(bounds.upperBound);
+        }
+        if (useFloatingPointFastPath) {
+            entry.floatBounds.at(key.second) = std::move(bounds.floatBounds);
+        }
+        entry.halfspaces[key.second] = std::move(bounds.halfspaces);
+        entry.hullPrunedSizes[key.second] = bounds.hullPrunedSize;
+        entry.version = ++versionCounter;
+    };
+
+    // The new bounds are built from a snapshot without holding the lock of the leaf, so readers are not blocked by the exact arithmetic. They are
+    // only published if no other insertion into the leaf happened in the meantime. Under contention the optimistic attempts may fail
+    // repeatedly, so after OPTIMISTIC_INSERTION_ATTEMPTS the bounds are built under the exclusive lock, which always succeeds.
+    PruningStatistics statistics;
+    bool published = false;
+    for (size_t attempt = 0; attempt < OPTIMISTIC_INSERTION_ATTEMPTS && !published; ++attempt) {
+        EntranceBounds bounds;
+        uint64_t version;
+        {
+            std::shared_lock<std::shared_mutex> lock(entry.mutex);
+            version = entry.version;
+            bounds = takeSnapshot();
+        }
+
+        statistics = PruningStatistics();
+        addPointToBounds(bounds, point, newHalfspace, floatWeight, floatPoint, floatPadding, statistics);
+
+        std::unique_lock<std::shared_mutex> lock(entry.mutex);
+        if (entry.version == version) {
+            publish(bounds);
+            published = true;
+        }
+    }
+    if (!published) {
+        std::unique_lock<std::shared_mutex> lock(entry.mutex);
+        EntranceBounds bounds = takeSnapshot();
+        statistics = PruningStatistics();
+        addPointToBounds(bounds, point, newHalfspace, floatWeight, floatPoint, floatPadding, statistics);
+        publish(bounds);
+    }
+
+    std::lock_guard<std::mutex> statisticsLock(arithmeticStatisticsMutex);
+    pruningStatistics.prunedPoints += statistics.prunedPoints;
+    pruningStatistics.redundantHalfspaces += statistics.redundantHalfspaces;
+    pruningStatistics.evictedPoints += statistics.evictedPoints;
+    pruningStatistics.evictedHalfspaces += statistics.evictedHalfspaces;
+}
+
+template<typename ValueType>
+void ParetoCache<ValueType>::addPointToBounds(EntranceBounds& bounds, ParetoPointType point, storage::geometry::Halfspace<ParetoRational> const& newHalfspace,
+                                              std::vector<double> const& floatWeight, std::vector<double> const& floatPoint, double floatPadding,
+                                              PruningStatistics& statistics) const {
+    size_t dimension = point.size();
+
+    // The point lies in the upper bound, so the halfspace is redundant if the upper bound does not exceed its offset in the weight direction
+    bool redundantHalfspace = false;
+    if (useVertexUpperBounds) {
+        auto newUb = bounds.vertexUpperBound->intersection(newHalfspace.normalVector(), newHalfspace.offset());
+        redundantHalfspace = pruneBounds && newUb == bounds.vertexUpperBound;
+        bounds.vertexUpperBound = std::move(newUb);
+    } else {
+        if (pruneBounds) {
+            auto optimum = bounds.upperBound->optimize(newHalfspace.normalVector());
+            redundantHalfspace = optimum.second && newHalfspace.contains(optimum.first);
+        }
+        if (!redundantHalfspace) {
+            bounds.upperBound = bounds.upperBound->intersection(newHalfspace);
+        }
+    }
+    if (redundantHalfspace) {
+        ++statistics.redundantHalfspaces;
+    } else {
+        bounds.halfspaces.emplace_back(newHalfspace.normalVector(), newHalfspace.offset());
+    }
+
+    // Copy on write, readers may still hold the previous versions
+    auto newLb = std::make_shared<LowerBoundType>(*bounds.lowerBound);
+    newLb->push_back(std::move(point));
+    size_t removedPoints = pruneBounds ? pruneLowerBound(bounds.hullPrunedSize, *newLb, statistics) : 0;
+    size_t evictedPoints = evictLowerBoundPoints(*newLb, statistics);
+    bool evictedHalfspaces = evictHalfspaces(bounds, *newLb, dimension, statistics);
+
+    if (useFloatingPointFastPath) {
+        auto newFloatBounds = std::make_shared<FloatParetoBounds>(*bounds.floatBounds);
+        if (redundantHalfspace) {
+            newFloatBounds->addLowerBoundPoint(floatPoint);
+        } else {
+            newFloatBounds->addPoint(floatWeight, floatPoint, floatPadding);
+        }
+        if (removedPoints + evictedPoints > 0) {
+            newFloatBounds->clearLowerBound();
+            for (auto const& lowerBoundPoint : *newLb) {
+                newFloatBounds->addLowerBoundPoint(storm::utility::vector::convertNumericVector<double>(lowerBoundPoint));
+            }
+        }
+        if (evictedHalfspaces) {
+            newFloatBounds->clearUpperBound();
+            for (auto const& halfspace : bounds.halfspaces) {
+                newFloatBounds->addHalfspace(storm::utility::vector::convertNumericVector<double>(halfspace.first),
+                                             storm::utility::convertNumber<double>(halfspace.second));
+            }
+        }
+        bounds.floatBounds = std::move(newFloatBounds);
+    }
+
+    bounds.lowerBound = std::move(newLb);
+}
+
+template<typename ValueType>
+size_t ParetoCache<ValueType>::pruneLowerBound(size_t& prunedSize, LowerBoundType& points, PruningStatistics& statistics) const {
+    // The new point is the last one, it is either dominated by another point or it may dominate some of the others
+    size_t initialSize = points.size();
+    auto const& newPoint = points.back();
+    bool newPointDominated =
+        std::any_of(points.begin(), points.end() - 1, [&](auto const& other) { return storm::utility::isZero(getExcess(newPoint, other)); });
+    if (newPointDominated) {
+        points.pop_back();
+    } else {
+        points.erase(std::remove_if(points.begin(), points.end() - 1, [&](auto const& other) { return storm::utility::isZero(getExcess(other, newPoint)); }),
+                     points.end() - 1);
+    }
+
+    // Points that are not dominated by a single other point can still lie below the convex hull, the hull is only recomputed once the
+    // number of points doubled
+    size_t dimension = points.front().size();
+    if (dimension >= 2 && dimension <= HULL_PRUNING_MAX_DIMENSION && points.size() >= 2 * std::max<size_t>(prunedSize, 2)) {
+        // A point in the interior of the downward closure never maximizes a non-negative weight
+        auto halfspaces = geometry::Polytope<ParetoRational>::createDownwardClosure(points)->getHalfspaces();
+        points.erase(std::remove_if(points.begin(), points.end(),
+                                    [&](auto const& point) {
+                                        return std::none_of(halfspaces.begin(), halfspaces.end(), [&](auto const& halfspace) {
+                                            return storm::utility::vector::dotProduct(halfspace.normalVector(), point) == halfspace.offset();
+                                        });
+                                    }),
+                     points.end());
+        prunedSize = points.size();
+    }
+
+    size_t removedPoints = initialSize - points.size();
+    statistics.prunedPoints += removedPoints;
+    // The new point itself is not counted as removed from the lower bound
+    return newPointDominated ? removedPoints - 1 : removedPoints;
+}
+
+template<typename ValueType>
+size_t ParetoCache<ValueType>::evictLowerBoundPoints(LowerBoundType& points, PruningStatistics& statistics) const {
+    size_t evictedPoints = 0;
+    while (entranceBudget > 0 && points.size() > entranceBudget) {
+        // Evicting a point that exceeds another point by at most e in every coordinate lowers the bound for a weight w by at most e * sum(w)
+        size_t evicted = 0;
+        ParetoRational smallestExcess = storm::utility::infinity<ParetoRational>();
+        for (size_t i = 0; i < points.size(); ++i) {
+            for (size_t j = 0; j < points.size(); ++j) {
+                if (i != j) {
+                    ParetoRational excess = getExcess(points[i], points[j]);
+                    if (excess < smallestExcess) {
+                        smallestExcess = excess;
+                        evicted = i;
+                    }
+                }
+            }
+        }
+        points.erase(points.begin() + evicted);
+        ++evictedPoints;
+    }
+
+    statistics.evictedPoints += evictedPoints;
+    return evictedPoints;
+}
+
+template<typename ValueType>
+bool ParetoCache<ValueType>::evictHalfspaces(EntranceBounds& bounds, LowerBoundType const& points, size_t dimension, PruningStatistics& statistics) const {
+    auto& halfspaces = bounds.halfspaces;
+    if (entranceBudget == 0 || halfspaces.size() <= entranceBudget) {
+        return false;
+    }
+
+    // Close to its own direction, a halfspace bounds the value by its gap to the lower bound. Halfspaces with the largest gaps are the least
+    // likely to make a query a cache hit.
+    std::vector<std::pair<ParetoRational, size_t>> gaps;
+    for (size_t i = 0; i < halfspaces.size(); ++i) {
+        ParetoRational best = storm::utility::zero<ParetoRational>();
+        for (auto const& point : points) {
+            best = storm::utility::max<ParetoRational>(best, storm::utility::vector::dotProduct(halfspaces[i].first, point));
+        }
+        gaps.emplace_back(halfspaces[i].second - best, i);
+    }
+    std::sort(gaps.begin(), gaps.end());
+    std::vector<bool> kept(halfspaces.size(), false);
+    for (size_t i = 0; i < entranceBudget; ++i) {
+        kept[gaps[i].second] = true;
+    }
+
+    std::vector<std::pair<ParetoPointType, ParetoRational>> keptHalfspaces;
+    for (size_t i = 0; i < halfspaces.size(); ++i) {
+        if (kept[i]) {
+            keptHalfspaces.push_back(std::move(halfspaces[i]));
+        }
+    }
+    statistics.evictedHalfspaces += halfspaces.size() - keptHalfspaces.size();
+    halfspaces = std::move(keptHalfspaces);
+
+    // Halfspaces cannot be removed from the polytopes, they are rebuilt from the remaining ones
+    if (useVertexUpperBounds) {
+        auto ub = IncrementalVertexPolytope<ParetoRational>::createSubdistributionPolytope(dimension);
+        for (auto const& halfspace : halfspaces) {
+            ub = ub->intersection(halfspace.first, halfspace.second);
+        }
+        bounds.vertexUpperBound = std::move(ub);
+    } else {
+        auto ub = geometry::Polytope<ParetoRational>::getSubdistributionPolytope(dimension);
+        for (auto const& halfspace : halfspaces) {
+            ub = ub->intersection(storage::geometry::Halfspace<ParetoRational>(halfspace.first, halfspace.second));
+        }
+        bounds.upperBound = std::move(ub);
+    }
+    return true;
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::LeafEntry& ParetoCache<ValueType>::getOrCreateEntry(models::ConcreteMdp<ValueType>* ptr) {
+    {
+        std::shared_lock<std::shared_mutex> lock(entriesMutex);
+        auto it = entries.find(ptr);
+        if (it != entries.end()) {
+            return *it->second;
+        }
     }
 
-    return false;
+    std::unique_lock<std::shared_mutex> lock(entriesMutex);
+    auto& entry = entries[ptr];
+    if (!entry) {
+        entry = std::make_unique<LeafEntry>();
+    }
+    return *entry;
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::LeafEntry const* ParetoCache<ValueType>::findEntry(models::ConcreteMdp<ValueType>* ptr) const {
+    std::shared_lock<std::shared_mutex> lock(entriesMutex);
+    auto it = entries.find(ptr);
+    return it == entries.end() ? nullptr : it->second.get();
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::LeafEntry const& ParetoCache<ValueType>::getEntry(models::ConcreteMdp<ValueType>* ptr) const {
+    LeafEntry const* entry = findEntry(ptr);
+    STORM_LOG_THROW(entry, storm::exceptions::InvalidArgumentException, "Pareto curve of leaf " << ptr->getName() << " is not initialized");
+    return *entry;
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::LowerBoundSnapshot ParetoCache<ValueType>::getLowerBoundSnapshot(models::ConcreteMdp<ValueType>* ptr, Position pos) const {
+    LeafEntry const& entry = getEntry(ptr);
+    std::shared_lock<std::shared_mutex> lock(entry.mutex);
+    return entry.lowerBounds.at(pos);
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::VertexUpperBoundSnapshot ParetoCache<ValueType>::getVertexUpperBoundSnapshot(models::ConcreteMdp<ValueType>* ptr,
+                                                                                                            Position pos) const {
+    LeafEntry const& entry = getEntry(ptr);
+    std::shared_lock<std::shared_mutex> lock(entry.mutex);
+    return entry.vertexUpperBounds.at(pos);
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::ParetoPointType ParetoCache<ValueType>::optimizeUpperBound(models::ConcreteMdp<ValueType>* ptr, ParetoPointType const& outputWeight,
+                                                                                            Position pos) const {
+    if (useVertexUpperBounds) {
+        return getVertexUpperBoundSnapshot(ptr, pos)->optimize(outputWeight).first;
+    }
+
+    auto result = getUpperBoundSnapshot(ptr, pos)->optimize(outputWeight);
+    STORM_LOG_ASSERT(result.second, "optimizing in the upper bound should always be defined as it is (supposedly) bounded and non-empty");
+    return result.first;
+}
+
+template<typename ValueType>
+std::vector<typename ParetoCache<ValueType>::ParetoPointType> ParetoCache<ValueType>::getUpperBoundVertices(models::ConcreteMdp<ValueType>* ptr,
+                                                                                                           Position pos) const {
+    if (useVertexUpperBounds) {
+        return getVertexUpperBoundSnapshot(ptr, pos)->getVertices();
+    }
+    return getUpperBoundSnapshot(ptr, pos)->getVertices();
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::FloatBoundsSnapshot ParetoCache<ValueType>::getFloatBoundsSnapshot(models::ConcreteMdp<ValueType>* ptr, Position pos) const {
+    LeafEntry const& entry = getEntry(ptr);
+    std::shared_lock<std::shared_mutex> lock(entry.mutex);
+    return entry.floatBounds.at(pos);
+}
+
+template<typename ValueType>
+void ParetoCache<ValueType>::recordArithmeticTime(storm::utility::Stopwatch const& timer, bool exact, bool upperBound) {
+    std::lock_guard<std::mutex> lock(arithmeticStatisticsMutex);
+    if (exact) {
+        arithmeticStatistics.exactTime.add(timer);
+        if (upperBound) {
+            ++arithmeticStatistics.exactUpperBounds;
+        }
+    } else {
+        arithmeticStatistics.floatTime.add(timer);
+        if (upperBound) {
+            ++arithmeticStatistics.floatUpperBounds;
+        }
+    }
+}
+
+template<typename ValueType>
+boost::optional<std::pair<typename ParetoCache<ValueType>::WeightType, typename ParetoCache<ValueType>::WeightType>> ParetoCache<ValueType>::getLipschitzBounds(
+    models::ConcreteMdp<ValueType>* ptr, WeightType const& outputWeight) const {
+    if (!useLipschitzBounds) {
+        return boost::none;
+    }
+
+    LeafEntry const& entry = getEntry(ptr);
+    std::shared_lock<std::shared_mutex> lock(entry.mutex);
+    auto nearest = entry.weightIndex.nearest(outputWeight);
+    if (!nearest) {
+        return boost::none;
+    }
+
+    // The point stored for the nearest weight w' is achievable, so weight*p is a lower bound. As p is optimal for w' up to the solver precision
+    // (see getUpperBoundPadding), the value for the current weight is at most w'*p plus that precision plus the amount by which the weight
+    // exceeds w' (see WeightKdTree::getOneSidedDistances).
+    auto const& insertion = entry.insertions[nearest->first];
+    ValueType increase = WeightKdTree<ValueType>::getOneSidedDistances(outputWeight, insertion.first).first +
+                         storm::utility::convertNumber<ValueType>(getUpperBoundPadding(insertion.first));
+    ValueType maxWeight = outputWeight.empty() ? storm::utility::zero<ValueType>() : storm::utility::maximum(outputWeight);
+
+    WeightType lower(insertion.second.size()), upper(insertion.second.size());
+    for (size_t i = 0; i < insertion.second.size(); ++i) {
+        lower[i] = storm::utility::vector::dotProduct(outputWeight, insertion.second[i]);
+        upper[i] = storm::utility::min<ValueType>(storm::utility::vector::dotProduct(insertion.first, insertion.second[i]) + increase, maxWeight);
+        if (upper[i] - lower[i] >= this->errorTolerance) {
+            return boost::none;
+        }
+    }
+
+    return std::make_pair(lower, upper);
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::ParetoRational ParetoCache<ValueType>::getUpperBoundPadding(WeightType const& outputWeight) const {
+    ParetoRational weightSum = storm::utility::zero<ParetoRational>();
+    for (auto const& w : outputWeight) {
+        weightSum += storm::utility::convertNumber<ParetoRational>(w);
+    }
+    return solverPrecision + exitProbabilityPrecision * weightSum;
+}
+
+template<typename ValueType>
+void ParetoCache<ValueType>::addToWeightIndex(models::ConcreteMdp<ValueType>* ptr, WeightType const& outputWeight, std::vector<ParetoPointType> const& points) {
+    std::vector<WeightType> convertedPoints;
+    for (auto const& point : points) {
+        convertedPoints.push_back(storm::utility::vector::convertNumericVector<ValueType>(point));
+    }
+
+    LeafEntry& entry = getOrCreateEntry(ptr);
+    std::unique_lock<std::shared_mutex> lock(entry.mutex);
+    entry.weightIndex.insert(outputWeight, entry.insertions.size());
+    entry.insertions.emplace_back(outputWeight, std::move(convertedPoints));
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::ArithmeticStatistics ParetoCache<ValueType>::getArithmeticStatistics() const {
+    std::lock_guard<std::mutex> lock(arithmeticStatisticsMutex);
+    return arithmeticStatistics;
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::PruningStatistics ParetoCache<ValueType>::getPruningStatistics() const {
+    std::lock_guard<std::mutex> lock(arithmeticStatisticsMutex);
+    return pruningStatistics;
+}
+
+template<typename ValueType>
+typename ParetoCache<ValueType>::UpperBoundType ParetoCache<ValueType>::getUpperBoundSnapshot(models::ConcreteMdp<ValueType>* ptr, Position pos) const {
+    LeafEntry const& entry = getEntry(ptr);
+    std::shared_lock<std::shared_mutex> lock(entry.mutex);
+    return entry.upperBounds.at(pos);
+}
+
+template<typename ValueType>
+bool ParetoCache<ValueType>::isInitialized(models::ConcreteMdp<ValueType>* ptr) const {
+    LeafEntry const* entry = findEntry(ptr);
+    if (!entry) {
+        return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(entry->mutex);
+    Position leftPos{L_ENTRANCE, 0};
+    Position rightPos{R_ENTRANCE, 0};
+    return entry->lowerBounds.count(leftPos) > 0 || entry->lowerBounds.count(rightPos) > 0;
 }
 
 template<typename ValueType>
@@ -190,16 +784,28 @@ void ParetoCache<ValueType>::initializeParetoCurve(models::ConcreteMdp<ValueType
     // This means that the lower bound is the polytope that only contains the
     // origin, while the upper bound contains the whole probabilistic simplex.
     size_t dimension = ptr->getExitCount();
+    LeafEntry& entry = getOrCreateEntry(ptr);
+    std::unique_lock<std::shared_mutex> lock(entry.mutex);
+    entry.weightIndex = WeightKdTree<ValueType>(dimension);
+    entry.insertions.clear();
+    entry.version = ++versionCounter;
+
     auto initializeEntrances = [&](const auto& entrances, storm::storage::EntranceExit entranceExit) {
         for (size_t i = 0; i < entrances.size(); ++i) {
             Position pos{entranceExit, i};
-            std::pair<models::ConcreteMdp<ValueType>*, Position> key{ptr, pos};
 
             ParetoPointType zero(dimension, storm::utility::zero<storm::RationalNumber>());
-            auto subDistributionPolytope = geometry::Polytope<ParetoRational>::getSubdistributionPolytope(dimension);
 
-            lowerBounds[key] = {zero};
-            upperBounds[key] = subDistributionPolytope;
+            entry.lowerBounds[pos] = std::make_shared<LowerBoundType const>(LowerBoundType{zero});
+            entry.halfspaces[pos].clear();
+            if (useVertexUpperBounds) {
+                entry.vertexUpperBounds[pos] = IncrementalVertexPolytope<ParetoRational>::createSubdistributionPolytope(dimension);
+            } else {
+                entry.upperBounds[pos] = geometry::Polytope<ParetoRational>::getSubdistributionPolytope(dimension);
+            }
+            if (useFloatingPointFastPath) {
+                entry.floatBounds[pos] = std::make_shared<FloatParetoBounds const>(dimension);
+            }
         }
     };
 
@@ -215,43 +821,127 @@ void ParetoCache<ValueType>::initializeParetoCurves(std::vector<models::Concrete
 }
 
 template<typename ValueType>
-bool ParetoCache<ValueType>::needScheduler() {
-    return true;
+void ParetoCache<ValueType>::addPrecomputedParetoSet(models::ConcreteMdp<ValueType>* ptr, PrecomputedParetoSet<ValueType> const& paretoSet) {
+    STORM_LOG_THROW(paretoSet.getEntranceCount() == ptr->getEntranceCount(), storm::exceptions::InvalidArgumentException, "Entrance count mismatch");
+    if (!isInitialized(ptr)) {
+        initializeParetoCurve(ptr);
+    }
+
+    LeafEntry& entry = getOrCreateEntry(ptr);
+    std::unique_lock<std::shared_mutex> lock(entry.mutex);
+    size_t leftEntranceCount = ptr->getLEntrance().size();
+    for (size_t entranceIndex = 0; entranceIndex < paretoSet.getEntranceCount(); ++entranceIndex) {
+        bool leftEntrance = entranceIndex < leftEntranceCount;
+        Position pos{leftEntrance ? L_ENTRANCE : R_ENTRANCE, leftEntrance ? entranceIndex : entranceIndex - leftEntranceCount};
+
+        auto newLb = std::make_shared<LowerBoundType>(*entry.lowerBounds.at(pos));
+        std::shared_ptr<FloatParetoBounds> newFloatBounds;
+        if (useFloatingPointFastPath) {
+            newFloatBounds = std::make_shared<FloatParetoBounds>(*entry.floatBounds.at(pos));
+        }
+
+        for (auto const& point : paretoSet.getPoints(entranceIndex)) {
+            newLb->push_back(storm::utility::vector::convertNumericVector<ParetoRational>(point));
+            if (useFloatingPointFastPath) {
+                newFloatBounds->addLowerBoundPoint(storm::utility::vector::convertNumericVector<double>(point));
+            }
+        }
+
+        for (auto const& halfspace : paretoSet.getHalfspaces(entranceIndex)) {
+            // The over-approximation contains the origin, skipping a halfspace only weakens the upper bound
+            if (halfspace.second < storm::utility::zero<ValueType>()) {
+                continue;
+            }
+            ParetoPointType normal = storm::utility::vector::convertNumericVector<ParetoRational>(halfspace.first);
+            ParetoRational offset = storm::utility::convertNumber<ParetoRational>(halfspace.second);
+            if (useVertexUpperBounds) {
+                auto& ub = entry.vertexUpperBounds.at(pos);
+                ub = ub->intersection(normal, offset);
+            } else {
+                auto& ub = entry.upperBounds.at(pos);
+                ub = ub->intersection(storage::geometry::Halfspace<ParetoRational>(normal, offset));
+            }
+            entry.halfspaces[pos].emplace_back(normal, offset);
+            if (useFloatingPointFastPath) {
+                newFloatBounds->addHalfspace(storm::utility::vector::convertNumericVector<double>(halfspace.first),
+                                             storm::utility::convertNumber<double>(halfspace.second));
+            }
+        }
+
+        entry.lowerBounds.at(pos) = std::move(newLb);
+        if (useFloatingPointFastPath) {
+            entry.floatBounds.at(pos) = std::move(newFloatBounds);
+        }
+    }
+    entry.version = ++versionCounter;
 }
 
 template<typename ValueType>
-std::pair<typename ParetoCache<ValueType>::ParetoPointType, typename ParetoCache<ValueType>::ParetoPointType> ParetoCache<ValueType>::getLowerUpper(
-    models::ConcreteMdp<ValueType>* ptr, ParetoPointType outputWeight, Position pos) {
-    std::pair<models::ConcreteMdp<ValueType>*, Position> key = {ptr, pos};
+PrecomputedParetoSet<ValueType> ParetoCache<ValueType>::exportParetoSet(models::ConcreteMdp<ValueType>* ptr) const {
+    PrecomputedParetoSet<ValueType> result(ptr->getEntranceCount());
+    LeafEntry const& entry = getEntry(ptr);
+    std::shared_lock<std::shared_mutex> lock(entry.mutex);
 
-    auto upperBoundPolytope = upperBounds.at(key);
+    size_t entranceIndex = 0;
+    auto exportEntrances = [&](const auto& entrances, storm::storage::EntranceExit entranceExit) {
+        for (size_t i = 0; i < entrances.size(); ++i) {
+            Position pos{entranceExit, i};
+            for (auto const& point : *entry.lowerBounds.at(pos)) {
+                // The origin is part of every initial lower bound
+                if (storm::utility::vector::hasNonZeroEntry(point)) {
+                    result.addPoint(entranceIndex, storm::utility::vector::convertNumericVector<ValueType>(point));
+                }
+            }
+            auto halfspaces = entry.halfspaces.find(pos);
+            if (halfspaces != entry.halfspaces.end()) {
+                for (auto const& halfspace : halfspaces->second) {
+                    result.addHalfspace(entranceIndex, storm::utility::vector::convertNumericVector<ValueType>(halfspace.first),
+                                        storm::utility::convertNumber<ValueType>(halfspace.second));
+                }
+            }
+            ++entranceIndex;
+        }
+    };
+    exportEntrances(ptr->getLEntrance(), L_ENTRANCE);
+    exportEntrances(ptr->getREntrance(), R_ENTRANCE);
 
-    ParetoPointType lb = getBestLowerBound(ptr, outputWeight, pos);
+    return result;
+}
 
-    static storm::utility::Stopwatch optimizeTimer;
-    optimizeTimer.start();
-    auto ub = upperBoundPolytope->optimize(outputWeight);
-    optimizeTimer.stop();
+template<typename ValueType>
+void ParetoCache<ValueType>::setQueryTrace(std::shared_ptr<compose::benchmark::CacheQueryTrace<ValueType>> trace) {
+    queryTrace = std::move(trace);
+}
 
-    // std::cout << "UB hs: " << upperBoundPolytope->getHalfspaces().size() << std::endl;
-    // std::cout << "Total itme Took: " << optimizeTimer << std::endl;
+template<typename ValueType>
+bool ParetoCache<ValueType>::needScheduler() {
+    return true;
+}
 
-    STORM_LOG_ASSERT(ub.second, "optimizing in the upper bound should always be defined as it is (supposedly) bounded and non-empty");
+template<typename ValueType>
+bool ParetoCache<ValueType>::isThreadSafe() const {
+    return true;
+}
 
-    return std::make_pair(lb, ub.first);
+template<typename ValueType>
+std::pair<typename ParetoCache<ValueType>::ParetoPointType, typename ParetoCache<ValueType>::ParetoPointType> ParetoCache<ValueType>::getLowerUpper(
+    models::ConcreteMdp<ValueType>* ptr, ParetoPointType outputWeight, Position pos) {
+    ParetoPointType lb = getBestLowerBound(ptr, outputWeight, pos);
+    ParetoPointType ub = optimizeUpperBound(ptr, outputWeight, pos);
+
+    return std::make_pair(lb, ub);
 }
 
 template<typename ValueType>
 typename ParetoCache<ValueType>::ParetoPointType ParetoCache<ValueType>::getBestLowerBound(models::ConcreteMdp<ValueType>* ptr, ParetoPointType outputWeight,
                                                                                            Position pos) {
-    std::pair<models::ConcreteMdp<ValueType>*, Position> key = {ptr, pos};
-    auto lowerBoundPoints = lowerBounds.at(key);
-    STORM_LOG_ASSERT(lowerBoundPoints.size() > 0, "Empty lower bound");
+    LowerBoundSnapshot lowerBoundPoints = getLowerBoundSnapshot(ptr, pos);
+    STORM_LOG_ASSERT(lowerBoundPoints->size() > 0, "Empty lower bound");
 
     ParetoRational lbValue = storm::utility::zero<ValueType>();
     ParetoPointType lb;
     // Compute lb = argmax_p [p*w]
-    for (const auto& p : lowerBoundPoints) {
+    for (const auto& p : *lowerBoundPoints) {
         ParetoRational weightedSum = storm::utility::vector::dotProduct(p, outputWeight);
         if (weightedSum >= lbValue) {
             lb = p;
@@ -265,11 +955,7 @@ typename ParetoCache<ValueType>::ParetoPointType ParetoCache<ValueType>::getBest
 template<typename ValueType>
 typename ParetoCache<ValueType>::ParetoPointType ParetoCache<ValueType>::getBestUpperBound(models::ConcreteMdp<ValueType>* ptr, ParetoPointType outputWeight,
                                                                                            Position pos) {
-    std::pair<models::ConcreteMdp<ValueType>*, Position> key = {ptr, pos};
-    auto upperBoundPolytope = upperBounds.at(key);
-    auto result = upperBoundPolytope->optimize(outputWeight);
-
-    return result.first;
+    return optimizeUpperBound(ptr, outputWeight, pos);
 }
 
 template<typename ValueType>
@@ -304,18 +990,44 @@ std::shared_ptr<storm::models::ConcreteMdp<ValueType>> ParetoCache<ValueType>::t
 template<typename ValueType>
 size_t ParetoCache<ValueType>::getLowerParetoPointCount() {
     size_t total = 0;
-    for (const auto& entry : lowerBounds) {
-        total += entry.second.size();
+    std::shared_lock<std::shared_mutex> entriesLock(entriesMutex);
+    for (const auto& entry : entries) {
+        std::shared_lock<std::shared_mutex> lock(entry.second->mutex);
+        for (const auto& lowerBound : entry.second->lowerBounds) {
+            total += lowerBound.second->size();
+        }
     }
 
     return total;
 }
 
+template<typename ValueType>
+size_t ParetoCache<ValueType>::getLowerParetoPointCount(models::ConcreteMdp<ValueType>* ptr) const {
+    LeafEntry const* entry = findEntry(ptr);
+    if (!entry) {
+        return 0;
+    }
+
+    size_t total = 0;
+    std::shared_lock<std::shared_mutex> lock(entry->mutex);
+    for (const auto& lowerBound : entry->lowerBounds) {
+        total += lowerBound.second->size();
+    }
+    return total;
+}
+
 template<typename ValueType>
 size_t ParetoCache<ValueType>::getUpperParetoPointCount() {
     size_t total = 0;
-    for (const auto& entry : upperBounds) {
-        total += entry.second->getVertices().size();
+    std::shared_lock<std::shared_mutex> entriesLock(entriesMutex);
+    for (const auto& entry : entries) {
+        std::shared_lock<std::shared_mutex> lock(entry.second->mutex);
+        for (const auto& upperBound : entry.second->upperBounds) {
+            total += upperBound.second->getVertices().size();
+        }
+        for (const auto& upperBound : entry.second->vertexUpperBounds) {
+            total += upperBound.second->getVertices().size();
+        }
     }
 
     return total;
@@ -335,9 +1047,9 @@ storm::models::visitor::BidirectionalReachabilityResult<ValueType> ParetoCache<V
 
         for (size_t entrance = 0; entrance < entrances.size(); ++entrance) {
             Position pos{entranceExit, entrance};
-            const auto lb = lowerBounds.at({model, pos});
+            const auto lb = getLowerBoundSnapshot(model, pos);
 
-            for (const auto& point : lb) {
+            for (const auto& point : *lb) {
                 auto convertedPoint = storm::utility::vector::convertNumericVector<ValueType>(point);
                 reachabilityResult.addPoint(entrance, leftEntrance, convertedPoint);
             }
@@ -364,8 +1076,7 @@ storm::models::visitor::BidirectionalReachabilityResult<ValueType> ParetoCache<V
 
         for (size_t entrance = 0; entrance < entrances.size(); ++entrance) {
             Position pos{entranceExit, entrance};
-            auto ub = upperBounds.at({model, pos});
-            auto ubVertices = ub->getVertices();
+            auto ubVertices = getUpperBoundVertices(model, pos);
 
             for (const auto& point : ubVertices) {
                 auto convertedPoint = storm::utility::vector::convertNumericVector<ValueType>(point);
@@ -382,27 +1093,51 @@ storm::models::visitor::BidirectionalReachabilityResult<ValueType> ParetoCache<V
 
 template<typename ValueType>
 void ParetoCache<ValueType>::clearLowerBounds() {
-    for (auto& entry : lowerBounds) {
-        const auto& key = entry.first;
-        auto& value = entry.second;
-
-        models::ConcreteMdp<ValueType> const* ptr = key.first;
+    std::shared_lock<std::shared_mutex> entriesLock(entriesMutex);
+    for (auto& entry : entries) {
+        models::ConcreteMdp<ValueType> const* ptr = entry.first;
         size_t dimension = ptr->getExitCount();
         ParetoPointType zero(dimension, storm::utility::zero<storm::RationalNumber>());
+        auto cleared = std::make_shared<LowerBoundType const>(LowerBoundType{zero});
 
-        value = {zero};
+        std::unique_lock<std::shared_mutex> lock(entry.second->mutex);
+        for (auto& value : entry.second->lowerBounds) {
+            value.second = cleared;
+        }
+        entry.second->weightIndex = WeightKdTree<ValueType>(dimension);
+        entry.second->insertions.clear();
+        entry.second->version = ++versionCounter;
+        for (auto& value : entry.second->floatBounds) {
+            auto newFloatBounds = std::make_shared<FloatParetoBounds>(*value.second);
+            newFloatBounds->clearLowerBound();
+            value.second = std::move(newFloatBounds);
+        }
     }
 }
 
 template<typename ValueType>
 void ParetoCache<ValueType>::clearUpperBounds() {
-    for (auto& entry : upperBounds) {
-        const auto& key = entry.first;
-        auto& value = entry.second;
-
-        models::ConcreteMdp<ValueType> const* ptr = key.first;
+    std::shared_lock<std::shared_mutex> entriesLock(entriesMutex);
+    for (auto& entry : entries) {
+        models::ConcreteMdp<ValueType> const* ptr = entry.first;
         size_t dimension = ptr->getExitCount();
-        value = geometry::Polytope<ParetoRational>::getSubdistributionPolytope(dimension);
+
+        std::unique_lock<std::shared_mutex> lock(entry.second->mutex);
+        entry.second->weightIndex = WeightKdTree<ValueType>(dimension);
+        entry.second->insertions.clear();
+        entry.second->version = ++versionCounter;
+        for (auto& value : entry.second->upperBounds) {
+            value.second = geometry::Polytope<ParetoRational>::getSubdistributionPolytope(dimension);
+        }
+        for (auto& value : entry.second->vertexUpperBounds) {
+            value.second = IncrementalVertexPolytope<ParetoRational>::createSubdistributionPolytope(dimension);
+        }
+        entry.second->halfspaces.clear();
+        for (auto& value : entry.second->floatBounds) {
+            auto newFloatBounds = std::make_shared<FloatParetoBounds>(*value.second);
+            newFloatBounds->clearUpperBound();
+            value.second = std::move(newFloatBounds);
+        }
     }
 }
 
@@ -422,6 +1157,16 @@ bool ParetoCache<ValueType>::containsLeaf(models::ConcreteMdp<ValueType>* ptr) c
     return isInitialized(ptr);
 }
 
+template<typename ValueType>
+uint64_t ParetoCache<ValueType>::getVersion(models::ConcreteMdp<ValueType>* ptr) const {
+    LeafEntry const* entry = findEntry(ptr);
+    if (!entry) {
+        return 0;
+    }
+    std::shared_lock<std::shared_mutex> lock(entry->mutex);
+    return entry->version;
+}
+
 template class ParetoCache<storm::RationalNumber>;
 template class ParetoCache<double>;
 
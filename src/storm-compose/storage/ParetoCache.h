@@ -1,15 +1,38 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 #include "AbstractCache.h"
 #include "EntranceExit.h"
+#include "FloatParetoBounds.h"
+#include "IncrementalVertexPolytope.h"
+#include "PrecomputedParetoSet.h"
+#include "WeightKdTree.h"
+#include "storm-compose/benchmark/CacheQueryTrace.h"
 #include "storm-compose/models/ConcreteMdp.h"
 #include "storm-compose/models/OpenMdpManager.h"
 #include "storm-compose/models/visitor/BidirectionalReachabilityResult.h"
+#include "storm/storage/geometry/Halfspace.h"
 #include "storm/storage/geometry/Polytope.h"
+#include "storm/utility/Stopwatch.h"
 
 namespace storm {
 namespace storage {
 
+// Pareto cache that can be queried and extended concurrently.
+//
+// The bounds are sharded per leaf, each leaf has its own reader-writer lock. The stored lower bound point sets and upper bound polytopes are
+// never modified in place: an insertion publishes a new version, readers only copy the current pointer under the lock and perform the
+// (expensive) dot products and LP optimizations on this snapshot without holding any lock. Insertions build the new version from such a
+// snapshot as well and only publish it under the exclusive lock if the leaf did not change in the meantime, otherwise they start over
+// (building under the exclusive lock once the optimistic attempts failed).
+//
+// For ValueType double, the bounds are additionally kept in floating point (see FloatParetoBounds). Queries are answered from these,
+// the exact polytope is only optimized if the floating point gap is too close to the error tolerance to decide a cache hit reliably.
 template<typename ValueType>
 class ParetoCache : public AbstractCache<ValueType> {
    public:
@@ -20,11 +43,46 @@ class ParetoCache : public AbstractCache<ValueType> {
     typedef std::shared_ptr<storm::storage::geometry::Polytope<storm::RationalNumber>> UpperBoundType;
     typedef std::pair<models::ConcreteMdp<ValueType>*, Position> KeyType;
 
+    struct ArithmeticStatistics {
+        storm::utility::Stopwatch floatTime, exactTime;
+        size_t floatUpperBounds = 0, exactUpperBounds = 0, lipschitzUpperBounds = 0;
+    };
+
+    // Lower bound points and upper bound halfspaces that were removed without changing a bound, or evicted to stay within the budget
+    struct PruningStatistics {
+        size_t prunedPoints = 0, redundantHalfspaces = 0;
+        size_t evictedPoints = 0, evictedHalfspaces = 0;
+    };
+
+    struct Options {
+        // Answer queries from floating point bounds (see FloatParetoBounds), only available for ValueType double
+        bool floatingPointFastPath = true;
+        // Keep the upper bound polytopes in vertex representation (see IncrementalVertexPolytope), so optimizing over them is a scan
+        // over the vertices instead of an LP
+        bool vertexUpperBounds = false;
+        // Answer queries with bounds derived from the closest previously inserted weight if they are tight enough (see WeightKdTree). The
+        // upper bound is padded by solverPrecision like the halfspaces, as the inserted scheduler is only close to optimal for its weight.
+        bool lipschitzBounds = false;
+        // Remove lower bound points that are dominated by the convex hull of the other points, and upper bound halfspaces that do not cut
+        // the polytope
+        bool pruneBounds = true;
+        // Maximum number of lower bound points and of upper bound halfspaces per entrance (0 = unlimited). Points that are closest to being
+        // dominated by another point and halfspaces with the largest gap to the lower bound are evicted first.
+        size_t entranceBudget = 0;
+        // Absolute error of the weighted reachability values of the schedulers that are inserted (e.g. the precision of OVI), the upper bound
+        // halfspaces are moved outwards by it
+        double solverPrecision = 0;
+    };
+
+    ParetoCache();
+    explicit ParetoCache(Options const& options);
+
     boost::optional<WeightType> getLowerBound(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight) override;
     boost::optional<WeightType> getUpperBound(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight) override;
     void addToCache(models::ConcreteMdp<ValueType>* ptr, WeightType outputWeight, WeightType inputWeight,
                     boost::optional<storm::storage::Scheduler<ValueType>> sched = boost::none) override;
     bool needScheduler() override;
+    bool isThreadSafe() const override;
 
     std::shared_ptr<storm::models::ConcreteMdp<ValueType>> toLowerBoundShortcutMdp(std::shared_ptr<storm::models::OpenMdpManager<ValueType>> manager,
                                                                                    storm::models::ConcreteMdp<ValueType>* model);
@@ -32,18 +90,85 @@ class ParetoCache : public AbstractCache<ValueType> {
                                                                                    storm::models::ConcreteMdp<ValueType>* model);
     size_t getLowerParetoPointCount();
     size_t getUpperParetoPointCount();
+    // Lower bound points of all entrances of the leaf (0 if the leaf is not in the cache)
+    size_t getLowerParetoPointCount(models::ConcreteMdp<ValueType>* ptr) const;
     void clearLowerBounds();
     void clearUpperBounds();
     void clear();
     bool isValid() const;
     bool containsLeaf(models::ConcreteMdp<ValueType>* ptr) const;
+    // Changes whenever the bounds of the leaf change (0 if the leaf is not in the cache), versions are never reused
+    uint64_t getVersion(models::ConcreteMdp<ValueType>* ptr) const;
 
     storm::models::visitor::BidirectionalReachabilityResult<ValueType> getLowerBoundReachabilityResult(storm::models::ConcreteMdp<ValueType>* model);
     storm::models::visitor::BidirectionalReachabilityResult<ValueType> getUpperBoundReachabilityResult(storm::models::ConcreteMdp<ValueType>* model);
 
     void initializeParetoCurves(std::vector<models::ConcreteMdp<ValueType>*>& leaves);
 
+    // Adds the points of a precomputed Pareto set to the lower bounds and its halfspaces to the upper bounds of the leaf
+    void addPrecomputedParetoSet(models::ConcreteMdp<ValueType>* ptr, PrecomputedParetoSet<ValueType> const& paretoSet);
+    // Lower bound points and upper bound halfspaces of the leaf, e.g. to store them on disk
+    PrecomputedParetoSet<ValueType> exportParetoSet(models::ConcreteMdp<ValueType>* ptr) const;
+
+    // Records every subsequent query and insertion into the given trace (can be used to replay the workload, e.g. in a contention benchmark)
+    void setQueryTrace(std::shared_ptr<compose::benchmark::CacheQueryTrace<ValueType>> trace);
+
+    // Time spent in floating point and exact arithmetic when answering queries
+    ArithmeticStatistics getArithmeticStatistics() const;
+    PruningStatistics getPruningStatistics() const;
+
    private:
+    typedef std::shared_ptr<LowerBoundType const> LowerBoundSnapshot;
+    typedef std::shared_ptr<FloatParetoBounds const> FloatBoundsSnapshot;
+    typedef std::shared_ptr<IncrementalVertexPolytope<ParetoRational> const> VertexUpperBoundSnapshot;
+
+    // Relative distance of the floating point gap to the error tolerance below which the exact polytope is used
+    constexpr static double FLOAT_FALLBACK_MARGIN = 1e-9;
+    // Computing the convex hull of the lower bound points is exponential in the dimension, above it only dominated points are removed
+    constexpr static size_t HULL_PRUNING_MAX_DIMENSION = 6;
+
+    struct LeafEntry {
+        mutable std::shared_mutex mutex;
+        std::map<Position, LowerBoundSnapshot> lowerBounds;
+        std::map<Position, UpperBoundType> upperBounds;
+        std::map<Position, FloatBoundsSnapshot> floatBounds;
+        std::map<Position, VertexUpperBoundSnapshot> vertexUpperBounds;  // replaces upperBounds if vertex upper bounds are used
+        // Halfspaces that were intersected with the upper bounds, kept to export the bounds
+        std::map<Position, std::vector<std::pair<ParetoPointType, ParetoRational>>> halfspaces;
+        // Number of lower bound points after the last convex hull pruning
+        std::map<Position, size_t> hullPrunedSizes;
+
+        // Inserted weights and, for each insertion, the points of all entrances (left entrances first)
+        WeightKdTree<ValueType> weightIndex;
+        std::vector<std::pair<WeightType, std::vector<WeightType>>> insertions;
+        uint64_t version = 0;
+    };
+
+    // The bounds of one entrance, see updateLowerUpperBounds
+    struct EntranceBounds {
+        LowerBoundSnapshot lowerBound;
+        UpperBoundType upperBound;
+        VertexUpperBoundSnapshot vertexUpperBound;
+        FloatBoundsSnapshot floatBounds;
+        std::vector<std::pair<ParetoPointType, ParetoRational>> halfspaces;
+        size_t hullPrunedSize = 0;
+    };
+
+    LeafEntry& getOrCreateEntry(models::ConcreteMdp<ValueType>* ptr);
+    LeafEntry const* findEntry(models::ConcreteMdp<ValueType>* ptr) const;
+    LeafEntry const& getEntry(models::ConcreteMdp<ValueType>* ptr) const;
+    LowerBoundSnapshot getLowerBoundSnapshot(models::ConcreteMdp<ValueType>* ptr, Position pos) const;
+    UpperBoundType getUpperBoundSnapshot(models::ConcreteMdp<ValueType>* ptr, Position pos) const;
+    FloatBoundsSnapshot getFloatBoundsSnapshot(models::ConcreteMdp<ValueType>* ptr, Position pos) const;
+    VertexUpperBoundSnapshot getVertexUpperBoundSnapshot(models::ConcreteMdp<ValueType>* ptr, Position pos) const;
+    ParetoPointType optimizeUpperBound(models::ConcreteMdp<ValueType>* ptr, ParetoPointType const& outputWeight, Position pos) const;
+    std::vector<ParetoPointType> getUpperBoundVertices(models::ConcreteMdp<ValueType>* ptr, Position pos) const;
+    void recordArithmeticTime(storm::utility::Stopwatch const& timer, bool exact, bool upperBound = false);
+    boost::optional<std::pair<WeightType, WeightType>> getLipschitzBounds(models::ConcreteMdp<ValueType>* ptr, WeightType const& outputWeight) const;
+    // Amount by which the optimum for the (unnormalized) weight may exceed the value of an inserted scheduler
+    ParetoRational getUpperBoundPadding(WeightType const& outputWeight) const;
+    void addToWeightIndex(models::ConcreteMdp<ValueType>* ptr, WeightType const& outputWeight, std::vector<ParetoPointType> const& points);
+
     void initializeParetoCurve(models::ConcreteMdp<ValueType>* ptr);
     std::pair<ParetoPointType, ParetoPointType> getLowerUpper(models::ConcreteMdp<ValueType>* ptr, ParetoPointType outputWeight, Position pos);
     ParetoPointType getBestLowerBound(models::ConcreteMdp<ValueType>* ptr, ParetoPointType outputWeight, Position pos);
@@ -51,11 +176,36 @@ class ParetoCache : public AbstractCache<ValueType> {
 
     // computes the inf-norm of upper-lower
     ParetoRational getError(ParetoPointType lower, ParetoPointType upper) const;
-    void updateLowerUpperBounds(KeyType key, ParetoPointType point, ParetoPointType weight);
+    // Reachability probabilities of every exit from every entrance under the scheduler, one point per entrance
+    std::vector<ParetoPointType> computeExitProbabilities(models::ConcreteMdp<ValueType>* ptr, storm::storage::Scheduler<ValueType> const& sched) const;
+    void updateLowerUpperBounds(KeyType key, ParetoPointType point, ParetoPointType weight, WeightType const& outputWeight);
+    // The following work on a private copy of the bounds of an entrance and do not lock the entry, statistics are only recorded once the
+    // bounds are published
+    void addPointToBounds(EntranceBounds& bounds, ParetoPointType point, storage::geometry::Halfspace<ParetoRational> const& newHalfspace,
+                          std::vector<double> const& floatWeight, std::vector<double> const& floatPoint, double floatPadding,
+                          PruningStatistics& statistics) const;
+    size_t pruneLowerBound(size_t& prunedSize, LowerBoundType& points, PruningStatistics& statistics) const;
+    size_t evictLowerBoundPoints(LowerBoundType& points, PruningStatistics& statistics) const;
+    bool evictHalfspaces(EntranceBounds& bounds, LowerBoundType const& points, size_t dimension, PruningStatistics& statistics) const;
     bool isInitialized(models::ConcreteMdp<ValueType>* ptr) const;
 
-    std::map<KeyType, LowerBoundType> lowerBounds;
-    std::map<KeyType, UpperBoundType> upperBounds;
+    // Only guards the structure of the map, the entries are protected by their own mutex
+    mutable std::shared_mutex entriesMutex;
+    std::unordered_map<models::ConcreteMdp<ValueType>*, std::unique_ptr<LeafEntry>> entries;
+    std::atomic<uint64_t> versionCounter{0};
+
+    std::shared_ptr<compose::benchmark::CacheQueryTrace<ValueType>> queryTrace;
+
+    bool useFloatingPointFastPath;
+    bool useVertexUpperBounds;
+    bool useLipschitzBounds;
+    bool pruneBounds;
+    size_t entranceBudget;
+    // Added to the offset of an upper bound halfspace with weight w: solverPrecision + exitProbabilityPrecision * sum(w)
+    ParetoRational solverPrecision, exitProbabilityPrecision;
+    mutable std::mutex arithmeticStatisticsMutex;
+    ArithmeticStatistics arithmeticStatistics;
+    PruningStatistics pruningStatistics;
 };
 
 }  // namespace storage
@@ -0,0 +1,136 @@
+#include "PrecomputedParetoSet.h"
+
+#include "storm-compose/models/ConcreteMdp.h"
+#include "storm-compose/models/visitor/ParetoVisitor.h"
+#include "storm-parsers/parser/FormulaParser.h"
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/exceptions/InvalidOperationException.h"
+#include "storm/logic/Formula.h"
+#include "storm/modelchecker/multiobjective/multiObjectiveModelChecking.h"
+#include "storm/modelchecker/results/ExplicitParetoCurveCheckResult.h"
+#include "storm/modelchecker/results/ExplicitQuantitativeCheckResult.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/macros.h"
+#include "storm/utility/vector.h"
+
+namespace storm {
+namespace storage {
+
+template<typename ValueType>
+std::shared_ptr<PrecomputedParetoSet<ValueType> const> PrecomputedParetoSet<ValueType>::compute(models::ConcreteMdp<ValueType>& leaf,
+                                                                                              storm::Environment const& env) {
+    storm::parser::FormulaParser formulaParser;
+    auto formula = formulaParser.parseSingleFormulaFromString(models::visitor::ParetoVisitor<ValueType>::getFormula(leaf));
+
+    auto result = std::make_shared<PrecomputedParetoSet<ValueType>>(leaf.getEntranceCount());
+    size_t dimension = leaf.getExitCount();
+
+    auto& stateLabeling = leaf.getMdp()->getStateLabeling();
+    if (!stateLabeling.containsLabel("init")) {
+        stateLabeling.addLabel("init");
+    } else {
+        stateLabeling.setStates("init", storm::storage::BitVector(leaf.getMdp()->getNumberOfStates()));
+    }
+
+    size_t entranceIndex = 0;
+    auto checkEntrances = [&](const auto& entrances) {
+        for (auto const& entrance : entrances) {
+            stateLabeling.addLabelToState("init", entrance);
+            std::unique_ptr<storm::modelchecker::CheckResult> checkResult =
+                storm::modelchecker::multiobjective::performMultiObjectiveModelChecking(env, *leaf.getMdp(), formula->asMultiObjectiveFormula());
+            stateLabeling.removeLabelFromState("init", entrance);
+
+            if (checkResult->isExplicitParetoCurveCheckResult()) {
+                auto const& paretoResult = checkResult->template asExplicitParetoCurveCheckResult<ValueType>();
+                STORM_LOG_THROW(paretoResult.hasOverApproximation(), storm::exceptions::InvalidOperationException, "expected over approximation");
+
+                for (auto const& point : paretoResult.getPoints()) {
+                    result->addPoint(entranceIndex, point);
+                }
+                for (auto const& halfspace : paretoResult.getOverApproximation()->getHalfspaces()) {
+                    result->addHalfspace(entranceIndex, halfspace.normalVector(), halfspace.offset());
+                }
+            } else {
+                STORM_LOG_THROW(checkResult->isExplicitQuantitativeCheckResult(), storm::exceptions::InvalidOperationException,
+                                "result was not pareto nor quantitative");
+                STORM_LOG_THROW(dimension == 1, storm::exceptions::InvalidOperationException, "Expected only 1 exit");
+                ValueType value = checkResult->template asExplicitQuantitativeCheckResult<ValueType>()[entrance];
+                result->addPoint(entranceIndex, {value});
+                result->addHalfspace(entranceIndex, {storm::utility::one<ValueType>()}, value);
+            }
+
+            ++entranceIndex;
+        }
+    };
+    checkEntrances(leaf.getLEntrance());
+    checkEntrances(leaf.getREntrance());
+
+    return result;
+}
+
+template<typename ValueType>
+PrecomputedParetoSet<ValueType>::PrecomputedParetoSet(size_t entranceCount) : points(entranceCount), halfspaces(entranceCount) {}
+
+template<typename ValueType>
+void PrecomputedParetoSet<ValueType>::addPoint(size_t entrance, Point const& point) {
+    points.at(entrance).push_back(point);
+}
+
+template<typename ValueType>
+void PrecomputedParetoSet<ValueType>::addHalfspace(size_t entrance, Point const& normal, ValueType const& offset) {
+    halfspaces.at(entrance).emplace_back(normal, offset);
+}
+
+template<typename ValueType>
+std::vector<ValueType> PrecomputedParetoSet<ValueType>::maximize(std::vector<ValueType> const& weights) const {
+    // The origin is always achievable
+    std::vector<ValueType> result(points.size(), storm::utility::zero<ValueType>());
+    for (size_t entrance = 0; entrance < points.size(); ++entrance) {
+        for (auto const& point : points[entrance]) {
+            STORM_LOG_THROW(point.size() == weights.size(), storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+            result[entrance] = storm::utility::max<ValueType>(result[entrance], storm::utility::vector::dotProduct(weights, point));
+        }
+    }
+    return result;
+}
+
+template<typename ValueType>
+std::shared_ptr<geometry::Polytope<ValueType>> PrecomputedParetoSet<ValueType>::createOverApproximation(size_t entrance, size_t dimension) const {
+    auto constraints = geometry::Polytope<ValueType>::getSubdistributionPolytope(dimension)->getHalfspaces();
+    for (auto const& halfspace : halfspaces.at(entrance)) {
+        STORM_LOG_THROW(halfspace.first.size() == dimension, storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+        constraints.emplace_back(halfspace.first, halfspace.second);
+    }
+    return geometry::Polytope<ValueType>::create(constraints);
+}
+
+template<typename ValueType>
+std::vector<typename PrecomputedParetoSet<ValueType>::Point> const& PrecomputedParetoSet<ValueType>::getPoints(size_t entrance) const {
+    return points.at(entrance);
+}
+
+template<typename ValueType>
+std::vector<typename PrecomputedParetoSet<ValueType>::Halfspace> const& PrecomputedParetoSet<ValueType>::getHalfspaces(size_t entrance) const {
+    return halfspaces.at(entrance);
+}
+
+template<typename ValueType>
+size_t PrecomputedParetoSet<ValueType>::getEntranceCount() const {
+    return points.size();
+}
+
+template<typename ValueType>
+size_t PrecomputedParetoSet<ValueType>::getPointCount() const {
+    size_t count = 0;
+    for (auto const& entrancePoints : points) {
+        count += entrancePoints.size();
+    }
+    return count;
+}
+
+template class PrecomputedParetoSet<double>;
+template class PrecomputedParetoSet<storm::RationalNumber>;
+
+}  // namespace storage
+}  // namespace storm
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "storm/environment/Environment.h"
+#include "storm/storage/geometry/Polytope.h"
+
+namespace storm {
+namespace models {
+template<typename ValueType>
+class ConcreteMdp;
+}
+
+namespace storage {
+
+// Pareto set of the exit reachability probabilities of a leaf, computed once for all entrances (left entrances first) with the
+// multi-objective model checker (PCAA).
+//
+// For each entrance we keep the achievable points, i.e. the vertices of the under-approximation, and the halfspaces {x | normal*x <= offset}
+// of the over-approximation. A maximum over the points answers a weighted reachability query from below, a maximum over the over-approximation
+// answers it from above. PCAA only bounds the distance of the two per objective, so the points must not be used as an upper bound.
+template<typename ValueType>
+class PrecomputedParetoSet {
+   public:
+    typedef std::vector<ValueType> Point;
+    typedef std::pair<Point, ValueType> Halfspace;
+
+    /// Runs PCAA from each entrance of the leaf. The environment determines the precision of the multi-objective computation.
+    static std::shared_ptr<PrecomputedParetoSet<ValueType> const> compute(models::ConcreteMdp<ValueType>& leaf, storm::Environment const& env);
+
+    PrecomputedParetoSet(size_t entranceCount);
+
+    void addPoint(size_t entrance, Point const& point);
+    void addHalfspace(size_t entrance, Point const& normal, ValueType const& offset);
+
+    /// For each entrance max {weights*p | p point of the entrance}, a lower bound on the weighted reachability
+    std::vector<ValueType> maximize(std::vector<ValueType> const& weights) const;
+    /// The halfspaces of the entrance intersected with the subdistributions of the given dimension. Maximizing the weights over this polytope
+    /// gives an upper bound on the weighted reachability.
+    std::shared_ptr<geometry::Polytope<ValueType>> createOverApproximation(size_t entrance, size_t dimension) const;
+
+    std::vector<Point> const& getPoints(size_t entrance) const;
+    std::vector<Halfspace> const& getHalfspaces(size_t entrance) const;
+    size_t getEntranceCount() const;
+    size_t getPointCount() const;
+
+   private:
+    std::vector<std::vector<Point>> points;
+    std::vector<std::vector<Halfspace>> halfspaces;
+};
+
+}  // namespace storage
+}  // namespace storm
@@ -93,41 +93,42 @@ ValueVectorMapping<ValueType>& ValueVector<ValueType>::getMapping() {
 template<typename ValueType>
 std::vector<ValueType> ValueVector<ValueType>::getOutputWeights(size_t leafId) {
     std::vector<ValueType> weights;
-    models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
-
-    for (size_t leftPos = 0; leftPos < model->getLExit().size(); ++leftPos) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::L_EXIT, leftPos};
-        ValueType weight = getWeight(leafId, pos);
-        weights.push_back(weight);
-    }
-
-    for (size_t rightPos = 0; rightPos < model->getRExit().size(); ++rightPos) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::R_EXIT, rightPos};
-        ValueType weight = getWeight(leafId, pos);
-        weights.push_back(weight);
-    }
-
+    getOutputWeights(leafId, weights);
     return weights;
 }
 
 template<typename ValueType>
 std::vector<ValueType> ValueVector<ValueType>::getInputWeights(size_t leafId) {
     std::vector<ValueType> weights;
-    models::ConcreteMdp<ValueType>* model = mapping.getLeaves()[leafId];
+    getInputWeights(leafId, weights);
+    return weights;
+}
 
-    for (size_t leftPos = 0; leftPos < model->getLEntrance().size(); ++leftPos) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::L_ENTRANCE, leftPos};
-        ValueType weight = getWeight(leafId, pos);
-        weights.push_back(weight);
+template<typename ValueType>
+void ValueVector<ValueType>::getOutputWeights(size_t leafId, std::vector<ValueType>& weights) const {
+    auto indices = mapping.getExitIndices(leafId);
+    weights.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        weights[i] = values[indices[i]];
     }
+}
 
-    for (size_t rightPos = 0; rightPos < model->getREntrance().size(); ++rightPos) {
-        std::pair<storage::EntranceExit, size_t> pos{storage::R_ENTRANCE, rightPos};
-        ValueType weight = getWeight(leafId, pos);
-        weights.push_back(weight);
+template<typename ValueType>
+void ValueVector<ValueType>::getInputWeights(size_t leafId, std::vector<ValueType>& weights) const {
+    auto indices = mapping.getEntranceIndices(leafId);
+    weights.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        weights[i] = values[indices[i]];
     }
+}
 
-    return weights;
+template<typename ValueType>
+void ValueVector<ValueType>::setInputWeights(size_t leafId, std::vector<ValueType> const& weights) {
+    auto indices = mapping.getEntranceIndices(leafId);
+    STORM_LOG_ASSERT(weights.size() == indices.size(), "Dimension mismatch");
+    for (size_t i = 0; i < indices.size(); ++i) {
+        values[indices[i]] = weights[i];
+    }
 }
 
 template<typename ValueType>
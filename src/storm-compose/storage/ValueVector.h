@@ -31,6 +31,11 @@ class ValueVector {
     ValueVectorMapping<ValueType>& getMapping();
     std::vector<ValueType> getOutputWeights(size_t leafId);
     std::vector<ValueType> getInputWeights(size_t leafId);
+    // Variants that reuse the given buffer
+    void getOutputWeights(size_t leafId, std::vector<ValueType>& weights) const;
+    void getInputWeights(size_t leafId, std::vector<ValueType>& weights) const;
+    // Sets the values of the entrances of the leaf (L entrances first)
+    void setInputWeights(size_t leafId, std::vector<ValueType> const& weights);
     void print();
 
    private:
@@ -1,5 +1,8 @@
 #include "ValueVectorMapping.h"
 #include "storm-compose/storage/EntranceExit.h"
+#include "storm/storage/SparseMatrix.h"
+#include "storm/storage/StronglyConnectedComponentDecomposition.h"
+#include "storm/utility/constants.h"
 
 namespace storm {
 namespace storage {
@@ -31,13 +34,48 @@ ValueVectorMapping<ValueType>::ValueVectorMapping(std::vector<models::ConcreteMd
         storage::Position pos = key.second;
 
         if (pos.first == L_ENTRANCE || pos.first == R_ENTRANCE) {
-            const auto connectedKey = reverseMap[value];
-            size_t connectedLeaf = connectedKey.first;
+            // Outer entrances are not read by any leaf
+            const auto connectedKey = reverseMap.find(value);
+            if (connectedKey == reverseMap.end()) {
+                continue;
+            }
+            size_t connectedLeaf = connectedKey->second.first;
             connectedMapping[key] = connectedLeaf;
 
             // std::cout << "leafId " << key.first << " " << storage::positionToString(pos) << " -> " << connectedLeaf << std::endl;
         }
     }
+
+    compileIndexTables();
+}
+
+template<typename ValueType>
+void ValueVectorMapping<ValueType>::compileIndexTables() {
+    entranceOffsets.assign(1, 0);
+    exitOffsets.assign(1, 0);
+    entranceIndices.clear();
+    exitIndices.clear();
+    lEntranceCounts.resize(leaves.size());
+    lExitCounts.resize(leaves.size());
+
+    for (size_t leafId = 0; leafId < leaves.size(); ++leafId) {
+        auto const* leaf = leaves[leafId];
+        auto addIndices = [&](std::vector<size_t>& indices, EntranceExit entranceExit, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                indices.push_back(mapping.at({leafId, {entranceExit, i}}));
+            }
+        };
+
+        lEntranceCounts[leafId] = leaf->getLEntrance().size();
+        addIndices(entranceIndices, L_ENTRANCE, leaf->getLEntrance().size());
+        addIndices(entranceIndices, R_ENTRANCE, leaf->getREntrance().size());
+        entranceOffsets.push_back(entranceIndices.size());
+
+        lExitCounts[leafId] = leaf->getLExit().size();
+        addIndices(exitIndices, L_EXIT, leaf->getLExit().size());
+        addIndices(exitIndices, R_EXIT, leaf->getRExit().size());
+        exitOffsets.push_back(exitIndices.size());
+    }
 }
 
 template<typename ValueType>
@@ -90,9 +128,60 @@ void ValueVectorMapping<ValueType>::printValueVector(ValueVector<ValueType>& val
 
 template<typename ValueType>
 size_t ValueVectorMapping<ValueType>::lookup(const Key& key) const {
+    size_t leafId = key.first;
+    Position const& pos = key.second;
+    switch (pos.first) {
+        case L_ENTRANCE:
+            STORM_LOG_ASSERT(pos.second < lEntranceCounts[leafId], "Position out of range");
+            return entranceIndices[entranceOffsets[leafId] + pos.second];
+        case R_ENTRANCE:
+            STORM_LOG_ASSERT(entranceOffsets[leafId] + lEntranceCounts[leafId] + pos.second < entranceOffsets[leafId + 1], "Position out of range");
+            return entranceIndices[entranceOffsets[leafId] + lEntranceCounts[leafId] + pos.second];
+        case L_EXIT:
+            STORM_LOG_ASSERT(pos.second < lExitCounts[leafId], "Position out of range");
+            return exitIndices[exitOffsets[leafId] + pos.second];
+        case R_EXIT:
+            STORM_LOG_ASSERT(exitOffsets[leafId] + lExitCounts[leafId] + pos.second < exitOffsets[leafId + 1], "Position out of range");
+            return exitIndices[exitOffsets[leafId] + lExitCounts[leafId] + pos.second];
+    }
     return mapping.at(key);
 }
 
+template<typename ValueType>
+std::vector<typename ValueVectorMapping<ValueType>::LeafComponent> ValueVectorMapping<ValueType>::computeLeafComponents() const {
+    // Row i holds the leaves whose entrances are exits of leaf i, the decomposition lists the SCCs of these rows first
+    std::vector<std::set<size_t>> dependencies(leaves.size());
+    size_t entryCount = 0;
+    for (const auto& entry : connectedMapping) {
+        entryCount += dependencies[entry.second].insert(entry.first.first).second;
+    }
+    storm::storage::SparseMatrixBuilder<ValueType> builder(leaves.size(), leaves.size(), entryCount);
+    for (size_t leafId = 0; leafId < leaves.size(); ++leafId) {
+        for (size_t dependency : dependencies[leafId]) {
+            builder.addNextValue(leafId, dependency, storm::utility::one<ValueType>());
+        }
+    }
+    storm::storage::StronglyConnectedComponentDecomposition<ValueType> decomposition(
+        builder.build(), storm::storage::StronglyConnectedComponentDecompositionOptions().forceTopologicalSort());
+
+    std::vector<LeafComponent> components;
+    components.reserve(decomposition.size());
+    for (const auto& scc : decomposition) {
+        components.push_back({std::vector<size_t>(scc.begin(), scc.end()), !scc.isTrivial()});
+    }
+    return components;
+}
+
+template<typename ValueType>
+IndexRange ValueVectorMapping<ValueType>::getEntranceIndices(size_t leafId) const {
+    return IndexRange(entranceIndices.data() + entranceOffsets[leafId], entranceIndices.data() + entranceOffsets[leafId + 1]);
+}
+
+template<typename ValueType>
+IndexRange ValueVectorMapping<ValueType>::getExitIndices(size_t leafId) const {
+    return IndexRange(exitIndices.data() + exitOffsets[leafId], exitIndices.data() + exitOffsets[leafId + 1]);
+}
+
 template<typename ValueType>
 size_t ValueVectorMapping<ValueType>::getHighestIndex() const {
     return highestIndex;
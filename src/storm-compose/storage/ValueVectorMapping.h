@@ -12,11 +12,40 @@ namespace storage {
 template<typename ValueType>
 class ValueVector;
 
+// Contiguous range of value vector indices
+class IndexRange {
+   public:
+    IndexRange(size_t const* first, size_t const* last) : first(first), last(last) {}
+
+    size_t const* begin() const {
+        return first;
+    }
+    size_t const* end() const {
+        return last;
+    }
+    size_t size() const {
+        return last - first;
+    }
+    size_t operator[](size_t i) const {
+        return first[i];
+    }
+
+   private:
+    size_t const* first;
+    size_t const* last;
+};
+
 template<typename ValueType>
 class ValueVectorMapping {
     typedef std::pair<size_t, Position> Key;
 
    public:
+    // Leaves that depend on each other through traces, a leaf depends on the leaves whose entrances are its exits
+    struct LeafComponent {
+        std::vector<size_t> leaves;
+        bool cyclic;
+    };
+
     ValueVectorMapping(std::vector<models::ConcreteMdp<ValueType>*> leaves, std::map<Key, size_t> mapping, std::set<Key> outerPositions, size_t highestIndex);
     ValueVectorMapping() = default;
 
@@ -32,7 +61,16 @@ class ValueVectorMapping {
     boost::optional<size_t> getConnectedLeafId(size_t leafId, Position pos);
     models::ConcreteMdp<ValueType> const* getLeaf(size_t leaf) const;
 
+    /// Value vector indices of the entrances (L entrances first) and exits (L exits first) of a leaf
+    IndexRange getEntranceIndices(size_t leafId) const;
+    IndexRange getExitIndices(size_t leafId) const;
+
+    /// Strongly connected components of the leaf dependencies in topological order, a component only depends on itself and the ones before it
+    std::vector<LeafComponent> computeLeafComponents() const;
+
    private:
+    void compileIndexTables();
+
     // All the leaves
     std::vector<models::ConcreteMdp<ValueType>*> leaves;
 
@@ -44,6 +82,11 @@ class ValueVectorMapping {
     std::vector<std::map<Position, size_t>> modelMapping;
     std::set<Key> outerPositions;
     size_t highestIndex;
+
+    // For leaf i, entranceIndices[entranceOffsets[i]..entranceOffsets[i + 1]) are the indices of its entrances, lEntranceCounts[i] of them are
+    // left entrances. The same layout is used for the exits. Used for all lookups instead of the map above.
+    std::vector<size_t> entranceOffsets, entranceIndices, lEntranceCounts;
+    std::vector<size_t> exitOffsets, exitIndices, lExitCounts;
 };
 
 }  // namespace storage
@@ -0,0 +1,113 @@
+#include "WeightKdTree.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "storm/adapters/RationalNumberAdapter.h"
+#include "storm/exceptions/InvalidArgumentException.h"
+#include "storm/utility/constants.h"
+#include "storm/utility/macros.h"
+
+namespace storm {
+namespace storage {
+
+template<typename ValueType>
+WeightKdTree<ValueType>::WeightKdTree(size_t dimension) : dimension(dimension) {}
+
+template<typename ValueType>
+void WeightKdTree<ValueType>::insert(std::vector<ValueType> const& weight, size_t id) {
+    STORM_LOG_THROW(weight.size() == dimension, storm::exceptions::InvalidArgumentException, "Dimension mismatch");
+
+    Node newNode;
+    newNode.weight = weight;
+    newNode.id = id;
+    nodes.push_back(std::move(newNode));
+    size_t newIndex = nodes.size() - 1;
+    if (newIndex == 0 || dimension == 0) {
+        return;
+    }
+
+    size_t current = 0, depth = 0;
+    while (true) {
+        size_t axis = depth % dimension;
+        size_t& child = weight[axis] < nodes[current].weight[axis] ? nodes[current].left : nodes[current].right;
+        if (child == NO_CHILD) {
+            child = newIndex;
+            return;
+        }
+        current = child;
+        ++depth;
+    }
+}
+
+template<typename ValueType>
+boost::optional<std::pair<size_t, ValueType>> WeightKdTree<ValueType>::nearest(std::vector<ValueType> const& weight) const {
+    if (nodes.empty()) {
+        return boost::none;
+    }
+    if (dimension == 0) {
+        return std::make_pair(nodes[0].id, storm::utility::zero<ValueType>());
+    }
+
+    // The root is the first candidate
+    size_t best = 0;
+    ValueType bestDistance = storm::utility::zero<ValueType>();
+    for (size_t i = 0; i < dimension; ++i) {
+        bestDistance = std::max<ValueType>(bestDistance, storm::utility::abs<ValueType>(nodes[0].weight[i] - weight[i]));
+    }
+
+    // Explicit stack (the tree is not balanced), each entry stores a lower bound on the distance to the nodes in that subtree
+    std::vector<std::tuple<size_t, size_t, ValueType>> stack{{0, 0, storm::utility::zero<ValueType>()}};
+    while (!stack.empty()) {
+        auto [current, depth, lowerBound] = stack.back();
+        stack.pop_back();
+        if (current == NO_CHILD || lowerBound >= bestDistance) {
+            continue;
+        }
+
+        Node const& node = nodes[current];
+        ValueType distance = storm::utility::zero<ValueType>();
+        for (size_t i = 0; i < dimension; ++i) {
+            distance = std::max<ValueType>(distance, storm::utility::abs<ValueType>(node.weight[i] - weight[i]));
+        }
+        if (distance < bestDistance) {
+            best = current;
+            bestDistance = distance;
+        }
+
+        size_t axis = depth % dimension;
+        ValueType axisDistance = weight[axis] - node.weight[axis];
+        bool goLeft = axisDistance < storm::utility::zero<ValueType>();
+        // The far side is pushed first, so the near side is searched first
+        stack.emplace_back(goLeft ? node.right : node.left, depth + 1, std::max<ValueType>(lowerBound, storm::utility::abs<ValueType>(axisDistance)));
+        stack.emplace_back(goLeft ? node.left : node.right, depth + 1, lowerBound);
+    }
+
+    return std::make_pair(nodes[best].id, bestDistance);
+}
+
+template<typename ValueType>
+size_t WeightKdTree<ValueType>::size() const {
+    return nodes.size();
+}
+
+template<typename ValueType>
+std::pair<ValueType, ValueType> WeightKdTree<ValueType>::getOneSidedDistances(std::vector<ValueType> const& weight, std::vector<ValueType> const& other) {
+    STORM_LOG_ASSERT(weight.size() == other.size(), "Dimension mismatch");
+
+    ValueType above = storm::utility::zero<ValueType>(), below = storm::utility::zero<ValueType>();
+    for (size_t i = 0; i < weight.size(); ++i) {
+        if (weight[i] > other[i]) {
+            above = std::max<ValueType>(above, weight[i] - other[i]);
+        } else {
+            below = std::max<ValueType>(below, other[i] - weight[i]);
+        }
+    }
+    return {above, below};
+}
+
+template class WeightKdTree<double>;
+template class WeightKdTree<storm::RationalNumber>;
+
+}  // namespace storage
+}  // namespace storm
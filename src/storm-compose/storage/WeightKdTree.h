@@ -0,0 +1,44 @@
+#pragma once
+
+#include <boost/optional.hpp>
+#include <limits>
+#include <vector>
+
+namespace storm {
+namespace storage {
+
+// Kd-tree over weight vectors that supports incremental insertion and nearest neighbour queries w.r.t. the maximum norm.
+// Used to find a previously seen weight close to a new one, so that bounds for the new weight can be derived without solving.
+template<typename ValueType>
+class WeightKdTree {
+   public:
+    WeightKdTree(size_t dimension = 0);
+
+    void insert(std::vector<ValueType> const& weight, size_t id);
+
+    /// Returns the id of a stored weight closest to the given weight and their distance, or none if the tree is empty.
+    boost::optional<std::pair<size_t, ValueType>> nearest(std::vector<ValueType> const& weight) const;
+
+    size_t size() const;
+
+    /// Returns (max(0, max_i weight_i - other_i), max(0, max_i other_i - weight_i)).
+    ///
+    /// Weighted reachability values (of a subdistribution) are monotone and 1-Lipschitz in the weights, so if v is the value for other,
+    /// the value for weight lies in [v - second, v + first].
+    static std::pair<ValueType, ValueType> getOneSidedDistances(std::vector<ValueType> const& weight, std::vector<ValueType> const& other);
+
+   private:
+    constexpr static size_t NO_CHILD = std::numeric_limits<size_t>::max();
+
+    struct Node {
+        std::vector<ValueType> weight;
+        size_t id;
+        size_t left = NO_CHILD, right = NO_CHILD;
+    };
+
+    size_t dimension;
+    std::vector<Node> nodes;
+};
+
+}  // namespace storage
+}  // namespace storm
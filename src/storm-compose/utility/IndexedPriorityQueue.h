@@ -0,0 +1,93 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace storm {
+namespace compose {
+namespace utility {
+
+// Binary heap over the items 0, ..., n - 1 whose priorities can be changed in O(log n). Unlike storm::storage::DynamicPriorityQueue, every
+// item stays in the queue, an item that should not be picked gets the lowest priority instead.
+template<typename PriorityType, typename Compare = std::less<PriorityType>>
+class IndexedPriorityQueue {
+   public:
+    /// All items start with the given priority
+    IndexedPriorityQueue(size_t itemCount, PriorityType const& priority) : heap(itemCount), positions(itemCount), priorities(itemCount, priority) {
+        for (size_t item = 0; item < itemCount; ++item) {
+            heap[item] = item;
+            positions[item] = item;
+        }
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    /// Item with the highest priority
+    size_t top() const {
+        return heap.front();
+    }
+
+    PriorityType const& getPriority(size_t item) const {
+        return priorities[item];
+    }
+
+    void setPriority(size_t item, PriorityType const& priority) {
+        bool increased = compare(priorities[item], priority);
+        priorities[item] = priority;
+        if (increased) {
+            siftUp(positions[item]);
+        } else {
+            siftDown(positions[item]);
+        }
+    }
+
+   private:
+    void siftUp(size_t position) {
+        size_t item = heap[position];
+        while (position > 0) {
+            size_t parent = (position - 1) / 2;
+            if (!compare(priorities[heap[parent]], priorities[item])) {
+                break;
+            }
+            place(heap[parent], position);
+            position = parent;
+        }
+        place(item, position);
+    }
+
+    void siftDown(size_t position) {
+        size_t item = heap[position];
+        while (2 * position + 1 < heap.size()) {
+            size_t child = 2 * position + 1;
+            if (child + 1 < heap.size() && compare(priorities[heap[child]], priorities[heap[child + 1]])) {
+                ++child;
+            }
+            if (!compare(priorities[item], priorities[heap[child]])) {
+                break;
+            }
+            place(heap[child], position);
+            position = child;
+        }
+        place(item, position);
+    }
+
+    void place(size_t item, size_t position) {
+        heap[position] = item;
+        positions[item] = position;
+    }
+
+    // heap[positions[item]] == item
+    std::vector<size_t> heap, positions;
+    std::vector<PriorityType> priorities;
+    Compare compare;
+};
+
+}  // namespace utility
+}  // namespace compose
+}  // namespace storm
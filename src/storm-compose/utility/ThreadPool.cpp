@@ -0,0 +1,108 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace storm {
+namespace compose {
+namespace utility {
+
+ThreadPool::ThreadPool(size_t threadCount) : threadCount(threadCount) {
+    if (this->threadCount == 0) {
+        this->threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    if (this->threadCount > 1) {
+        for (size_t workerId = 0; workerId < this->threadCount; ++workerId) {
+            workers.emplace_back(&ThreadPool::workerLoop, this, workerId);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shuttingDown = true;
+    }
+    workAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::getThreadCount() const {
+    return threadCount;
+}
+
+void ThreadPool::parallelFor(size_t count, TaskType const& task) {
+    if (count == 0) {
+        return;
+    }
+
+    if (workers.empty()) {
+        for (size_t index = 0; index < count; ++index) {
+            task(index, 0);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    currentTask = &task;
+    taskCount = count;
+    nextIndex = 0;
+    finishedCount = 0;
+    exception = nullptr;
+    ++generation;
+    workAvailable.notify_all();
+
+    workFinished.wait(lock, [&]() { return finishedCount == taskCount; });
+    currentTask = nullptr;
+
+    std::exception_ptr thrown = exception;
+    exception = nullptr;
+    lock.unlock();
+
+    if (thrown) {
+        std::rethrow_exception(thrown);
+    }
+}
+
+void ThreadPool::workerLoop(size_t workerId) {
+    size_t seenGeneration = 0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        workAvailable.wait(lock, [&]() { return shuttingDown || generation != seenGeneration; });
+        if (shuttingDown) {
+            return;
+        }
+        seenGeneration = generation;
+
+        while (nextIndex < taskCount) {
+            size_t index = nextIndex++;
+            TaskType const& task = *currentTask;
+
+            lock.unlock();
+            std::exception_ptr thrown;
+            try {
+                task(index, workerId);
+            } catch (...) {
+                thrown = std::current_exception();
+            }
+            lock.lock();
+
+            if (thrown && !exception) {
+                exception = thrown;
+            }
+
+            ++finishedCount;
+            if (finishedCount == taskCount) {
+                workFinished.notify_one();
+            }
+        }
+    }
+}
+
+}  // namespace utility
+}  // namespace compose
+}  // namespace storm
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace storm {
+namespace compose {
+namespace utility {
+
+// Fixed-size pool of worker threads that is used to process independent work items (e.g. leaves) in parallel.
+class ThreadPool {
+   public:
+    typedef std::function<void(size_t index, size_t workerId)> TaskType;
+
+    /// Creates a pool with the given number of workers, 0 selects the number of hardware threads.
+    /// A pool with a single worker executes all tasks in the calling thread.
+    ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    size_t getThreadCount() const;
+
+    /// Calls task(index, workerId) for every index in [0, count) and blocks until all calls are finished.
+    /// The worker id is in [0, getThreadCount()), so it can be used to index per-thread data.
+    /// If a task throws, the first exception is rethrown in the calling thread.
+    void parallelFor(size_t count, TaskType const& task);
+
+   private:
+    void workerLoop(size_t workerId);
+
+    size_t threadCount;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable workAvailable, workFinished;
+    TaskType const* currentTask = nullptr;
+    size_t taskCount = 0, nextIndex = 0, finishedCount = 0;
+    size_t generation = 0;
+    bool shuttingDown = false;
+    std::exception_ptr exception;
+};
+
+}  // namespace utility
+}  // namespace compose
+}  // namespace storm
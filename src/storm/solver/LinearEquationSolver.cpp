@@ -32,6 +32,39 @@ bool LinearEquationSolver<ValueType>::solveEquations(Environment const& env, std
     return this->internalSolveEquations(env, x, b);
 }
 
+template<typename ValueType>
+bool LinearEquationSolver<ValueType>::solveEquationsBlock(Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b,
+                                                          uint64_t k) const {
+    if (k == 1) {
+        return this->internalSolveEquations(env, x, b);
+    }
+    return this->internalSolveEquationsBlock(env, x, b, k);
+}
+
+template<typename ValueType>
+bool LinearEquationSolver<ValueType>::internalSolveEquationsBlock(Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b,
+                                                                  uint64_t k) const {
+    bool wasCachingEnabled = isCachingEnabled();
+    setCachingEnabled(true);
+
+    uint64_t rowCount = getMatrixRowCount();
+    std::vector<ValueType> laneX(rowCount), laneB(rowCount);
+    bool solved = true;
+    for (uint64_t lane = 0; lane < k; ++lane) {
+        for (uint64_t row = 0; row < rowCount; ++row) {
+            laneX[row] = x[row * k + lane];
+            laneB[row] = b[row * k + lane];
+        }
+        solved &= this->internalSolveEquations(env, laneX, laneB);
+        for (uint64_t row = 0; row < rowCount; ++row) {
+            x[row * k + lane] = laneX[row];
+        }
+    }
+
+    setCachingEnabled(wasCachingEnabled);
+    return solved;
+}
+
 template<typename ValueType>
 LinearEquationSolverRequirements LinearEquationSolver<ValueType>::getRequirements(Environment const&) const {
     return LinearEquationSolverRequirements();
@@ -48,6 +48,18 @@ class LinearEquationSolver : public AbstractEquationSolver<ValueType> {
      */
     bool solveEquations(Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b) const;
 
+    /*!
+     * Solves the equation system for k right-hand sides at once. The k vectors are stored interleaved, i.e., entry j of
+     * vector i is stored at position j * k + i. Custom termination conditions are not considered.
+     *
+     * @param x The solution vectors that have to be computed. Its length must be equal to k times the number of rows of A.
+     * @param b The vectors b. Its length must be equal to k times the number of rows of A.
+     * @param k The number of right-hand sides.
+     *
+     * @return true iff all systems were solved.
+     */
+    bool solveEquationsBlock(Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b, uint64_t k) const;
+
     /*!
      * Retrieves the format in which this solver expects to solve equations. If the solver expects the equation
      * system format, it solves Ax = b. If it it expects a fixed point format, it solves Ax + b = x.
@@ -79,6 +91,9 @@ class LinearEquationSolver : public AbstractEquationSolver<ValueType> {
    protected:
     virtual bool internalSolveEquations(Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b) const = 0;
 
+    // By default, the right-hand sides are solved one after another with caching enabled, so the set up of the solver is shared.
+    virtual bool internalSolveEquationsBlock(Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b, uint64_t k) const;
+
     // auxiliary storage. If set, this vector has getMatrixRowCount() entries.
     mutable std::unique_ptr<std::vector<ValueType>> cachedRowVector;
 
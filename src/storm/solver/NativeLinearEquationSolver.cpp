@@ -630,6 +630,81 @@ bool NativeLinearEquationSolver<ValueType>::internalSolveEquations(Environment c
     return false;
 }
 
+template<typename ValueType>
+bool NativeLinearEquationSolver<ValueType>::internalSolveEquationsBlock(Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b,
+                                                                        uint64_t k) const {
+    auto method = getMethod(env, storm::NumberTraits<ValueType>::IsExact || env.solver().isForceExact());
+    if (this->hasCustomTerminationCondition() || (method != NativeLinearEquationSolverMethod::Power && method != NativeLinearEquationSolverMethod::Jacobi)) {
+        return LinearEquationSolver<ValueType>::internalSolveEquationsBlock(env, x, b, k);
+    }
+    STORM_LOG_INFO("Solving linear equation system (" << getMatrixRowCount() << " rows, " << k << " right-hand sides) with NativeLinearEquationSolver ("
+                                                      << toString(method) << ")");
+
+    // Both methods iterate all right-hand sides together, so every iteration traverses the matrix only once
+    bool jacobi = method == NativeLinearEquationSolverMethod::Jacobi;
+    Multiplier<ValueType> const* blockMultiplier;
+    if (jacobi) {
+        if (!jacobiDecomposition) {
+            jacobiDecomposition = std::make_unique<JacobiDecomposition>(env, *A);
+        }
+        blockMultiplier = jacobiDecomposition->multiplier.get();
+    } else {
+        if (!multiplier) {
+            multiplier = storm::solver::MultiplierFactory<ValueType>().create(env, *A);
+        }
+        blockMultiplier = multiplier.get();
+    }
+
+    ValueType precision = storm::utility::convertNumber<ValueType>(env.solver().native().getPrecision());
+    uint64_t maxIter = env.solver().native().getMaximalNumberOfIterations();
+    bool relative = env.solver().native().getRelativeTerminationCriterion();
+
+    std::vector<ValueType> otherX(x.size());
+    std::vector<ValueType>* currentX = &x;
+    std::vector<ValueType>* nextX = &otherX;
+
+    uint64_t iterations = 0;
+    SolverStatus status = SolverStatus::InProgress;
+
+    this->startMeasureProgress();
+    while (status == SolverStatus::InProgress && iterations < maxIter) {
+        if (jacobi) {
+            // Compute D^-1 * (b - LU * x) for every right-hand side.
+            blockMultiplier->multiplyBlock(env, *currentX, nullptr, *nextX, k);
+            for (uint64_t row = 0; row < jacobiDecomposition->DVector.size(); ++row) {
+                ValueType const& d = jacobiDecomposition->DVector[row];
+                for (uint64_t lane = row * k, end = lane + k; lane < end; ++lane) {
+                    (*nextX)[lane] = d * (b[lane] - (*nextX)[lane]);
+                }
+            }
+        } else {
+            blockMultiplier->multiplyBlock(env, *currentX, &b, *nextX, k);
+        }
+
+        if (storm::utility::vector::equalModuloPrecision<ValueType>(*currentX, *nextX, precision, relative)) {
+            status = SolverStatus::Converged;
+        }
+        std::swap(nextX, currentX);
+
+        this->showProgressIterative(iterations);
+        ++iterations;
+
+        status = this->updateStatus(status, false, iterations, maxIter);
+    }
+
+    if (currentX != &x) {
+        std::swap(x, *currentX);
+    }
+
+    if (!this->isCachingEnabled()) {
+        clearCache();
+    }
+
+    this->reportStatus(status, iterations);
+
+    return status == SolverStatus::Converged;
+}
+
 template<typename ValueType>
 LinearEquationSolverProblemFormat NativeLinearEquationSolver<ValueType>::getEquationProblemFormat(Environment const& env) const {
     auto method = getMethod(env, storm::NumberTraits<ValueType>::IsExact || env.solver().isForceExact());
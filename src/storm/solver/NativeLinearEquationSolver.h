@@ -38,6 +38,8 @@ class NativeLinearEquationSolver : public LinearEquationSolver<ValueType> {
 
    protected:
     virtual bool internalSolveEquations(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b) const override;
+    virtual bool internalSolveEquationsBlock(storm::Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const& b,
+                                             uint64_t k) const override;
 
    private:
     struct PowerIterationResult {
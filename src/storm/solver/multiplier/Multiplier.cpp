@@ -29,6 +29,39 @@ void Multiplier<ValueType>::clearCache() const {
     cachedVector.reset();
 }
 
+template<typename ValueType>
+void Multiplier<ValueType>::multiplyBlock(Environment const& env, std::vector<ValueType> const& x, std::vector<ValueType> const* b,
+                                          std::vector<ValueType>& result, uint64_t k) const {
+    if (k == 1) {
+        multiply(env, x, b, result);
+        return;
+    }
+
+    // Fallback: multiply the vectors one after another
+    uint64_t rowCount = this->matrix.getRowCount();
+    uint64_t columnCount = this->matrix.getColumnCount();
+    std::vector<ValueType> laneX(columnCount), laneB, laneResult(rowCount);
+    if (b) {
+        laneB.resize(rowCount);
+    }
+    std::vector<ValueType> blockResult(rowCount * k);
+    for (uint64_t lane = 0; lane < k; ++lane) {
+        for (uint64_t column = 0; column < columnCount; ++column) {
+            laneX[column] = x[column * k + lane];
+        }
+        if (b) {
+            for (uint64_t row = 0; row < rowCount; ++row) {
+                laneB[row] = (*b)[row * k + lane];
+            }
+        }
+        multiply(env, laneX, b ? &laneB : nullptr, laneResult);
+        for (uint64_t row = 0; row < rowCount; ++row) {
+            blockResult[row * k + lane] = laneResult[row];
+        }
+    }
+    result = std::move(blockResult);
+}
+
 template<typename ValueType>
 void Multiplier<ValueType>::multiplyAndReduce(Environment const& env, OptimizationDirection const& dir, std::vector<ValueType> const& x,
                                               std::vector<ValueType> const* b, std::vector<ValueType>& result, std::vector<uint_fast64_t>* choices) const {
@@ -41,6 +41,21 @@ class Multiplier {
      */
     virtual void multiply(Environment const& env, std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result) const = 0;
 
+    /*!
+     * Performs k matrix-vector multiplications X' = A*X + B at once. The k vectors are stored interleaved, i.e.,
+     * entry j of vector i is stored at position j * k + i.
+     *
+     * @param x The input vectors with which to multiply the matrix. Its length must be equal
+     * to k times the number of columns of A.
+     * @param b If non-null, these vectors are added after the multiplication. If given, its length must be equal
+     * to k times the number of rows of A.
+     * @param result The target vectors into which to write the multiplication result. Its length must be equal
+     * to k times the number of rows of A. Can be the same as the x vector.
+     * @param k The number of vectors.
+     */
+    virtual void multiplyBlock(Environment const& env, std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result,
+                               uint64_t k) const;
+
     /*!
      * Performs a matrix-vector multiplication in gauss-seidel style.
      *
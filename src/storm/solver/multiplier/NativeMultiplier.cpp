@@ -12,6 +12,7 @@
 #include "storm/adapters/RationalFunctionAdapter.h"
 #include "storm/adapters/RationalNumberAdapter.h"
 
+#include "storm/utility/constants.h"
 #include "storm/utility/macros.h"
 
 namespace storm {
@@ -53,6 +54,24 @@ void NativeMultiplier<ValueType>::multiply(Environment const& env, std::vector<V
     }
 }
 
+template<typename ValueType>
+void NativeMultiplier<ValueType>::multiplyBlock(Environment const& env, std::vector<ValueType> const& x, std::vector<ValueType> const* b,
+                                                std::vector<ValueType>& result, uint64_t k) const {
+    std::vector<ValueType>* target = &result;
+    if (&x == &result) {
+        if (this->cachedVector) {
+            this->cachedVector->resize(x.size());
+        } else {
+            this->cachedVector = std::make_unique<std::vector<ValueType>>(x.size());
+        }
+        target = this->cachedVector.get();
+    }
+    multAddBlock(x, b, *target, k);
+    if (&x == &result) {
+        std::swap(result, *this->cachedVector);
+    }
+}
+
 template<typename ValueType>
 void NativeMultiplier<ValueType>::multiplyGaussSeidel(Environment const& env, std::vector<ValueType>& x, std::vector<ValueType> const* b,
                                                       bool backwards) const {
@@ -118,6 +137,34 @@ void NativeMultiplier<ValueType>::multAdd(std::vector<ValueType> const& x, std::
     this->matrix.multiplyWithVector(x, result, b);
 }
 
+template<typename ValueType>
+void NativeMultiplier<ValueType>::multAddBlock(std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result,
+                                               uint64_t k) const {
+    // One pass over the matrix serves all k vectors. The innermost loop runs over the contiguous lanes of a row, so it can be vectorized.
+    uint64_t rowCount = this->matrix.getRowCount();
+    result.resize(rowCount * k);
+    for (uint64_t row = 0; row < rowCount; ++row) {
+        ValueType* resultLanes = result.data() + row * k;
+        if (b) {
+            ValueType const* bLanes = b->data() + row * k;
+            for (uint64_t lane = 0; lane < k; ++lane) {
+                resultLanes[lane] = bLanes[lane];
+            }
+        } else {
+            for (uint64_t lane = 0; lane < k; ++lane) {
+                resultLanes[lane] = storm::utility::zero<ValueType>();
+            }
+        }
+        for (auto entryIt = this->matrix.begin(row), entryEnd = this->matrix.end(row); entryIt != entryEnd; ++entryIt) {
+            ValueType const& value = entryIt->getValue();
+            ValueType const* xLanes = x.data() + entryIt->getColumn() * k;
+            for (uint64_t lane = 0; lane < k; ++lane) {
+                resultLanes[lane] += value * xLanes[lane];
+            }
+        }
+    }
+}
+
 template<typename ValueType>
 void NativeMultiplier<ValueType>::multAddReduce(storm::solver::OptimizationDirection const& dir, std::vector<uint64_t> const& rowGroupIndices,
                                                 std::vector<ValueType> const& x, std::vector<ValueType> const* b, std::vector<ValueType>& result,
@@ -1,6 +1,7 @@
 #include "storm/storage/sparse/StateValuations.h"
 
 #include <boost/algorithm/string/join.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storm/adapters/JsonAdapter.h"
 
@@ -312,14 +313,24 @@ std::size_t StateValuations::hash() const {
     return 0;
 }
 
+std::size_t StateValuations::IntegerValuesHash::operator()(std::vector<int64_t> const& integerValues) const {
+    return boost::hash_range(integerValues.begin(), integerValues.end());
+}
+
 boost::optional<uint64_t> StateValuations::findState(StateValuation const& stateVal) const {
-    for (size_t i = 0; i < valuations.size(); ++i) {
-        if (valuations[i].integerValues == stateVal.integerValues) {
-            return i;
+    IntegerValuesIndex& index = *integerValuesIndex;
+    std::call_once(index.built, [this, &index]() {
+        index.states.reserve(valuations.size());
+        for (uint64_t state = 0; state < valuations.size(); ++state) {
+            index.states.emplace(valuations[state].integerValues, state);
         }
-    }
+    });
 
-    return boost::none;
+    auto it = index.states.find(stateVal.integerValues);
+    if (it == index.states.end()) {
+        return boost::none;
+    }
+    return it->second;
 }
 
 StateValuations StateValuations::selectStates(storm::storage::BitVector const& selectedStates) const {
@@ -2,7 +2,11 @@
 
 #include <boost/optional.hpp>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "storm/adapters/JsonForward.h"
 #include "storm/adapters/RationalNumberForward.h"
@@ -137,7 +141,8 @@ class StateValuations : public storm::models::sparse::StateAnnotation {
 
     virtual std::size_t hash() const;
 
-    /// Find the state with the given valuation (if it exists)
+    /// Find the state with the given valuation (if it exists). Only the integer values are compared, the first matching state is returned.
+    /// The first call builds a hash index over all valuations, so subsequent calls take constant time.
     boost::optional<uint64_t> findState(StateValuation const& stateVal) const;
 
    private:
@@ -149,6 +154,17 @@ class StateValuations : public storm::models::sparse::StateAnnotation {
     std::map<std::string, uint64_t> observationLabels;
     // A mapping from state indices to their variable valuations.
     std::vector<StateValuation> valuations;
+
+    struct IntegerValuesHash {
+        std::size_t operator()(std::vector<int64_t> const& integerValues) const;
+    };
+    // Maps integer values to the first state that has them, built on the first call of findState. Copies share the index, their valuations are
+    // the same and not changed after construction.
+    struct IntegerValuesIndex {
+        std::once_flag built;
+        std::unordered_map<std::vector<int64_t>, uint64_t, IntegerValuesHash> states;
+    };
+    std::shared_ptr<IntegerValuesIndex> integerValuesIndex = std::make_shared<IntegerValuesIndex>();
 };
 
 class StateValuationsBuilder {
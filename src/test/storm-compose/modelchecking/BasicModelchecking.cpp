@@ -1,12 +1,35 @@
 #include "storm-compose/benchmark/BenchmarkStats.h"
+#include "storm-compose/modelchecker/CompositionalValueIteration.h"
+#include "storm-compose/modelchecker/LazyMonolithicOpenMdpChecker.h"
 #include "storm-compose/modelchecker/MonolithicOpenMdpChecker.h"
 #include "storm-compose/modelchecker/NaiveOpenMdpChecker.h"
+#include "storm-compose/models/ConcreteMdp.h"
 #include "storm-compose/models/OpenMdp.h"
+#include "storm-compose/models/PrismModel.h"
+#include "storm-compose/models/visitor/BottomUpTermination.h"
+#include "storm-compose/models/visitor/FlatMdpBuilderVisitor.h"
+#include "storm-compose/models/visitor/MappingVisitor.h"
+#include "storm-compose/parser/BinaryStringDiagram.h"
+#include "storm-compose/parser/BinaryStringDiagramParser.h"
 #include "storm-compose/parser/JsonStringDiagramParser.h"
+#include "storm-compose/storage/LeafDiskCache.h"
+#include "storm-compose/storage/ParetoCache.h"
 #include "storm-config.h"
 #include "storm/api/storm.h"
+#include "storm/exceptions/InvalidOperationException.h"
+#include "storm/exceptions/WrongFormatException.h"
+#include "storm/models/sparse/StateLabeling.h"
+#include "storm/storage/sparse/ModelComponents.h"
 #include "test/storm_gtest.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <thread>
+
 class DoubleEnvironment {
    public:
     typedef double ValueType;
@@ -51,6 +74,46 @@ class BasicModelcheckingTest : public ::testing::Test {
         return {omdpManager};
     }
 
+    // Leaf with a left entrance (state 0) that reaches the right exits 1 and 2, state 0 has a second choice that moves to exit 2
+    std::shared_ptr<storm::models::ConcreteMdp<ValueType>> buildLeaf(ValueType const& probability) const {
+        storm::storage::SparseMatrixBuilder<ValueType> builder(4, 3, 5, true, true, 3);
+        builder.newRowGroup(0);
+        builder.addNextValue(0, 1, probability);
+        builder.addNextValue(0, 2, storm::utility::one<ValueType>() - probability);
+        builder.addNextValue(1, 2, storm::utility::one<ValueType>());
+        builder.newRowGroup(2);
+        builder.addNextValue(2, 1, storm::utility::one<ValueType>());
+        builder.newRowGroup(3);
+        builder.addNextValue(3, 2, storm::utility::one<ValueType>());
+
+        storm::models::sparse::StateLabeling labeling(3);
+        labeling.addLabel("init");
+        labeling.addLabelToState("init", 0);
+        storm::storage::sparse::ModelComponents<ValueType> components(builder.build(), std::move(labeling));
+        auto mdp = std::make_shared<storm::models::sparse::Mdp<ValueType>>(std::move(components));
+        return std::make_shared<storm::models::ConcreteMdp<ValueType>>(std::weak_ptr<storm::models::OpenMdpManager<ValueType>>(), mdp,
+                                                                       std::vector<size_t>{0}, std::vector<size_t>{}, std::vector<size_t>{},
+                                                                       std::vector<size_t>{1, 2});
+    }
+
+    // Fresh directory, removed by the caller
+    static std::filesystem::path createTemporaryDirectory() {
+        std::random_device random;
+        auto directory = std::filesystem::temp_directory_path() / ("storm-compose-test-" + std::to_string(random()));
+        std::filesystem::create_directories(directory);
+        return directory;
+    }
+
+    static std::vector<std::filesystem::path> listFiles(std::filesystem::path const& directory, std::string const& extension) {
+        std::vector<std::filesystem::path> files;
+        for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.path().extension() == extension) {
+                files.push_back(entry.path());
+            }
+        }
+        return files;
+    }
+
    private:
     storm::Environment _environment;
     storm::models::visitor::LowerUpperParetoSettings _lowerUpperParetoSettings;
@@ -84,3 +147,929 @@ TYPED_TEST(BasicModelcheckingTest, MonolithicRightwardReachability) {
         EXPECT_TRUE(naiveResult.getLowerBound() <= monolithicResult && naiveResult.getUpperBound() >= monolithicResult);
     }
 }
+
+TYPED_TEST(BasicModelcheckingTest, LazyMonolithicReachability) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    OpenMdpReachabilityTask task;
+
+    for (std::string const& diagram : {"test1", "test2"}) {
+        const std::string path = STORM_TEST_RESOURCES_DIR "/compose/" + diagram + "/sd.json";
+        BenchmarkStats<ValueType> monolithicStats;
+        MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+        auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+        // A state limit stops the exploration before the bounds meet
+        for (size_t stateLimit : {0, 5}) {
+            typename LazyMonolithicOpenMdpChecker<ValueType>::Options options;
+            options.stateLimit = stateLimit;
+            options.samplesPerRound = 2;
+
+            BenchmarkStats<ValueType> stats;
+            LazyMonolithicOpenMdpChecker<ValueType> lazyChecker(this->buildPrism(path).manager, stats, options);
+            auto result = lazyChecker.check(task);
+
+            EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-6) << diagram << " " << stateLimit;
+            EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-6) << diagram << " " << stateLimit;
+            if (stateLimit == 0) {
+                EXPECT_LE(result.getUpperBound() - result.getLowerBound(), options.precision) << diagram;
+            }
+        }
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, ParallelCviReachability) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    const std::string path = STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json";
+    OpenMdpReachabilityTask task;
+
+    BenchmarkStats<ValueType> monolithicStats;
+    MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+    auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+    // The parallel orders converge to the same bounds as the serial forward order, up to epsilon
+    boost::optional<ApproximateReachabilityResult<ValueType>> forwardResult;
+    for (std::string const& order : {"forward", "parallel-jacobi", "parallel-gauss-seidel"}) {
+        typename CompositionalValueIteration<ValueType>::Options options;
+        options.useBottomUp = false;
+        options.iterationOrder = order;
+        options.threadCount = 2;
+
+        BenchmarkStats<ValueType> stats;
+        CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+        auto result = cvi.check(task);
+
+        EXPECT_LT(result.getUpperBound() - result.getLowerBound(), options.epsilon) << order;
+        EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-4) << order;
+        EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-4) << order;
+        if (!forwardResult) {
+            forwardResult = result;
+        } else {
+            EXPECT_NEAR(result.getLowerBound(), forwardResult->getLowerBound(), options.epsilon) << order;
+            EXPECT_NEAR(result.getUpperBound(), forwardResult->getUpperBound(), options.epsilon) << order;
+        }
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, OviCertifiedUpperBound) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    OpenMdpReachabilityTask task;
+
+    // A coarse local precision makes the cached upper bounds of leaves that are certified without solving them noticeably imprecise
+    for (std::string const& diagram : {"test1", "test2"}) {
+        const std::string path = STORM_TEST_RESOURCES_DIR "/compose/" + diagram + "/sd.json";
+        BenchmarkStats<ValueType> monolithicStats;
+        MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+        auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+        for (CacheMethod cacheMethod : {PARETO_CACHE, PARETO_VERTEX_CACHE}) {
+            typename CompositionalValueIteration<ValueType>::Options options;
+            options.useOvi = true;
+            options.useBottomUp = false;
+            options.cacheMethod = cacheMethod;
+            options.localOviEpsilon = 1e-3;
+            options.epsilon = 5e-2;
+            options.oviInterval = 1;
+
+            BenchmarkStats<ValueType> stats;
+            CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+            auto result = cvi.check(task);
+
+            EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-6) << diagram << " " << cacheMethod;
+        }
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, OviPrecomputedParetoSets) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    // The leaves of test1 have three and two exits, so the points of their Pareto sets are no upper bounds
+    const std::string path = STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json";
+    OpenMdpReachabilityTask task;
+
+    BenchmarkStats<ValueType> monolithicStats;
+    MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+    auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+    for (CacheMethod cacheMethod : {NO_CACHE, EXACT_CACHE}) {
+        typename CompositionalValueIteration<ValueType>::Options options;
+        options.useOvi = true;
+        options.useBottomUp = false;
+        options.cacheMethod = cacheMethod;
+        options.paretoPrecomputationThreshold = 10;
+        options.localOviEpsilon = 1e-3;
+        options.epsilon = 5e-2;
+        options.oviInterval = 1;
+
+        BenchmarkStats<ValueType> stats;
+        CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+        auto result = cvi.check(task);
+
+        EXPECT_EQ(stats.paretoPrecomputedLeaves, 2ul) << cacheMethod;
+        EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-6) << cacheMethod;
+        EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-6) << cacheMethod;
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, CviProfiling) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    const std::string path = STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json";
+    OpenMdpReachabilityTask task;
+
+    typename CompositionalValueIteration<ValueType>::Options options;
+    options.useBottomUp = false;
+    options.iterationOrder = "parallel-jacobi";
+    options.threadCount = 2;
+
+    BenchmarkStats<ValueType> stats;
+    stats.recordTraceEvents = true;
+    CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+    auto result = cvi.check(task);
+
+    // Every solve of a leaf is in its profile and has a trace event
+    size_t solves = 0;
+    for (auto const& profile : stats.leafProfiles) {
+        EXPECT_TRUE(profile.second.initialized);
+        EXPECT_EQ(profile.first, profile.second.name);
+        EXPECT_GT(profile.second.states, 0ul);
+        solves += profile.second.solves;
+    }
+    EXPECT_GT(solves, 0ul);
+    EXPECT_GE(stats.traceEvents.size(), solves);
+
+    ASSERT_FALSE(stats.steps.empty());
+    EXPECT_EQ(stats.steps.back().lowerBound, result.getLowerBound());
+    ASSERT_TRUE(stats.steps.back().upperBound.is_initialized());
+    EXPECT_EQ(*stats.steps.back().upperBound, result.getUpperBound());
+    for (size_t i = 1; i < stats.steps.size(); ++i) {
+        EXPECT_LE(stats.steps[i - 1].time, stats.steps[i].time);
+    }
+
+    auto json = stats.toJson();
+    EXPECT_EQ(json["leafProfiles"].size(), stats.leafProfiles.size());
+    EXPECT_EQ(json["steps"].size(), stats.steps.size());
+}
+
+TYPED_TEST(BasicModelcheckingTest, ParetoCacheVariantsReachability) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    const std::string path = STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json";
+    OpenMdpReachabilityTask task;
+
+    BenchmarkStats<ValueType> monolithicStats;
+    MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+    auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+    for (CacheMethod cacheMethod : {PARETO_CACHE, PARETO_VERTEX_CACHE}) {
+        for (bool exactParetoCache : {false, true}) {
+            typename CompositionalValueIteration<ValueType>::Options options;
+            options.useOvi = false;
+            options.useBottomUp = true;
+            options.cacheMethod = cacheMethod;
+            options.exactParetoCache = exactParetoCache;
+
+            BenchmarkStats<ValueType> stats;
+            CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+            auto result = cvi.check(task);
+
+            EXPECT_LT(result.getUpperBound() - result.getLowerBound(), options.epsilon) << cacheMethod << " " << exactParetoCache;
+            EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-4) << cacheMethod << " " << exactParetoCache;
+            EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-4) << cacheMethod << " " << exactParetoCache;
+        }
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, SubtreeSummaryReachability) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    OpenMdpReachabilityTask task;
+
+    for (std::string const& diagram : {"test1", "test2"}) {
+        const std::string path = STORM_TEST_RESOURCES_DIR "/compose/" + diagram + "/sd.json";
+        BenchmarkStats<ValueType> monolithicStats;
+        MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+        auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+        // Subtrees are summarized once their leaves kept their bounds for the given number of sweeps
+        for (size_t sweeps : {1, 3}) {
+            typename CompositionalValueIteration<ValueType>::Options options;
+            options.useOvi = false;
+            options.useBottomUp = true;
+            options.subtreeSummarySweeps = sweeps;
+
+            BenchmarkStats<ValueType> stats;
+            CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+            auto result = cvi.check(task);
+
+            EXPECT_LT(result.getUpperBound() - result.getLowerBound(), options.epsilon) << diagram << " " << sweeps;
+            EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-4) << diagram << " " << sweeps;
+            EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-4) << diagram << " " << sweeps;
+        }
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, PrioritizedBottomUpConvergence) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    OpenMdpReachabilityTask task;
+
+    // Once no change is pending, the prioritized order has to keep refining the cache, otherwise the gap stays above epsilon
+    for (std::string const& diagram : {"test1", "test2"}) {
+        const std::string path = STORM_TEST_RESOURCES_DIR "/compose/" + diagram + "/sd.json";
+        BenchmarkStats<ValueType> monolithicStats;
+        MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+        auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+        typename CompositionalValueIteration<ValueType>::Options options;
+        options.useOvi = false;
+        options.useBottomUp = true;
+        options.iterationOrder = "prioritized";
+        options.epsilon = 1e-4;
+
+        BenchmarkStats<ValueType> stats;
+        CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+        auto result = cvi.check(task);
+
+        EXPECT_LT(result.getUpperBound() - result.getLowerBound(), options.epsilon) << diagram;
+        EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-6) << diagram;
+        EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-6) << diagram;
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, TraceCviReachability) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    const std::string path = STORM_TEST_RESOURCES_DIR "/compose/test2/sd.json";
+    OpenMdpReachabilityTask task;
+
+    BenchmarkStats<ValueType> monolithicStats;
+    MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+    auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+    for (bool useOvi : {true, false}) {
+        for (std::string const& order : {"forward", "backward", "topological", "prioritized"}) {
+            typename CompositionalValueIteration<ValueType>::Options options;
+            options.useOvi = useOvi;
+            options.useBottomUp = !useOvi;
+            options.iterationOrder = order;
+
+            BenchmarkStats<ValueType> stats;
+            CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+            auto result = cvi.check(task);
+
+            EXPECT_LT(result.getUpperBound() - result.getLowerBound(), options.epsilon) << order << " " << useOvi;
+            EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-4) << order << " " << useOvi;
+            EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-4) << order << " " << useOvi;
+        }
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, DiskCacheRoundTrip) {
+    typedef typename TestFixture::ValueType ValueType;
+    auto directory = this->createTemporaryDirectory();
+    storm::storage::LeafDiskCache<ValueType> diskCache(directory.string());
+
+    auto leaf = this->buildLeaf(this->parseNumber("0.3"));
+    diskCache.storeLeaf("leaf", *leaf);
+    auto loadedLeaf = diskCache.loadLeaf("leaf", {});
+    ASSERT_TRUE(loadedLeaf != nullptr);
+    EXPECT_TRUE(loadedLeaf->getMdp()->getTransitionMatrix() == leaf->getMdp()->getTransitionMatrix());
+    EXPECT_TRUE(loadedLeaf->getMdp()->getStateLabeling().getStateHasLabel("init", 0));
+    EXPECT_EQ(loadedLeaf->getLEntrance(), leaf->getLEntrance());
+    EXPECT_EQ(loadedLeaf->getREntrance(), leaf->getREntrance());
+    EXPECT_EQ(loadedLeaf->getLExit(), leaf->getLExit());
+    EXPECT_EQ(loadedLeaf->getRExit(), leaf->getRExit());
+    EXPECT_TRUE(diskCache.loadLeaf("other", {}) == nullptr);
+
+    storm::storage::PrecomputedParetoSet<ValueType> paretoSet(1);
+    paretoSet.addPoint(0, {this->parseNumber("0.3"), this->parseNumber("0.7")});
+    paretoSet.addPoint(0, {storm::utility::zero<ValueType>(), storm::utility::one<ValueType>()});
+    paretoSet.addHalfspace(0, {storm::utility::one<ValueType>(), storm::utility::one<ValueType>()}, storm::utility::one<ValueType>());
+    diskCache.storeParetoSet(*leaf, paretoSet);
+
+    // Pareto sets are found for every leaf with the same MDP
+    auto loadedSet = diskCache.loadParetoSet(*loadedLeaf);
+    ASSERT_TRUE(loadedSet != nullptr);
+    ASSERT_EQ(loadedSet->getEntranceCount(), 1ul);
+    EXPECT_EQ(loadedSet->getPoints(0), paretoSet.getPoints(0));
+    EXPECT_EQ(loadedSet->getHalfspaces(0), paretoSet.getHalfspaces(0));
+    EXPECT_TRUE(diskCache.loadParetoSet(*this->buildLeaf(this->parseNumber("0.5"))) == nullptr);
+
+    // Only the stored files are left, no temporary ones
+    EXPECT_EQ(this->listFiles(directory, ".leaf").size() + this->listFiles(directory, ".pareto").size(),
+              static_cast<size_t>(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator())));
+
+    std::filesystem::remove_all(directory);
+}
+
+TYPED_TEST(BasicModelcheckingTest, DiskCacheRejectsCorruptFiles) {
+    typedef typename TestFixture::ValueType ValueType;
+    auto directory = this->createTemporaryDirectory();
+    storm::storage::LeafDiskCache<ValueType> diskCache(directory.string());
+
+    auto leaf = this->buildLeaf(this->parseNumber("0.3"));
+    auto otherLeaf = this->buildLeaf(this->parseNumber("0.5"));
+    storm::storage::PrecomputedParetoSet<ValueType> paretoSet(1);
+    paretoSet.addPoint(0, {this->parseNumber("0.3"), this->parseNumber("0.7")});
+    diskCache.storeParetoSet(*leaf, paretoSet);
+    auto paretoFile = this->listFiles(directory, ".pareto").at(0);
+    diskCache.storeParetoSet(*otherLeaf, paretoSet);
+    std::filesystem::path otherParetoFile;
+    for (auto const& file : this->listFiles(directory, ".pareto")) {
+        if (file != paretoFile) {
+            otherParetoFile = file;
+        }
+    }
+    ASSERT_FALSE(otherParetoFile.empty());
+
+    auto readFile = [](std::filesystem::path const& file) {
+        std::ifstream in(file, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+
+    // The bounds of the first leaf with the file hash of the other one (after the 12 byte header), as after a collision of that hash
+    auto const otherParetoFileContent = readFile(otherParetoFile);
+    std::ofstream(otherParetoFile, std::ios::binary | std::ios::trunc) << otherParetoFileContent.substr(0, 20) << readFile(paretoFile).substr(20);
+    EXPECT_TRUE(diskCache.loadParetoSet(*otherLeaf) == nullptr);
+    EXPECT_TRUE(diskCache.loadParetoSet(*leaf) != nullptr);
+
+    diskCache.storeLeaf("leaf", *leaf);
+    auto leafFile = this->listFiles(directory, ".leaf").at(0);
+    auto const leafFileContent = readFile(leafFile);
+    auto paretoFileSize = std::filesystem::file_size(paretoFile);
+
+    // Truncated files
+    std::filesystem::resize_file(leafFile, leafFileContent.size() / 2);
+    EXPECT_TRUE(diskCache.loadLeaf("leaf", {}) == nullptr);
+    std::filesystem::resize_file(paretoFile, paretoFileSize / 2);
+    EXPECT_TRUE(diskCache.loadParetoSet(*leaf) == nullptr);
+
+    // Overwritten contents
+    std::ofstream(leafFile, std::ios::binary | std::ios::trunc) << std::string(leafFileContent.size(), '\xff');
+    EXPECT_TRUE(diskCache.loadLeaf("leaf", {}) == nullptr);
+    std::ofstream(paretoFile, std::ios::binary | std::ios::trunc) << std::string(paretoFileSize, '\xff');
+    EXPECT_TRUE(diskCache.loadParetoSet(*leaf) == nullptr);
+
+    // A corrupt value behind a valid header
+    std::string corruptLeaf = leafFileContent;
+    corruptLeaf.replace(corruptLeaf.size() - 16, 16, 16, '\xff');
+    std::ofstream(leafFile, std::ios::binary | std::ios::trunc) << corruptLeaf;
+    EXPECT_TRUE(diskCache.loadLeaf("leaf", {}) == nullptr);
+
+    std::filesystem::remove_all(directory);
+}
+
+TYPED_TEST(BasicModelcheckingTest, BinaryStringDiagramReachability) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    OpenMdpReachabilityTask task;
+    auto directory = this->createTemporaryDirectory();
+
+    for (std::string const& diagram : {"test1", "test2"}) {
+        const std::string jsonPath = STORM_TEST_RESOURCES_DIR "/compose/" + diagram + "/sd.json";
+        const std::string binaryPath = (directory / (diagram + ".bin")).string();
+        storm::parser::BinaryStringDiagram::convertJson(jsonPath, binaryPath);
+        EXPECT_TRUE(storm::parser::BinaryStringDiagram::isBinaryStringDiagram(binaryPath));
+        EXPECT_FALSE(storm::parser::BinaryStringDiagram::isBinaryStringDiagram(jsonPath));
+
+        auto buildBinary = [&binaryPath]() {
+            auto manager = std::make_shared<storm::models::OpenMdpManager<ValueType>>();
+            storm::parser::BinaryStringDiagramParser<ValueType>::fromFilePath(binaryPath, manager).parse();
+            return manager;
+        };
+
+        BenchmarkStats<ValueType> stats;
+        MonolithicOpenMdpChecker<ValueType> jsonMonolithicChecker(this->buildPrism(jsonPath).manager, stats);
+        auto jsonMonolithicResult = jsonMonolithicChecker.check(task).getLowerBound();
+        MonolithicOpenMdpChecker<ValueType> binaryMonolithicChecker(buildBinary(), stats);
+        auto binaryMonolithicResult = binaryMonolithicChecker.check(task).getLowerBound();
+        EXPECT_NEAR(binaryMonolithicResult, jsonMonolithicResult, 1e-6) << diagram;
+
+        typename CompositionalValueIteration<ValueType>::Options options;
+        CompositionalValueIteration<ValueType> jsonCvi(this->buildPrism(jsonPath).manager, stats, options);
+        auto jsonResult = jsonCvi.check(task);
+        CompositionalValueIteration<ValueType> binaryCvi(buildBinary(), stats, options);
+        auto binaryResult = binaryCvi.check(task);
+        EXPECT_NEAR(binaryResult.getLowerBound(), jsonResult.getLowerBound(), 1e-4) << diagram;
+        EXPECT_NEAR(binaryResult.getUpperBound(), jsonResult.getUpperBound(), 1e-4) << diagram;
+        EXPECT_LE(binaryResult.getLowerBound(), jsonMonolithicResult + 1e-4) << diagram;
+        EXPECT_GE(binaryResult.getUpperBound(), jsonMonolithicResult - 1e-4) << diagram;
+    }
+
+    // Truncated files and files of another format are rejected before any table is read
+    const std::string binaryPath = (directory / "test1.bin").string();
+    const std::string corruptPath = (directory / "corrupt.bin").string();
+    for (auto size : {std::filesystem::file_size(binaryPath) - 1, std::filesystem::file_size(binaryPath) / 2, std::uintmax_t(4)}) {
+        std::filesystem::copy_file(binaryPath, corruptPath, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(corruptPath, size);
+        auto manager = std::make_shared<storm::models::OpenMdpManager<ValueType>>();
+        EXPECT_THROW(storm::parser::BinaryStringDiagramParser<ValueType>::fromFilePath(corruptPath, manager), storm::exceptions::WrongFormatException)
+            << size;
+    }
+    std::ofstream(corruptPath, std::ios::binary | std::ios::trunc) << std::string(std::filesystem::file_size(binaryPath), '\xff');
+    EXPECT_THROW(std::make_shared<storm::parser::BinaryStringDiagram const>(corruptPath), storm::exceptions::WrongFormatException);
+
+    std::filesystem::remove_all(directory);
+}
+
+TYPED_TEST(BasicModelcheckingTest, ConcurrentParetoCacheInsertions) {
+    typedef typename TestFixture::ValueType ValueType;
+    auto leaf = this->buildLeaf(this->parseNumber("0.3"));
+    std::vector<storm::models::ConcreteMdp<ValueType>*> leaves{leaf.get()};
+
+    // Without pruning every insertion adds one point and one halfspace, so none may be lost when the threads publish concurrently
+    typename storm::storage::ParetoCache<ValueType>::Options cacheOptions;
+    cacheOptions.pruneBounds = false;
+    storm::storage::ParetoCache<ValueType> cache(cacheOptions);
+    cache.initializeParetoCurves(leaves);
+
+    size_t const threadCount = 8, insertionsPerThread = 20;
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < threadCount; ++thread) {
+        threads.emplace_back([&, thread]() {
+            for (size_t i = 0; i < insertionsPerThread; ++i) {
+                // Choice 0 reaches the exits with (0.3, 0.7), choice 1 reaches the second exit with probability 1
+                storm::storage::Scheduler<ValueType> scheduler(3);
+                scheduler.setChoice(i % 2, 0);
+                scheduler.setChoice(0, 1);
+                scheduler.setChoice(0, 2);
+                ValueType weight = storm::utility::convertNumber<ValueType>(thread * insertionsPerThread + i + 1) /
+                                   storm::utility::convertNumber<ValueType>(threadCount * insertionsPerThread + 1);
+                cache.addToCache(leaf.get(), {weight, storm::utility::one<ValueType>() - weight}, {}, scheduler);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto paretoSet = cache.exportParetoSet(leaf.get());
+    auto const& points = paretoSet.getPoints(0);
+    ASSERT_EQ(points.size(), threadCount * insertionsPerThread);
+    EXPECT_EQ(paretoSet.getHalfspaces(0).size(), threadCount * insertionsPerThread);
+    std::vector<ValueType> firstChoicePoint{this->parseNumber("0.3"), this->parseNumber("0.7")};
+    std::vector<ValueType> secondChoicePoint{storm::utility::zero<ValueType>(), storm::utility::one<ValueType>()};
+    size_t firstChoicePoints = std::count(points.begin(), points.end(), firstChoicePoint);
+    size_t secondChoicePoints = std::count(points.begin(), points.end(), secondChoicePoint);
+    EXPECT_EQ(firstChoicePoints, threadCount * insertionsPerThread / 2);
+    EXPECT_EQ(secondChoicePoints, threadCount * insertionsPerThread / 2);
+}
+
+TYPED_TEST(BasicModelcheckingTest, LipschitzParetoCacheBounds) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    auto leaf = this->buildLeaf(this->parseNumber("0.3"));
+    std::vector<storm::models::ConcreteMdp<ValueType>*> leaves{leaf.get()};
+
+    typename storm::storage::ParetoCache<ValueType>::Options cacheOptions;
+    cacheOptions.lipschitzBounds = true;
+    storm::storage::ParetoCache<ValueType> cache(cacheOptions);
+    cache.setErrorTolerance(this->parseNumber("0.01"));
+    cache.initializeParetoCurves(leaves);
+
+    // Choice 0 is optimal for the weight (1, 0) and reaches the exits with (0.3, 0.7)
+    storm::storage::Scheduler<ValueType> scheduler(3);
+    scheduler.setChoice(0, 0);
+    scheduler.setChoice(0, 1);
+    scheduler.setChoice(0, 2);
+    cache.addToCache(leaf.get(), {storm::utility::one<ValueType>(), storm::utility::zero<ValueType>()}, {}, scheduler);
+
+    // A close weight is answered from the inserted point, its optimum 0.3 + 0.7 * 0.001 lies between the bounds
+    std::vector<ValueType> closeWeight{storm::utility::one<ValueType>(), this->parseNumber("0.001")};
+    auto lower = cache.getLowerBound(leaf.get(), closeWeight);
+    auto upper = cache.getUpperBound(leaf.get(), closeWeight);
+    ASSERT_TRUE(lower && upper);
+    EXPECT_EQ(cache.getArithmeticStatistics().lipschitzUpperBounds, 1ul);
+    EXPECT_NEAR((*lower)[0], this->parseNumber("0.3007"), 1e-9);
+    EXPECT_GE((*upper)[0], this->parseNumber("0.3007"));
+    EXPECT_LT((*upper)[0] - (*lower)[0], this->parseNumber("0.01"));
+
+    // The bounds for a distant weight are too far apart, so the polytopes are used
+    cache.getUpperBound(leaf.get(), {storm::utility::zero<ValueType>(), storm::utility::one<ValueType>()});
+    EXPECT_EQ(cache.getArithmeticStatistics().lipschitzUpperBounds, 1ul);
+
+    const std::string path = STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json";
+    OpenMdpReachabilityTask task;
+    BenchmarkStats<ValueType> monolithicStats;
+    MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+    auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+    for (CacheMethod cacheMethod : {PARETO_CACHE, PARETO_VERTEX_CACHE}) {
+        typename CompositionalValueIteration<ValueType>::Options options;
+        options.useOvi = false;
+        options.useBottomUp = true;
+        options.cacheMethod = cacheMethod;
+        options.useLipschitzBounds = true;
+
+        BenchmarkStats<ValueType> stats;
+        CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+        auto result = cvi.check(task);
+
+        EXPECT_LT(result.getUpperBound() - result.getLowerBound(), options.epsilon) << cacheMethod;
+        EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-6) << cacheMethod;
+        EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-6) << cacheMethod;
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, ParetoCachePruningAndBudget) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    auto leaf = this->buildLeaf(this->parseNumber("0.3"));
+    std::vector<storm::models::ConcreteMdp<ValueType>*> leaves{leaf.get()};
+    ValueType zero = storm::utility::zero<ValueType>(), one = storm::utility::one<ValueType>();
+
+    // Inserts (0, 1) for the weight (0, 1) and (0.3, 0.7) for the weight (1, 0), the latter twice if requested
+    auto insertPoints = [&](storm::storage::ParetoCache<ValueType>& cache, bool duplicate) {
+        cache.initializeParetoCurves(leaves);
+        for (size_t i = 0; i < (duplicate ? 3 : 2); ++i) {
+            storm::storage::Scheduler<ValueType> scheduler(3);
+            scheduler.setChoice(i == 0 ? 1 : 0, 0);
+            scheduler.setChoice(0, 1);
+            scheduler.setChoice(0, 2);
+            cache.addToCache(leaf.get(), i == 0 ? std::vector<ValueType>{zero, one} : std::vector<ValueType>{one, zero}, {}, scheduler);
+        }
+    };
+
+    // The origin is dominated by (0, 1) and the duplicate by its original, the halfspace for (0, 1) does not cut the initial upper bound
+    storm::storage::ParetoCache<ValueType> prunedCache;
+    insertPoints(prunedCache, true);
+    auto prunedSet = prunedCache.exportParetoSet(leaf.get());
+    EXPECT_EQ(prunedSet.getPoints(0).size(), 2ul);
+    EXPECT_EQ(prunedSet.getHalfspaces(0).size(), 1ul);
+    EXPECT_EQ(prunedCache.getPruningStatistics().prunedPoints, 2ul);
+    EXPECT_EQ(prunedCache.getPruningStatistics().redundantHalfspaces, 2ul);
+
+    // With a budget of one, the origin and then (0, 1) are evicted, as is the halfspace with the larger gap to the remaining point
+    typename storm::storage::ParetoCache<ValueType>::Options budgetOptions;
+    budgetOptions.pruneBounds = false;
+    budgetOptions.entranceBudget = 1;
+    storm::storage::ParetoCache<ValueType> budgetCache(budgetOptions);
+    insertPoints(budgetCache, false);
+    auto budgetSet = budgetCache.exportParetoSet(leaf.get());
+    ASSERT_EQ(budgetSet.getPoints(0).size(), 1ul);
+    EXPECT_EQ(budgetSet.getPoints(0)[0], (std::vector<ValueType>{this->parseNumber("0.3"), this->parseNumber("0.7")}));
+    ASSERT_EQ(budgetSet.getHalfspaces(0).size(), 1ul);
+    EXPECT_EQ(budgetSet.getHalfspaces(0)[0].first, (std::vector<ValueType>{one, zero}));
+    EXPECT_EQ(budgetCache.getPruningStatistics().evictedPoints, 2ul);
+    EXPECT_EQ(budgetCache.getPruningStatistics().evictedHalfspaces, 1ul);
+
+    const std::string path = STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json";
+    OpenMdpReachabilityTask task;
+    BenchmarkStats<ValueType> monolithicStats;
+    MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+    auto monolithicResult = monolithicChecker.check(task).getLowerBound();
+
+    for (size_t budget : {0, 4}) {
+        typename CompositionalValueIteration<ValueType>::Options options;
+        options.useOvi = false;
+        options.useBottomUp = true;
+        options.pruneParetoBounds = budget > 0;
+        options.paretoEntranceBudget = budget;
+
+        BenchmarkStats<ValueType> stats;
+        CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+        auto result = cvi.check(task);
+
+        // The budget may keep the gap above epsilon, but evicting bounds must not make them unsound
+        if (budget == 0) {
+            EXPECT_EQ(stats.paretoPrunedPoints + stats.paretoRedundantHalfspaces, 0ul);
+            EXPECT_LT(result.getUpperBound() - result.getLowerBound(), options.epsilon);
+        }
+        EXPECT_LE(result.getLowerBound(), monolithicResult + 1e-6) << budget;
+        EXPECT_GE(result.getUpperBound(), monolithicResult - 1e-6) << budget;
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, IdenticalLeavesAreShared) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    OpenMdpReachabilityTask task;
+
+    // test2 with its two leaves taken from a copy of the program each, so they are different references with the same content
+    auto directory = this->createTemporaryDirectory();
+    std::filesystem::copy_file(STORM_TEST_RESOURCES_DIR "/compose/test2/c.prism", directory / "c.prism");
+    std::filesystem::copy_file(STORM_TEST_RESOURCES_DIR "/compose/test2/c.prism", directory / "d.prism");
+    std::string const ports = R"(">|": ["s=0"], "|<": ["s=1"], "<|": ["s=2"], "|>": ["s=3"])";
+    std::ofstream(directory / "sd.json") << R"({"root": "root", "components": {)"
+                                         << R"("root": {"type": "trace", "value": {"type": "sequence", "values": ["c", "d"]}, "left": 1},)"
+                                         << R"("c": {"type": "prism", "path": "c.prism", )" << ports << "},"
+                                         << R"("d": {"type": "prism", "path": "d.prism", )" << ports << "}}}";
+    const std::string path = (directory / "sd.json").string();
+
+    auto manager = this->buildPrism(path).manager;
+    manager->constructConcreteMdps();
+    EXPECT_EQ(manager->getSharedLeafCount(), 1ul);
+    EXPECT_EQ(manager->dereference("c"), manager->dereference("d"));
+
+    BenchmarkStats<ValueType> originalStats;
+    MonolithicOpenMdpChecker<ValueType> originalChecker(this->buildPrism(STORM_TEST_RESOURCES_DIR "/compose/test2/sd.json").manager, originalStats);
+    auto originalResult = originalChecker.check(task).getLowerBound();
+
+    BenchmarkStats<ValueType> monolithicStats;
+    MonolithicOpenMdpChecker<ValueType> monolithicChecker(this->buildPrism(path).manager, monolithicStats);
+    EXPECT_NEAR(monolithicChecker.check(task).getLowerBound(), originalResult, 1e-9);
+
+    typename CompositionalValueIteration<ValueType>::Options options;
+    options.useOvi = false;
+    options.useBottomUp = true;
+    BenchmarkStats<ValueType> stats;
+    CompositionalValueIteration<ValueType> cvi(this->buildPrism(path).manager, stats, options);
+    auto result = cvi.check(task);
+    EXPECT_LT(result.getUpperBound() - result.getLowerBound(), options.epsilon);
+    EXPECT_LE(result.getLowerBound(), originalResult + 1e-6);
+    EXPECT_GE(result.getUpperBound(), originalResult - 1e-6);
+
+    std::filesystem::remove_all(directory);
+}
+
+TYPED_TEST(BasicModelcheckingTest, ParallelLeafConstruction) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    const std::string path = STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json";
+    OpenMdpReachabilityTask task;
+
+    auto serialManager = this->buildPrism(path).manager;
+    serialManager->setBuildThreadCount(1);
+    serialManager->constructConcreteMdps();
+    auto parallelManager = this->buildPrism(path).manager;
+    parallelManager->setBuildThreadCount(4);
+    parallelManager->constructConcreteMdps();
+
+    for (std::string const& name : {"a", "b"}) {
+        auto serialLeaf = std::dynamic_pointer_cast<storm::models::ConcreteMdp<ValueType>>(serialManager->dereference(name));
+        auto parallelLeaf = std::dynamic_pointer_cast<storm::models::ConcreteMdp<ValueType>>(parallelManager->dereference(name));
+        ASSERT_TRUE(serialLeaf && parallelLeaf) << name;
+        EXPECT_EQ(parallelLeaf->getName(), name);
+        EXPECT_TRUE(parallelLeaf->getMdp()->getTransitionMatrix() == serialLeaf->getMdp()->getTransitionMatrix()) << name;
+        EXPECT_EQ(parallelLeaf->getLEntrance(), serialLeaf->getLEntrance()) << name;
+        EXPECT_EQ(parallelLeaf->getREntrance(), serialLeaf->getREntrance()) << name;
+        EXPECT_EQ(parallelLeaf->getLExit(), serialLeaf->getLExit()) << name;
+        EXPECT_EQ(parallelLeaf->getRExit(), serialLeaf->getRExit()) << name;
+    }
+
+    BenchmarkStats<ValueType> serialStats, parallelStats;
+    MonolithicOpenMdpChecker<ValueType> serialChecker(serialManager, serialStats);
+    MonolithicOpenMdpChecker<ValueType> parallelChecker(parallelManager, parallelStats);
+    EXPECT_EQ(parallelChecker.check(task).getLowerBound(), serialChecker.check(task).getLowerBound());
+}
+
+TYPED_TEST(BasicModelcheckingTest, ValueVectorIndexTables) {
+    typedef typename TestFixture::ValueType ValueType;
+    using storm::storage::Position;
+
+    for (std::string const& diagram : {"test1", "test2"}) {
+        auto manager = this->buildPrism(STORM_TEST_RESOURCES_DIR "/compose/" + diagram + "/sd.json").manager;
+        manager->constructConcreteMdps();
+        storm::models::visitor::MappingVisitor<ValueType> mappingVisitor;
+        manager->getRoot()->accept(mappingVisitor);
+        mappingVisitor.performPostProcessing();
+        auto mapping = mappingVisitor.getMapping();
+
+        // The index tables list the same indices as the map, L entrances and L exits first
+        std::vector<std::vector<size_t>> leafExits;
+        for (size_t leafId = 0; leafId < mapping.getLeafCount(); ++leafId) {
+            auto const* leaf = mapping.getLeaf(leafId);
+            std::vector<size_t> expectedEntrances, expectedExits;
+            for (size_t i = 0; i < leaf->getLEntrance().size(); ++i) {
+                expectedEntrances.push_back(mapping.lookup({leafId, Position{storm::storage::L_ENTRANCE, i}}));
+            }
+            for (size_t i = 0; i < leaf->getREntrance().size(); ++i) {
+                expectedEntrances.push_back(mapping.lookup({leafId, Position{storm::storage::R_ENTRANCE, i}}));
+            }
+            for (size_t i = 0; i < leaf->getLExit().size(); ++i) {
+                expectedExits.push_back(mapping.lookup({leafId, Position{storm::storage::L_EXIT, i}}));
+            }
+            for (size_t i = 0; i < leaf->getRExit().size(); ++i) {
+                expectedExits.push_back(mapping.lookup({leafId, Position{storm::storage::R_EXIT, i}}));
+            }
+            auto entranceIndices = mapping.getEntranceIndices(leafId);
+            auto exitIndices = mapping.getExitIndices(leafId);
+            EXPECT_EQ(std::vector<size_t>(entranceIndices.begin(), entranceIndices.end()), expectedEntrances) << diagram << " " << leafId;
+            EXPECT_EQ(std::vector<size_t>(exitIndices.begin(), exitIndices.end()), expectedExits) << diagram << " " << leafId;
+            leafExits.push_back(expectedExits);
+        }
+
+        // Values scattered into the entrances of the leaves are gathered from the same indices, and from the map indices at the exits of the
+        // connected leaves
+        storm::storage::ValueVector<ValueType> valueVector(mapping, std::vector<ValueType>(mapping.getOuterPositions().size()));
+        valueVector.initializeValues();
+        std::vector<ValueType> buffer;
+        for (size_t leafId = 0; leafId < mapping.getLeafCount(); ++leafId) {
+            std::vector<ValueType> weights;
+            for (size_t i = 0; i < mapping.getEntranceIndices(leafId).size(); ++i) {
+                weights.push_back(storm::utility::convertNumber<ValueType>(leafId * 10 + i + 1));
+            }
+            valueVector.setInputWeights(leafId, weights);
+            valueVector.getInputWeights(leafId, buffer);
+            EXPECT_EQ(buffer, weights) << diagram << " " << leafId;
+            EXPECT_EQ(valueVector.getInputWeights(leafId), weights) << diagram << " " << leafId;
+        }
+        for (size_t leafId = 0; leafId < mapping.getLeafCount(); ++leafId) {
+            std::vector<ValueType> expected;
+            for (auto index : leafExits[leafId]) {
+                expected.push_back(valueVector.getValues()[index]);
+            }
+            valueVector.getOutputWeights(leafId, buffer);
+            EXPECT_EQ(buffer, expected) << diagram << " " << leafId;
+            EXPECT_EQ(valueVector.getOutputWeights(leafId), expected) << diagram << " " << leafId;
+        }
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, FlatMdpLayout) {
+    typedef typename TestFixture::ValueType ValueType;
+    typedef storm::models::ConcreteMdp<ValueType> Leaf;
+
+    // Checks that the states of the leaf are copied to the offset, except that the given states move to their target with probability 1
+    auto expectLeafRows = [](Leaf const& flat, Leaf const& leaf, size_t offset, std::map<size_t, size_t> const& redirects) {
+        auto const& flatMatrix = flat.getMdp()->getTransitionMatrix();
+        auto const& leafMatrix = leaf.getMdp()->getTransitionMatrix();
+        for (size_t state = 0; state < leafMatrix.getRowGroupCount(); ++state) {
+            auto redirect = redirects.find(state);
+            if (redirect != redirects.end()) {
+                ASSERT_EQ(flatMatrix.getRowGroupSize(offset + state), 1ul) << state;
+                auto row = flatMatrix.getRow(offset + state, 0);
+                ASSERT_EQ(row.getNumberOfEntries(), 1ul) << state;
+                EXPECT_EQ(row.begin()->getColumn(), redirect->second) << state;
+                EXPECT_EQ(row.begin()->getValue(), storm::utility::one<ValueType>()) << state;
+                continue;
+            }
+            ASSERT_EQ(flatMatrix.getRowGroupSize(offset + state), leafMatrix.getRowGroupSize(state)) << state;
+            for (size_t action = 0; action < leafMatrix.getRowGroupSize(state); ++action) {
+                auto flatRow = flatMatrix.getRow(offset + state, action);
+                auto leafRow = leafMatrix.getRow(state, action);
+                ASSERT_EQ(flatRow.getNumberOfEntries(), leafRow.getNumberOfEntries()) << state;
+                auto flatEntry = flatRow.begin();
+                for (auto const& leafEntry : leafRow) {
+                    EXPECT_EQ(flatEntry->getColumn(), offset + leafEntry.getColumn()) << state;
+                    EXPECT_EQ(flatEntry->getValue(), leafEntry.getValue()) << state;
+                    ++flatEntry;
+                }
+            }
+        }
+    };
+    auto shift = [](std::vector<size_t> states, size_t offset) {
+        for (auto& state : states) {
+            state += offset;
+        }
+        return states;
+    };
+    auto buildFlat = [&](std::shared_ptr<storm::models::OpenMdpManager<ValueType>> const& manager) {
+        manager->constructConcreteMdps();
+        storm::models::visitor::FlatMdpBuilderVisitor<ValueType> visitor(manager);
+        manager->getRoot()->accept(visitor);
+        return visitor.getCurrent();
+    };
+
+    {
+        // Sequence: the right exits of a move to the left entrances of b
+        auto manager = this->buildPrism(STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json").manager;
+        auto flat = buildFlat(manager);
+        auto a = std::dynamic_pointer_cast<Leaf>(manager->dereference("a"));
+        auto b = std::dynamic_pointer_cast<Leaf>(manager->dereference("b"));
+        size_t offset = a->getMdp()->getNumberOfStates();
+        ASSERT_EQ(flat.getMdp()->getNumberOfStates(), offset + b->getMdp()->getNumberOfStates());
+        EXPECT_EQ(flat.getLEntrance(), a->getLEntrance());
+        EXPECT_EQ(flat.getRExit(), shift(b->getRExit(), offset));
+        EXPECT_TRUE(flat.getREntrance().empty() && flat.getLExit().empty());
+        EXPECT_TRUE(flat.getMdp()->getStateLabeling().getStateHasLabel("len0", a->getLEntrance()[0]));
+
+        std::map<size_t, size_t> redirects;
+        for (size_t i = 0; i < a->getRExit().size(); ++i) {
+            redirects[a->getRExit()[i]] = offset + b->getLEntrance()[i];
+        }
+        expectLeafRows(flat, *a, 0, redirects);
+        expectLeafRows(flat, *b, offset, {});
+    }
+
+    {
+        // Trace of c;c: inside the sequence the right exit of the first copy moves to the left entrance of the second and the left exit of the
+        // second to the right entrance of the first, the trace connects the left exit of the first copy to the right entrance of the second
+        auto manager = this->buildPrism(STORM_TEST_RESOURCES_DIR "/compose/test2/sd.json").manager;
+        auto flat = buildFlat(manager);
+        auto c = std::dynamic_pointer_cast<Leaf>(manager->dereference("c"));
+        size_t offset = c->getMdp()->getNumberOfStates();
+        ASSERT_EQ(flat.getMdp()->getNumberOfStates(), 2 * offset);
+        EXPECT_EQ(flat.getLEntrance(), c->getLEntrance());
+        EXPECT_EQ(flat.getRExit(), shift(c->getRExit(), offset));
+        EXPECT_TRUE(flat.getREntrance().empty() && flat.getLExit().empty());
+
+        expectLeafRows(flat, *c, 0, {{c->getRExit()[0], offset + c->getLEntrance()[0]}, {c->getLExit()[0], offset + c->getREntrance()[0]}});
+        expectLeafRows(flat, *c, offset, {{c->getLExit()[0], c->getREntrance()[0]}});
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, IncrementalShortcutUpdate) {
+    using namespace storm::modelchecker;
+    using namespace storm::compose::benchmark;
+
+    typedef typename TestFixture::ValueType ValueType;
+    typedef storm::models::ConcreteMdp<ValueType> Leaf;
+    OpenMdpReachabilityTask task;
+
+    auto manager = this->buildPrism(STORM_TEST_RESOURCES_DIR "/compose/test1/sd.json").manager;
+    manager->constructConcreteMdps();
+    auto root = manager->getRoot();
+    std::vector<Leaf*> leaves{std::dynamic_pointer_cast<Leaf>(manager->dereference("a")).get(),
+                              std::dynamic_pointer_cast<Leaf>(manager->dereference("b")).get()};
+    storm::storage::ParetoCache<ValueType> cache;
+    cache.initializeParetoCurves(leaves);
+
+    BenchmarkStats<ValueType> stats;
+    storm::models::visitor::BottomUpTermination<ValueType> incremental(manager, stats, this->env(), cache);
+    root->accept(incremental);
+    incremental.getReachabilityResult(task, *root);
+    EXPECT_EQ(stats.shortcutMdpUpdates, 2ul);
+
+    // After each insertion only the leaf that changed is regenerated, and the result equals the one of a visitor built from scratch
+    for (size_t leafId = 0; leafId < leaves.size(); ++leafId) {
+        storm::storage::Scheduler<ValueType> scheduler(leaves[leafId]->getMdp()->getNumberOfStates());
+        for (size_t state = 0; state < leaves[leafId]->getMdp()->getNumberOfStates(); ++state) {
+            scheduler.setChoice(0, state);
+        }
+        cache.addToCache(leaves[leafId], std::vector<ValueType>(leaves[leafId]->getExitCount(), storm::utility::one<ValueType>()), {}, scheduler);
+
+        root->accept(incremental);
+        auto incrementalResult = incremental.getReachabilityResult(task, *root);
+        EXPECT_EQ(stats.shortcutMdpUpdates, 3 + leafId);
+
+        BenchmarkStats<ValueType> rebuildStats;
+        storm::models::visitor::BottomUpTermination<ValueType> rebuild(manager, rebuildStats, this->env(), cache);
+        root->accept(rebuild);
+        auto rebuildResult = rebuild.getReachabilityResult(task, *root);
+        EXPECT_EQ(incrementalResult.getLowerBound(), rebuildResult.getLowerBound()) << leafId;
+        EXPECT_EQ(incrementalResult.getUpperBound(), rebuildResult.getUpperBound()) << leafId;
+    }
+}
+
+TYPED_TEST(BasicModelcheckingTest, PrismPortLookup) {
+    typedef typename TestFixture::ValueType ValueType;
+    typedef storm::models::PrismModel<ValueType> Prism;
+
+    // The initial state moves to x=1 & y=0 with probability 1/4 and to x=0 & y=1 with probability 3/4
+    auto directory = this->createTemporaryDirectory();
+    std::string const commands = "    [] x=0 & y=0 -> 0.25:(x'=1) + 0.75:(y'=1);\n    [] x=1 & y=0 -> true;\n    [] x=0 & y=1 -> true;\nendmodule\n";
+    std::ofstream(directory / "integer.prism") << "mdp\nmodule m\n    x : [0..1] init 0;\n    y : [0..1] init 0;\n" << commands;
+    std::ofstream(directory / "boolean.prism") << "mdp\nmodule m\n    x : [0..1] init 0;\n    b : bool init false;\n    y : [0..1] init 0;\n" << commands;
+    auto manager = std::make_shared<storm::models::OpenMdpManager<ValueType>>();
+
+    auto expectPorts = [](storm::models::ConcreteMdp<ValueType> const& leaf) {
+        ASSERT_EQ(leaf.getLEntrance().size(), 1ul);
+        ASSERT_EQ(leaf.getRExit().size(), 2ul);
+        auto const& matrix = leaf.getMdp()->getTransitionMatrix();
+        EXPECT_TRUE(leaf.getMdp()->getInitialStates().get(leaf.getLEntrance()[0]));
+        EXPECT_EQ(matrix.getRow(leaf.getLEntrance()[0], 0).getNumberOfEntries(), 2ul);
+        for (auto const& entry : matrix.getRow(leaf.getLEntrance()[0], 0)) {
+            EXPECT_EQ(entry.getValue(), storm::utility::convertNumber<ValueType>(entry.getColumn() == leaf.getRExit()[0] ? 0.25 : 0.75));
+        }
+        EXPECT_TRUE(leaf.getMdp()->getStateLabeling().getStateHasLabel("rex1", leaf.getRExit()[1]));
+    };
+
+    // Without Boolean variables the ports are resolved by variable name, so the order of the variables in them does not matter
+    std::string const integerPath = (directory / "integer.prism").string();
+    auto declarationOrder = Prism(manager, integerPath, {"x=0 & y=0"}, {}, {}, {"x=1 & y=0", "x=0 & y=1"}).toConcreteMdp();
+    auto otherOrder = Prism(manager, integerPath, {"y=0 & x=0"}, {}, {}, {"y=0 & x=1", "y=1 & x=0"}).toConcreteMdp();
+    expectPorts(declarationOrder);
+    expectPorts(otherOrder);
+    EXPECT_EQ(otherOrder.getLEntrance(), declarationOrder.getLEntrance());
+    EXPECT_EQ(otherOrder.getRExit(), declarationOrder.getRExit());
+    EXPECT_THROW(Prism(manager, integerPath, {"z=0"}, {}, {}, {}).toConcreteMdp(), storm::exceptions::InvalidOperationException);
+    EXPECT_THROW(Prism(manager, integerPath, {"x=1 & y=1"}, {}, {}, {}).toConcreteMdp(), storm::exceptions::InvalidOperationException);
+
+    // With a Boolean variable the ports are matched against the integer values of the state valuations in declaration order
+    auto withBoolean = Prism(manager, (directory / "boolean.prism").string(), {"x=0 & y=0"}, {}, {}, {"x=1 & y=0", "x=0 & y=1"}).toConcreteMdp();
+    expectPorts(withBoolean);
+
+    std::filesystem::remove_all(directory);
+}
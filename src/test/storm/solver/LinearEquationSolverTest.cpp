@@ -373,4 +373,45 @@ TYPED_TEST(LinearEquationSolverTest, solveEquationSystem) {
     EXPECT_NEAR(x[1], this->parseNumber("457/9"), this->precision());
     EXPECT_NEAR(x[2], this->parseNumber("875/18"), this->precision());
 }
-}  // namespace
\ No newline at end of file
+
+TYPED_TEST(LinearEquationSolverTest, solveEquationSystemBlock) {
+    typedef typename TestFixture::ValueType ValueType;
+    storm::storage::SparseMatrixBuilder<ValueType> builder;
+    ASSERT_NO_THROW(builder.addNextValue(0, 0, this->parseNumber("1/5")));
+    ASSERT_NO_THROW(builder.addNextValue(0, 1, this->parseNumber("2/5")));
+    ASSERT_NO_THROW(builder.addNextValue(0, 2, this->parseNumber("2/5")));
+    ASSERT_NO_THROW(builder.addNextValue(1, 0, this->parseNumber("1/50")));
+    ASSERT_NO_THROW(builder.addNextValue(1, 1, this->parseNumber("48/50")));
+    ASSERT_NO_THROW(builder.addNextValue(1, 2, this->parseNumber("1/50")));
+    ASSERT_NO_THROW(builder.addNextValue(2, 0, this->parseNumber("4/10")));
+    ASSERT_NO_THROW(builder.addNextValue(2, 1, this->parseNumber("3/10")));
+    ASSERT_NO_THROW(builder.addNextValue(2, 2, this->parseNumber("0")));
+
+    storm::storage::SparseMatrix<ValueType> A;
+    ASSERT_NO_THROW(A = builder.build());
+
+    // The second right-hand side is twice the first one, the two are stored interleaved
+    std::vector<ValueType> x(6);
+    std::vector<ValueType> b = {this->parseNumber("3"),     this->parseNumber("6"),  this->parseNumber("-0.01"),
+                                this->parseNumber("-0.02"), this->parseNumber("12"), this->parseNumber("24")};
+
+    auto factory = storm::solver::GeneralLinearEquationSolverFactory<ValueType>();
+    if (factory.getEquationProblemFormat(this->env()) == storm::solver::LinearEquationSolverProblemFormat::EquationSystem) {
+        A.convertToEquationSystem();
+    }
+
+    auto requirements = factory.getRequirements(this->env());
+    requirements.clearUpperBounds();
+    requirements.clearLowerBounds();
+    ASSERT_FALSE(requirements.hasEnabledRequirement());
+    auto solver = factory.create(this->env(), A);
+    solver->setBounds(this->parseNumber("-200"), this->parseNumber("200"));
+    ASSERT_NO_THROW(solver->solveEquationsBlock(this->env(), x, b, 2));
+    EXPECT_NEAR(x[0], this->parseNumber("481/9"), this->precision());
+    EXPECT_NEAR(x[1], this->parseNumber("962/9"), this->precision() * this->parseNumber("2"));
+    EXPECT_NEAR(x[2], this->parseNumber("457/9"), this->precision());
+    EXPECT_NEAR(x[3], this->parseNumber("914/9"), this->precision() * this->parseNumber("2"));
+    EXPECT_NEAR(x[4], this->parseNumber("875/18"), this->precision());
+    EXPECT_NEAR(x[5], this->parseNumber("875/9"), this->precision() * this->parseNumber("2"));
+}
+}  // namespace
@@ -78,6 +78,43 @@ TYPED_TEST(MultiplierTest, repeatedMultiplyTest) {
     EXPECT_NEAR(x[0], this->parseNumber("1"), this->precision());
 }
 
+TYPED_TEST(MultiplierTest, multiplyBlockTest) {
+    typedef typename TestFixture::ValueType ValueType;
+    storm::storage::SparseMatrixBuilder<ValueType> builder;
+    ASSERT_NO_THROW(builder.addNextValue(0, 0, this->parseNumber("0.5")));
+    ASSERT_NO_THROW(builder.addNextValue(0, 2, this->parseNumber("0.25")));
+    ASSERT_NO_THROW(builder.addNextValue(1, 1, this->parseNumber("1")));
+    ASSERT_NO_THROW(builder.addNextValue(2, 0, this->parseNumber("0.125")));
+    ASSERT_NO_THROW(builder.addNextValue(2, 1, this->parseNumber("0.5")));
+
+    storm::storage::SparseMatrix<ValueType> A;
+    ASSERT_NO_THROW(A = builder.build());
+
+    // Two interleaved vectors (1, 2, 4) and (8, 0, 1)
+    std::vector<ValueType> x = {this->parseNumber("1"), this->parseNumber("8"), this->parseNumber("2"),
+                                this->parseNumber("0"), this->parseNumber("4"), this->parseNumber("1")};
+    std::vector<ValueType> b = {this->parseNumber("0"), this->parseNumber("1"), this->parseNumber("0"),
+                                this->parseNumber("0"), this->parseNumber("0"), this->parseNumber("2")};
+
+    auto factory = storm::solver::MultiplierFactory<ValueType>();
+    auto multiplier = factory.create(this->env(), A);
+    std::vector<ValueType> result;
+    ASSERT_NO_THROW(multiplier->multiplyBlock(this->env(), x, &b, result, 2));
+    ASSERT_EQ(6ull, result.size());
+    EXPECT_NEAR(result[0], this->parseNumber("1.5"), this->precision());
+    EXPECT_NEAR(result[1], this->parseNumber("5.25"), this->precision());
+    EXPECT_NEAR(result[2], this->parseNumber("2"), this->precision());
+    EXPECT_NEAR(result[3], this->parseNumber("0"), this->precision());
+    EXPECT_NEAR(result[4], this->parseNumber("1.125"), this->precision());
+    EXPECT_NEAR(result[5], this->parseNumber("3"), this->precision());
+
+    // In place
+    ASSERT_NO_THROW(multiplier->multiplyBlock(this->env(), x, &b, x, 2));
+    for (uint64_t i = 0; i < x.size(); ++i) {
+        EXPECT_NEAR(x[i], result[i], this->precision());
+    }
+}
+
 TYPED_TEST(MultiplierTest, repeatedMultiplyAndReduceTest) {
     typedef typename TestFixture::ValueType ValueType;
 